@@ -9,6 +9,7 @@
  *
  */
 #include <Applications/animation.hpp>
+#include <Devices/Graphics/capture.hpp>
 #include <Devices/Graphics/graphics.hpp>
 
 namespace Apps {
@@ -28,7 +29,10 @@ void testAnimation()
         Graphics::putrect(x,10,10,10,0xFF0000);
         //apple
         Graphics::putrect(50,30,10,10,0xFFFF00);
-        Graphics::swap();
+        Graphics::flip();
+        // record every frame with --capture
+        if (Graphics::Capture::recording())
+            Graphics::Capture::frame();
     }
 }
 
@@ -0,0 +1,101 @@
+/**
+ * @file netbench.cpp
+ * @author Keeton Feavel (keeton@xyr.is)
+ * @brief Network driver throughput benchmark task
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @copyright Copyright the Xyris Contributors (c) 2026
+ *
+ */
+#include <Applications/netbench.hpp>
+#include <Arch/i686/timer.hpp> // TODO: Remove ASAP
+#include <Bootloader/Arguments.hpp>
+#include <Devices/Graphics/console.hpp>
+#include <Devices/Virtio/net.hpp>
+#include <Library/string.hpp>
+#include <Network/Ethernet.hpp>
+#include <Scheduler/tasks.hpp>
+#include <Logger.hpp>
+
+#define NET_BENCH_ETHERTYPE     0x88B5  // IEEE local experimental EtherType
+#define NET_BENCH_PAYLOAD_SIZE  46      // Minimum Ethernet payload
+#define NET_BENCH_BURST         32
+
+namespace Apps {
+
+static bool enabled = false;
+static uint64_t received = 0;
+
+static void receiveCallback(Network::PacketBuffer* packet)
+{
+    received++;
+    Network::releasePacket(packet);
+}
+
+static bool sendFrame(uint32_t sequence)
+{
+    Network::PacketBuffer* packet = Network::allocPacket();
+    if (!packet) {
+        return false;
+    }
+
+    uint8_t* payload = packet->put(NET_BENCH_PAYLOAD_SIZE);
+    memset(payload, 0, NET_BENCH_PAYLOAD_SIZE);
+    memcpy(payload, &sequence, sizeof(sequence));
+    return Network::Ethernet::send(packet, Network::Ethernet::broadcast, NET_BENCH_ETHERTYPE);
+}
+
+void net_bench(void)
+{
+    if (!enabled || !VirtioNet::isPresent()) {
+        return;
+    }
+
+    Network::Ethernet::registerProtocol(NET_BENCH_ETHERTYPE, receiveCallback);
+
+    struct VirtioNet::Statistics last, now;
+    VirtioNet::statistics(last);
+    uint64_t lastReceived = received;
+    uint32_t lastTick = timer_tick;
+    uint32_t sequence = 0;
+
+    while (true) {
+        for (size_t i = 0; i < NET_BENCH_BURST; i++) {
+            if (!sendFrame(sequence++)) {
+                break;
+            }
+        }
+        VirtioNet::transmitFlush();
+
+        if (timer_tick - lastTick >= 1000) {
+            VirtioNet::statistics(now);
+            uint64_t rx = received - lastReceived;
+            Console::printf(
+                "\e[s\e[22;0fNet: TX %llu pps, RX %llu pps, %llu kicks, %llu irqs, %llu polls\e[u",
+                now.txPackets - last.txPackets,
+                rx,
+                now.txKicks - last.txKicks,
+                now.interrupts - last.interrupts,
+                now.polls - last.polls);
+            Logger::Info(__func__, "TX %llu pps, RX %llu pps", now.txPackets - last.txPackets, rx);
+            last = now;
+            lastReceived = received;
+            lastTick = timer_tick;
+        }
+
+        // Give the poll task (and everybody else) a chance to run
+        tasks_schedule();
+    }
+}
+
+// Kernel argument callback
+static void argumentCallback(const char* arg)
+{
+    (void)arg;
+    enabled = true;
+}
+
+KERNEL_PARAM(netBenchArg, "--net-bench", argumentCallback);
+
+}
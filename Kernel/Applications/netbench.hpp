@@ -0,0 +1,24 @@
+/**
+ * @file netbench.hpp
+ * @author Keeton Feavel (keeton@xyr.is)
+ * @brief Network driver throughput benchmark task
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @copyright Copyright the Xyris Contributors (c) 2026
+ *
+ */
+#pragma once
+
+namespace Apps {
+
+/**
+ * @brief Floods the network with broadcast frames and displays the
+ * transmit and receive packet rates once a second. Only runs when the
+ * kernel is booted with `--net-bench` and a network device is present.
+ * With a loopback netdev every transmitted frame is received again.
+ *
+ */
+void net_bench(void);
+
+}
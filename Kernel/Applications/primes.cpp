@@ -2,50 +2,160 @@
  * @file primes.cpp
  * @author Micah Switzer (mswitzer@cedarville.edu)
  * @brief Prime computation tasks
- * @version 0.1
+ * @version 0.2
  * @date 2020-12-30
  *
  * @copyright Copyright the Xyris Contributors (c) 2021
  *
  */
 #include <stddef.h>
-#include <Library/Bitset.hpp>
+#include <stdint.h>
+#include <IPC/Channel.hpp>
+#include <Bootloader/Arguments.hpp>
+#include <Library/sieve.hpp>
+#include <Library/string.hpp>
 #include <Scheduler/tasks.hpp>
 #include <Applications/primes.hpp>
 #include <Devices/Graphics/console.hpp>
+#include <Support/gcov.hpp>
+#include <Logger.hpp>
 
 namespace Apps {
 
-// this value can be tweaked based on memory constraints
-#define PRIME_MAX_SQRT 4000
-#define PRIME_MAX (PRIME_MAX_SQRT * PRIME_MAX_SQRT)
-static Bitset<PRIME_MAX> map(1);
+// these can be changed with --primes-limit= and --primes-segment= (K, M and G suffixes work)
+#define PRIME_DEFAULT_LIMIT     16000000
+#define PRIME_DEFAULT_SEGMENT   (32 * 1024)         // Bytes, about the size of an L1 data cache
+#define PRIME_MIN_SEGMENT       1024
+#define PRIME_MAX_SEGMENT       (4 * 1024 * 1024)
+#define PRIME_MAX_LIMIT         UINT32_MAX          // Primes are handed over as 32 bit values
+#define PRIME_LARGEST_COUNT     8
 
-static size_t prime_current;
+struct PrimeStatus {
+    size_t percent;
+    bool done;
+    size_t count;
+    uint64_t elapsed;   // Nanoseconds
+};
+
+static IPC::Channel<struct PrimeStatus, 16> status_channel("primes");
+
+static uint64_t limit = PRIME_DEFAULT_LIMIT;
+static size_t segmentBytes = PRIME_DEFAULT_SEGMENT;
+
+static Sieve::Segmented sieve;
 
 void find_primes(void)
 {
-    for (prime_current = 2; prime_current < PRIME_MAX_SQRT; prime_current++) {
-        if (!map.Test(prime_current)) continue;
-        for (size_t j = prime_current * prime_current; j < PRIME_MAX; j += prime_current) {
-            map.Clear(j);
+    uint64_t start = tasks_get_time_ns();
+    uint32_t segmentBits = segmentBytes * 8;
+    auto bits = new uint32_t[segmentBits / 32];
+    if (bits == NULL) {
+        Logger::Warning(__func__, "Unable to allocate a %zu byte segment", segmentBytes);
+        status_channel.close();
+        return;
+    }
+
+    sieve.init(limit, bits, segmentBits);
+    size_t reported = 0;
+    while (sieve.next()) {
+        size_t pct = (size_t)(sieve.low() * 100 / limit);
+        if (pct != reported) {
+            // progress is only informational, so never wait on the display
+            reported = pct;
+            status_channel.trySend({ pct, false, 0, 0 });
+        }
+    }
+    size_t count = sieve.count();
+    uint64_t elapsed = tasks_get_time_ns() - start;
+
+    // hand the largest primes (from the last segment) over in a page of their own
+    IPC::Payload largest = IPC::allocate(PRIME_LARGEST_COUNT * sizeof(uint32_t));
+    if (largest.data) {
+        uint32_t* primes = (uint32_t*)largest.data;
+        memset(primes, 0, PRIME_LARGEST_COUNT * sizeof(uint32_t));
+        size_t found = 0;
+        for (uint32_t bit = sieve.size(); bit > 0 && found < PRIME_LARGEST_COUNT; bit--) {
+            if (sieve.isPrime(bit - 1)) {
+                primes[found++] = (uint32_t)(sieve.low() + 2 * (uint64_t)(bit - 1) + 1);
+            }
+        }
+        if (found < PRIME_LARGEST_COUNT && sieve.low() == 0 && limit > 2) {
+            primes[found] = 2;
         }
     }
+    delete[] bits;
+
+    if (!status_channel.send({ 100, true, count, elapsed }, largest)) {
+        IPC::release(largest);
+    }
+    status_channel.close();
 }
 
 void show_primes(void)
 {
-    do {
-        tasks_nano_sleep(1000ULL * 1000 * 1000);
-        size_t pct = (prime_current * 100) / PRIME_MAX_SQRT;
-        Console::printf("\e[s\e[23;0fComputing primes: %%%zu\e[u", pct);
-    } while (prime_current < PRIME_MAX_SQRT);
-
-    size_t count = 0;
-    for (size_t i = 2; i < PRIME_MAX; i++) {
-        count += map.Test(i);
+    struct PrimeStatus status;
+    IPC::Payload largest;
+    while (status_channel.receive(&status, &largest)) {
+        if (!status.done) {
+            Console::printf("\e[s\e[23;0fComputing primes: %%%zu\e[u", status.percent);
+            continue;
+        }
+
+        uint64_t rate = status.elapsed ? status.count * 1000000000ULL / status.elapsed : 0;
+        if (largest.data) {
+            Console::printf("\e[s\e[23;0fFound %zu primes below %llu in %llu ms (%llu/s, %zu KiB segments, largest %lu).\e[u",
+                status.count, limit, status.elapsed / 1000000, rate, segmentBytes / 1024, ((uint32_t*)largest.data)[0]);
+            IPC::release(largest);
+        } else {
+            Console::printf("\e[s\e[23;0fFound %zu primes below %llu in %llu ms (%llu/s, %zu KiB segments).\e[u",
+                status.count, limit, status.elapsed / 1000000, rate, segmentBytes / 1024);
+        }
+        Logger::Info(__func__, "%zu primes below %llu in %llu ns, %llu primes/s", status.count, limit, status.elapsed, rate);
+#if defined(GCOV)
+        // the benchmark is the training run for profile guided builds
+        Gcov::dump();
+#endif
     }
-    Console::printf("\e[s\e[23;0fFound %zu primes between 2 and %u.\e[u", count, PRIME_MAX);
 }
 
+// Kernel argument callbacks
+static uint64_t parseSize(const char* arg)
+{
+    uint64_t value = 0;
+    for (; *arg >= '0' && *arg <= '9'; arg++) {
+        value = value * 10 + (uint64_t)(*arg - '0');
+    }
+
+    switch (*arg) {
+        case 'G':
+        case 'g':
+            return value * 1024 * 1024 * 1024;
+        case 'M':
+        case 'm':
+            return value * 1024 * 1024;
+        case 'K':
+        case 'k':
+            return value * 1024;
+        default:
+            return value;
+    }
+}
+
+static void limitArgumentCallback(const char* arg)
+{
+    uint64_t value = parseSize(arg);
+    limit = value < 3 ? 3 : (value > PRIME_MAX_LIMIT ? PRIME_MAX_LIMIT : value);
+}
+
+static void segmentArgumentCallback(const char* arg)
+{
+    size_t value = (size_t)parseSize(arg);
+    value = value < PRIME_MIN_SEGMENT ? PRIME_MIN_SEGMENT : (value > PRIME_MAX_SEGMENT ? PRIME_MAX_SEGMENT : value);
+    // whole words, so the sieve never has to deal with a partial one in the middle
+    segmentBytes = value & ~(sizeof(uint32_t) - 1);
+}
+
+KERNEL_PARAM(primesLimitArg, "--primes-limit=", limitArgumentCallback);
+KERNEL_PARAM(primesSegmentArg, "--primes-segment=", segmentArgumentCallback);
+
 }
@@ -13,13 +13,16 @@
 namespace Apps {
 
 /**
- * @brief Starts a task to find prime numbers.
+ * @brief Starts a task to find prime numbers. Uses an odds-only segmented
+ * sieve, which doubles as a CPU and memory benchmark. The limit and the
+ * segment size (in bytes, sized for the L1 or L2 cache) are set with the
+ * `--primes-limit=` and `--primes-segment=` kernel arguments.
  *
  */
 void find_primes(void);
 /**
  * @brief Starts a task to display number of primes
- * found by find_primes.
+ * found by find_primes and how many were found per second.
  *
  */
 void show_primes(void);
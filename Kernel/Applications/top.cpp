@@ -0,0 +1,159 @@
+/**
+ * @file top.cpp
+ * @author Keeton Feavel (keeton@xyr.is)
+ * @brief Live per-task resource usage table
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @copyright Copyright the Xyris Contributors (c) 2026
+ *
+ */
+#include <Applications/top.hpp>
+#include <Bootloader/Arguments.hpp>
+#include <Devices/Graphics/console.hpp>
+#include <Library/string.hpp>
+#include <Scheduler/tasks.hpp>
+
+#define TOP_INTERVAL_NS     1000000000ULL
+#define TOP_MAX_TASKS       32
+#define TOP_FIRST_ROW       12  // The table sits right above the status lines
+#define TOP_ROWS            8
+
+namespace Apps {
+
+static bool enabled = false;
+
+static struct task_stats previous[TOP_MAX_TASKS];
+static struct task_stats current[TOP_MAX_TASKS];
+static size_t previousCount = 0;
+
+struct Usage {
+    const struct task_stats* stats;
+    uint64_t runNs;
+    uint64_t irqNs;
+    uint64_t switches;
+};
+
+static char stateLetter(task_state state)
+{
+    switch (state) {
+        case TASK_RUNNING:
+            return 'R';
+        case TASK_READY:
+            return 'r';
+        case TASK_SLEEPING:
+            return 'S';
+        case TASK_BLOCKED:
+            return 'B';
+        case TASK_STOPPED:
+            return 'X';
+        case TASK_PAUSED:
+            return 'P';
+        default:
+            return '?';
+    }
+}
+
+static const struct task_stats* findPrevious(uint32_t id)
+{
+    for (size_t idx = 0; idx < previousCount; idx++) {
+        if (previous[idx].id == id) {
+            return &previous[idx];
+        }
+    }
+
+    return NULL;
+}
+
+// Percentage with one decimal, as tenths
+static uint64_t tenthsOf(uint64_t part, uint64_t whole)
+{
+    return whole ? part * 1000 / whole : 0;
+}
+
+static void draw(struct Usage* usage, size_t count, uint64_t elapsedNs)
+{
+    // a handful of tasks, so a simple insertion sort by total CPU time does
+    for (size_t idx = 1; idx < count; idx++) {
+        struct Usage entry = usage[idx];
+        size_t pos = idx;
+        while (pos > 0 && usage[pos - 1].runNs + usage[pos - 1].irqNs < entry.runNs + entry.irqNs) {
+            usage[pos] = usage[pos - 1];
+            pos--;
+        }
+        usage[pos] = entry;
+    }
+
+    Console::printf("\e[s\e[%d;0f%4s %-15s %c %6s %6s %7s %9s %5s %6s %5s\e[u",
+        TOP_FIRST_ROW, "ID", "TASK", 'S', "CPU%", "IRQ%", "CSW/s", "HEAP", "PAGES", "FAULTS", "STACK");
+    for (size_t row = 0; row < TOP_ROWS; row++) {
+        if (row >= count) {
+            // clear rows left over from tasks that have exited
+            Console::printf("\e[s\e[%d;0f%73s\e[u", TOP_FIRST_ROW + 1 + (int)row, "");
+            continue;
+        }
+
+        const struct Usage& entry = usage[row];
+        uint64_t cpu = tenthsOf(entry.runNs, elapsedNs);
+        uint64_t irq = tenthsOf(entry.irqNs, elapsedNs);
+        Console::printf("\e[s\e[%d;0f%4lu %-15s %c %4llu.%llu %4llu.%llu %7llu %9lld %5lld %6llu %5zu\e[u",
+            TOP_FIRST_ROW + 1 + (int)row,
+            entry.stats->id,
+            entry.stats->name,
+            stateLetter(entry.stats->state),
+            cpu / 10, cpu % 10,
+            irq / 10, irq % 10,
+            entry.switches * TOP_INTERVAL_NS / elapsedNs,
+            entry.stats->heap_bytes,
+            entry.stats->pages,
+            entry.stats->page_faults,
+            entry.stats->stack_used);
+    }
+}
+
+void top(void)
+{
+    if (!enabled) {
+        return;
+    }
+
+    static struct Usage usage[TOP_MAX_TASKS];
+    uint64_t last = tasks_get_time_ns();
+    previousCount = tasks_snapshot(previous, TOP_MAX_TASKS);
+    uint64_t deadline = last;
+
+    while (true) {
+        deadline += TOP_INTERVAL_NS;
+        tasks_nano_sleep_until(deadline);
+
+        size_t count = tasks_snapshot(current, TOP_MAX_TASKS);
+        uint64_t now = tasks_get_time_ns();
+        uint64_t elapsed = now - last;
+        for (size_t idx = 0; idx < count; idx++) {
+            // tasks created since the last refresh count from zero
+            const struct task_stats* before = findPrevious(current[idx].id);
+            usage[idx] = {
+                .stats = &current[idx],
+                .runNs = current[idx].run_ns - (before ? before->run_ns : 0),
+                .irqNs = current[idx].irq_ns - (before ? before->irq_ns : 0),
+                .switches = current[idx].context_switches - (before ? before->context_switches : 0),
+            };
+        }
+        draw(usage, count, elapsed);
+
+        memcpy(previous, current, sizeof(current));
+        previousCount = count;
+        last = now;
+    }
+}
+
+// Kernel argument callback
+static void argumentCallback(const char* arg)
+{
+    (void)arg;
+    enabled = true;
+}
+
+KERNEL_PARAM(topArg, "--top", argumentCallback);
+
+}
@@ -0,0 +1,25 @@
+/**
+ * @file top.hpp
+ * @author Keeton Feavel (keeton@xyr.is)
+ * @brief Live per-task resource usage table
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @copyright Copyright the Xyris Contributors (c) 2026
+ *
+ */
+#pragma once
+
+namespace Apps {
+
+/**
+ * @brief Draws a table of the busiest tasks above the status lines once a
+ * second, sorted by CPU usage. Shows each task's share of the CPU (split
+ * into running and interrupt handlers), context switches per second, heap
+ * bytes, pages, page faults and stack high water mark. Only runs when the
+ * kernel is booted with `--top`.
+ *
+ */
+void top(void);
+
+}
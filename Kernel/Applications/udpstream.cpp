@@ -0,0 +1,97 @@
+/**
+ * @file udpstream.cpp
+ * @author Keeton Feavel (keeton@xyr.is)
+ * @brief UDP streaming throughput task
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @copyright Copyright the Xyris Contributors (c) 2026
+ *
+ */
+#include <Applications/udpstream.hpp>
+#include <Arch/i686/timer.hpp> // TODO: Remove ASAP
+#include <Bootloader/Arguments.hpp>
+#include <Devices/Graphics/console.hpp>
+#include <Devices/Virtio/net.hpp>
+#include <Network/Ethernet.hpp>
+#include <Network/UDP.hpp>
+#include <Scheduler/tasks.hpp>
+#include <Logger.hpp>
+
+#define UDP_STREAM_ADDRESS  NET_IPV4(10, 0, 2, 2)   // QEMU user networking host
+#define UDP_STREAM_PORT     5556
+#define UDP_STREAM_BURST    32
+
+namespace Apps {
+
+static bool enabled = false;
+static uint8_t pattern[UDP_MAX_PAYLOAD];
+
+static bool sendDatagram(Network::UDP::Socket& socket, uint32_t sequence)
+{
+    Network::PacketBuffer* packet = socket.allocate();
+    if (!packet) {
+        return false;
+    }
+
+    uint32_t header = Network::hostToNetwork32(sequence);
+    socket.append(packet, &header, sizeof(header));
+    socket.append(packet, pattern, UDP_MAX_PAYLOAD - sizeof(header));
+    return socket.send(packet);
+}
+
+void udp_stream(void)
+{
+    if (!enabled || !VirtioNet::isPresent()) {
+        return;
+    }
+
+    for (size_t i = 0; i < UDP_MAX_PAYLOAD; i++) {
+        pattern[i] = (uint8_t)i;
+    }
+
+    Network::UDP::Socket socket;
+    if (!socket.connect(UDP_STREAM_ADDRESS, UDP_STREAM_PORT)) {
+        Logger::Warning(__func__, "Unable to open UDP socket");
+        return;
+    }
+
+    uint32_t sequence = 0;
+    uint32_t lastSequence = 0;
+    uint32_t lastTick = timer_tick;
+
+    while (true) {
+        for (size_t i = 0; i < UDP_STREAM_BURST; i++) {
+            // Out of buffers, wait for the device to complete some transmits
+            if (!sendDatagram(socket, sequence)) {
+                break;
+            }
+            sequence++;
+        }
+        Network::Ethernet::flush();
+
+        uint32_t elapsed = timer_tick - lastTick;
+        if (elapsed >= 1000) {
+            uint64_t datagrams = sequence - lastSequence;
+            uint64_t rate = datagrams * UDP_MAX_PAYLOAD * 1000 / elapsed / 1024;
+            Console::printf("\e[s\e[21;0fUDP: %llu datagrams/s, %llu KiB/s\e[u", datagrams, rate);
+            Logger::Info(__func__, "%llu datagrams/s, %llu KiB/s", datagrams, rate);
+            lastSequence = sequence;
+            lastTick = timer_tick;
+        }
+
+        // Give the poll task (and everybody else) a chance to run
+        tasks_schedule();
+    }
+}
+
+// Kernel argument callback
+static void argumentCallback(const char* arg)
+{
+    (void)arg;
+    enabled = true;
+}
+
+KERNEL_PARAM(udpStreamArg, "--udp-stream", argumentCallback);
+
+}
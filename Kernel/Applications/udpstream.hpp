@@ -0,0 +1,24 @@
+/**
+ * @file udpstream.hpp
+ * @author Keeton Feavel (keeton@xyr.is)
+ * @brief UDP streaming throughput task
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @copyright Copyright the Xyris Contributors (c) 2026
+ *
+ */
+#pragma once
+
+namespace Apps {
+
+/**
+ * @brief Streams sequence numbered UDP datagrams to the host (10.0.2.2:5556
+ * under QEMU user networking) and displays the throughput once a second.
+ * Only runs when the kernel is booted with `--udp-stream`. Run
+ * `Meta/udp-receiver.py` on the host to receive the stream.
+ *
+ */
+void udp_stream(void);
+
+}
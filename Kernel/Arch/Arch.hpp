@@ -75,6 +75,11 @@ void init();
 // Architecture common CPU controls
 void interruptsDisable();
 void interruptsEnable();
+bool interruptsEnabled();
+// Stack to switch to when user mode code is interrupted
+void setKernelStack(uintptr_t top);
+// Drop to user mode at entry with the given user stack
+[[noreturn]] void enterUserMode(uintptr_t entry, uintptr_t stack);
 // TODO: Add interruptsRegisterCallback(uint32_t id, func* cb)
 
 // Critical region lambda function
@@ -86,6 +91,20 @@ void criticalRegion(Function critWork)
     interruptsEnable();
 }
 
+// Critical region lambda function that restores the previous interrupt
+// state instead of unconditionally enabling interrupts. Safe to use from
+// interrupt handlers and from within other critical regions.
+template<typename Function>
+void criticalRegionNestable(Function critWork)
+{
+    bool enabled = interruptsEnabled();
+    interruptsDisable();
+    critWork();
+    if (enabled) {
+        interruptsEnable();
+    }
+}
+
 // CPU Identification
 const char* vendor();
 const char* model();
@@ -16,6 +16,7 @@
 #include <Arch/i686/isr.hpp>
 #include <Arch/i686/ports.hpp>
 #include <Arch/i686/timer.hpp>
+#include <Arch/i686/tss.hpp>
 #include <cpuid.h>
 #include <stddef.h>
 #include <stdint.h>
@@ -111,8 +112,10 @@ void init()
 {
     criticalRegion([]() {
         GDT::init();        // Initialize the Global Descriptor Table
+        PerCPU::init(0);    // Point %gs at the boot CPU's per-CPU data
+        TSS::init();        // Ring 0 stack for interrupts from user mode
         Interrupts::init(); // Initialize Interrupt Service Requests
-        timer_init(1000);   // Programmable Interrupt Timer (1ms)
+        timer_init(TIMER_FREQUENCY); // Programmable Interrupt Timer (1ms)
     });
 }
 
@@ -124,6 +127,39 @@ void interruptsEnable() {
     asm volatile("sti");
 }
 
+void setKernelStack(uintptr_t top) {
+    TSS::setKernelStack(top);
+}
+
+void enterUserMode(uintptr_t entry, uintptr_t stack) {
+    uint32_t data = GDT_USER_SELECTOR(GDT_USER_DATA_INDEX);
+    uint32_t code = GDT_USER_SELECTOR(GDT_USER_CODE_INDEX);
+    // %gs stops pointing at the per-CPU data here, so nothing may interrupt
+    // until iret has left ring 0. The pushed EFLAGS turn interrupts back on.
+    asm volatile(
+        "cli\n\t"
+        "mov %w0, %%ds\n\t"
+        "mov %w0, %%es\n\t"
+        "mov %w0, %%fs\n\t"
+        "mov %w0, %%gs\n\t"
+        "push %0\n\t"         // SS
+        "push %1\n\t"         // ESP
+        "push $0x202\n\t"     // EFLAGS (IF set)
+        "push %2\n\t"         // CS
+        "push %3\n\t"         // EIP
+        "iret"
+        :
+        : "r"(data), "r"(stack), "r"(code), "r"(entry)
+        : "memory");
+    __builtin_unreachable();
+}
+
+bool interruptsEnabled() {
+    size_t flags;
+    asm volatile("pushf\n\tpop %0" : "=r"(flags));
+    return flags & (1 << 9);
+}
+
 const char* vendor()
 {
     static int vendor[4];
@@ -12,6 +12,7 @@
 #include <Arch/i686/regs.hpp>
 #include <Arch/i686/ports.hpp>
 #include <Arch/i686/isr.hpp>
+#include <Arch/i686/percpu.hpp>
 
 namespace Arch {
 
@@ -66,6 +66,7 @@ void interrupt12();
 void interrupt13();
 void interrupt14();
 void interrupt15();
+void syscallEntry();
 
 /**
  * @brief CPU exception handler. Must be available for each exception
@@ -3,6 +3,11 @@ extern exceptionHandler
 extern interruptHandler
 align 4
 
+; GDT_SELECTOR(GDT_PERCPU_INDEX), the boot CPU's per-CPU segment (see percpu.cpp)
+%define PERCPU_SELECTOR 0x30
+; Offset of the interrupted CS once the data segment has been pushed
+%define SAVED_CS 48
+
 ; Common ISR code
 exception_stub:
     ; 1. Save CPU state
@@ -13,7 +18,13 @@ exception_stub:
     mov ds, ax
     mov es, ax
     mov fs, ax
+    ; gs always holds this CPU's per-CPU segment in the kernel, but user
+    ; mode has its own, so switch over when coming from ring 3
+    test dword [esp+SAVED_CS], 3
+    jz .from_kernel
+    mov ax, PERCPU_SELECTOR
     mov gs, ax
+.from_kernel:
     push esp            ; Push struct registers *r
     ; 2. Clear the direction flag (eflags) & call C handler
     cld                 ; C code following the sysV ABI requires DF to be clear on function entry
@@ -25,7 +36,11 @@ exception_stub:
     mov ds, ax
     mov es, ax
     mov fs, ax
+    ; user mode gets the user data segment back in gs as well
+    test dword [esp+SAVED_CS-4], 3
+    jz .to_kernel
     mov gs, ax
+.to_kernel:
     popad
     add esp, 8          ; Cleans up the pushed error code and pushed ISR number
     iret                ; pops 5 things at once: CS, EIP, EFLAGS, SS, and ESP
@@ -41,7 +56,11 @@ interrupt_stub:
     mov ds, ax
     mov es, ax
     mov fs, ax
+    test dword [esp+SAVED_CS], 3
+    jz .from_kernel
+    mov ax, PERCPU_SELECTOR
     mov gs, ax
+.from_kernel:
     push esp
     cld
     call interruptHandler ; Different than the ISR code
@@ -50,12 +69,23 @@ interrupt_stub:
     mov ds, bx
     mov es, bx
     mov fs, bx
+    test dword [esp+SAVED_CS-4], 3
+    jz .to_kernel
     mov gs, bx
+.to_kernel:
     popad
     add esp, 8
     iret
     ; These irets need to be iretq's when in long mode
 
+; System calls (int 0x80) from user mode. They go through the exception
+; path since there is no PIC to acknowledge.
+global syscallEntry
+syscallEntry:
+    push 0
+    push 0x80
+    jmp exception_stub
+
 ; Macro expansions for isr and irq
 
 %macro m_exception_err 1
@@ -9,9 +9,12 @@ endstruc
 %define TASK_RUNNING 0
 %define TASK_READY   1
 
+; offsetof(struct percpu, current_task), see Arch/i686/percpu.hpp
+%define PERCPU_CURRENT_TASK 8
+
 bits    32
 section .text
-extern  current_task:data, tasks_ready_tail:data
+extern  tasks_ready_tail:data
 extern  _tasks_enqueue_ready:function
 global  tasks_switch_to:function
 tasks_switch_to:
@@ -21,12 +24,13 @@ tasks_switch_to:
     ;  EIP is already saved on the stack by the caller's "CALL" instruction
     ;  The task isn't able to change CR3 so it doesn't need to be saved
     ;  Segment registers are constants (while running kernel code) so they don't need to be saved
+    ;  The running task lives in this CPU's per-CPU block, addressed through GS
     push ebx
     push esi
     push edi
     push ebp
 
-    mov edi,[current_task]        ;edi = address of the previous task's "thread control block"
+    mov edi,[gs:PERCPU_CURRENT_TASK] ;edi = address of the previous task's "thread control block"
     mov [edi+task.stack],esp      ;Save ESP for previous task's kernel stack in the thread's TCB
     cmp dword [edi+task.state],TASK_RUNNING
     jne .state_updated
@@ -37,7 +41,7 @@ tasks_switch_to:
  .state_updated:
     ;Load next task's state
     mov esi,[esp+(4+1)*4]         ;esi = address of the next task's "thread control block" (parameter passed on stack)
-    mov [current_task],esi        ;Current task's TCB is the next task TCB
+    mov [gs:PERCPU_CURRENT_TASK],esi ;Current task's TCB is the next task TCB
 
     mov esp,[esi+task.stack]      ;Load ESP for next task's kernel stack from the thread's TCB
 
@@ -12,11 +12,9 @@
 #include <Arch/i686/Assembly/Flush.h>
 #include <Library/string.hpp>
 
-#define ARCH_GDT_MAX_ENTRIES 5
-
 namespace GDT {
 
-struct Entry gdt[ARCH_GDT_MAX_ENTRIES];
+struct Entry gdt[GDT_MAX_ENTRIES];
 struct Registers::GDTR gdtr;
 
 void init()
@@ -122,6 +120,30 @@ void init()
         .base_high = userDataBase.section.high,
     };
 
+    // The TSS descriptor is left empty until a TSS is installed. Per-CPU
+    // segments are byte granular so the limit covers exactly one block.
+    for (uint32_t cpu = 0; cpu < PERCPU_MAX_CPUS; cpu++) {
+        const union Base perCpuBase = { .value = (uint32_t)PerCPU::block(cpu) };
+        const union Limit perCpuLimit = { .value = sizeof(struct percpu) - 1 };
+        gdt[GDT_PERCPU_INDEX + cpu] = {
+            .limit_low = perCpuLimit.section.low,
+            .base_low = perCpuBase.section.low,
+            .accessed = 0,
+            .rw = 1,
+            .dc = 0,
+            .executable = 0,
+            .system = 1,
+            .privilege = 0,
+            .present = 1,
+            .limit_high = perCpuLimit.section.high,
+            .reserved = 0,
+            .longMode = 0,
+            .size = 1,
+            .granulatity = 0,
+            .base_high = perCpuBase.section.high,
+        };
+    }
+
     // Update GDT register and flush
     gdtr.size = sizeof(gdt) - 1;
     gdtr.base = (uint32_t)&gdt;
@@ -129,4 +151,28 @@ void init()
     gdt_flush((uint32_t)&gdtr);
 }
 
+void installTSS(uintptr_t base, uint32_t limit)
+{
+    // A system descriptor with type 0x9 (available 32-bit TSS)
+    const union Base tssBase = { .value = base };
+    const union Limit tssLimit = { .value = limit };
+    gdt[GDT_TSS_INDEX] = {
+        .limit_low = tssLimit.section.low,
+        .base_low = tssBase.section.low,
+        .accessed = 1,
+        .rw = 0,
+        .dc = 0,
+        .executable = 1,
+        .system = 0,
+        .privilege = 0,
+        .present = 1,
+        .limit_high = tssLimit.section.high,
+        .reserved = 0,
+        .longMode = 0,
+        .size = 0,
+        .granulatity = 0,
+        .base_high = tssBase.section.high,
+    };
+}
+
 } // !namespace GDT
@@ -12,6 +12,17 @@
 #pragma once
 #include <stdint.h>
 #include <Arch/i686/Arch.hpp>
+#include <Arch/i686/percpu.hpp>
+
+#define GDT_KERNEL_CODE_INDEX   1
+#define GDT_KERNEL_DATA_INDEX   2
+#define GDT_USER_CODE_INDEX     3
+#define GDT_USER_DATA_INDEX     4
+#define GDT_TSS_INDEX       5   // Reserved for the TSS (see tss_flush)
+#define GDT_PERCPU_INDEX    6   // First per-CPU data segment, one per CPU
+#define GDT_MAX_ENTRIES     (GDT_PERCPU_INDEX + PERCPU_MAX_CPUS)
+#define GDT_SELECTOR(idx)   ((uint16_t)((idx) << 3))
+#define GDT_USER_SELECTOR(idx) (GDT_SELECTOR(idx) | 3)    // Requested privilege level 3
 
 namespace GDT {
 
@@ -69,4 +80,12 @@ static_assert(sizeof(struct Entry) == 8);
  */
 void init();
 
+/**
+ * @brief Fill in the TSS descriptor. The TSS still has to be loaded with `tss_flush()`.
+ *
+ * @param base Linear address of the TSS
+ * @param limit Size of the TSS minus one
+ */
+void installTSS(uintptr_t base, uint32_t limit);
+
 } // !namespace GDT
@@ -18,7 +18,7 @@ namespace IDT {
 struct Gate idt[ARCH_IDT_MAX_ENTRIES];
 struct Registers::IDTR idtr;
 
-void setGate(int n, uint32_t handler_addr)
+void setGate(int n, uint32_t handler_addr, uint8_t privilege)
 {
     struct Gate* gate = &idt[n];
     union Offset offset = { .value = handler_addr };
@@ -32,7 +32,7 @@ void setGate(int n, uint32_t handler_addr)
     gate->flags = {
         .type = INTERRUPT_GATE_32_BIT,
         .offset = 0,
-        .privilege = 0,
+        .privilege = privilege,
         .present = 1,
     };
     gate->offset_high = offset.section.high;
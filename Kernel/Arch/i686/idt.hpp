@@ -60,8 +60,9 @@ static_assert(sizeof(struct Gate) == 8);
  *
  * @param n IDT index
  * @param handler Handler address
+ * @param privilege Least privileged ring allowed to raise it with `INT`
  */
-void setGate(int n, uint32_t handler);
+void setGate(int n, uint32_t handler, uint8_t privilege = 0);
 
 /**
  * @brief Calls the lidt instruction and installs the IDT onto the CPU.
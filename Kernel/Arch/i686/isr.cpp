@@ -12,13 +12,21 @@
 #include <Arch/i686/idt.hpp>
 #include <Arch/i686/isr.hpp>
 #include <Arch/i686/Assembly/Interrupts.h>
+#include <Metrics.hpp>
 #include <Panic.hpp>
+#include <Scheduler/rcu.hpp>
+#include <Scheduler/tasks.hpp>
+#include <x86gprintrin.h>   // needed for __rdtsc
 
 namespace Interrupts {
 
-// Interrupt handler function pointers
+// Interrupt handler function pointers. Published with RCU so that handlers
+// can be swapped or removed while interrupts are enabled.
 InterruptHandler_t interruptHandlers[256];
 
+METRIC_COUNTER(irqCount, "irq.count", "interrupts");
+METRIC_HISTOGRAM(irqHandlerCycles, "irq.handler_cycles", "cycles");
+
 extern "C" {
 
 /**
@@ -28,6 +36,14 @@ extern "C" {
  */
 void exceptionHandler(struct registers* regs)
 {
+    // exceptions that can be recovered from (e.g. page faults in user
+    // processes) and system calls have handlers, everything else is fatal
+    InterruptHandler_t handler = rcu_dereference(interruptHandlers[regs->int_num]);
+    if (handler) {
+        handler(regs);
+        return;
+    }
+
     panic(regs);
 }
 
@@ -47,10 +63,16 @@ void interruptHandler(struct registers* regs)
     // Respond to primary PIC
     writeByte(0x20, 0x20);
 
-    if (interruptHandlers[regs->int_num]) {
-        InterruptHandler_t handler = interruptHandlers[regs->int_num];
+    // interrupts are disabled, so this is already an RCU read-side section
+    InterruptHandler_t handler = rcu_dereference(interruptHandlers[regs->int_num]);
+    if (handler) {
+        struct task* task = tasks_irq_enter();
+        uint64_t start = __rdtsc();
         handler(regs);
+        Metrics::record(irqHandlerCycles, __rdtsc() - start);
+        tasks_irq_exit(task);
     }
+    Metrics::inc(irqCount);
 }
 
 } // !extern "C"
@@ -91,13 +113,27 @@ void init()
         IDT::setGate(32 + interrupt, (uint32_t)interruptHandlerStubs[interrupt]);
     }
 
+    // The only gate user mode may raise itself
+    IDT::setGate(INTERRUPT_SYSCALL, (uint32_t)syscallEntry, 3);
+
     // Load the IDT now that we've registered all of our IDT, IRQ, and ISR addresses
     IDT::init();
 }
 
 void registerHandler(uint8_t interrupt, InterruptHandler_t handler)
 {
-    interruptHandlers[interrupt] = handler;
+    rcu_assign_pointer(interruptHandlers[interrupt], handler);
+}
+
+void unregisterHandler(uint8_t interrupt)
+{
+    rcu_assign_pointer(interruptHandlers[interrupt], (InterruptHandler_t)NULL);
+    synchronize_rcu();
+}
+
+bool isRegistered(uint8_t interrupt)
+{
+    return rcu_dereference(interruptHandlers[interrupt]) != NULL;
 }
 
 } // !namespace Interrupts
@@ -73,6 +73,7 @@ enum Interrupt {
     INTERRUPT_13    = 0x2D,
     INTERRUPT_14    = 0x2E,
     INTERRUPT_15    = 0x2F,
+    INTERRUPT_SYSCALL = 0x80,   // Software interrupt used by user mode for system calls
 };
 
 /* Interrupt Service Routines */
@@ -86,6 +87,24 @@ typedef void (*InterruptHandler_t)(struct registers*);
  */
 void registerHandler(uint8_t interrupt, InterruptHandler_t handler);
 
+/**
+ * @brief Remove an interrupt's handler. Once this returns the old handler
+ * is no longer running on any CPU, so its data can be torn down. Must be
+ * called from task context.
+ *
+ * @param interrupt Interrupt vector
+ */
+void unregisterHandler(uint8_t interrupt);
+
+/**
+ * @brief Check whether a handler is installed for an interrupt.
+ *
+ * @param interrupt Interrupt vector
+ * @return true A handler is installed
+ * @return false The interrupt is unused
+ */
+bool isRegistered(uint8_t interrupt);
+
 /**
  * @brief
  *
@@ -0,0 +1,89 @@
+/**
+ * @file jump_label.cpp
+ * @author Keeton Feavel (keeton@xyr.is)
+ * @brief i686 jump label patching
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @copyright Copyright the Xyris Contributors (c) 2026
+ *
+ */
+#include <Arch/i686/jump_label.hpp>
+#include <Arch/Arch.hpp>
+#include <Library/string.hpp>
+#include <Panic.hpp>
+#include <cpuid.h>
+
+namespace Arch::JumpLabel {
+
+static const uint8_t nop[JUMP_LABEL_SIZE] = { JUMP_LABEL_NOP };
+
+// Site being patched (0 when there is none), and where code that runs into
+// its breakpoint continues
+static uintptr_t patchSite;
+static uintptr_t patchResume;
+static bool handlerInstalled = false;
+
+static void breakpointCallback(struct registers* regs)
+{
+    // int3 is a trap, so eip is already past it
+    if (regs->eip - 1 == __atomic_load_n(&patchSite, __ATOMIC_ACQUIRE)) {
+        regs->eip = __atomic_load_n(&patchResume, __ATOMIC_RELAXED);
+        return;
+    }
+
+    panic(regs);
+}
+
+static void serialize(void)
+{
+    // cpuid is serializing, so no stale copy of the site is left in the pipeline
+    uint32_t eax, ebx, ecx, edx;
+    __cpuid(0, eax, ebx, ecx, edx);
+    (void)eax;
+    (void)ebx;
+    (void)ecx;
+    (void)edx;
+}
+
+void patch(const struct Entry* entry, bool jump)
+{
+    uint8_t code[JUMP_LABEL_SIZE];
+    if (jump) {
+        int32_t offset = (int32_t)(entry->target - (entry->code + JUMP_LABEL_SIZE));
+        code[0] = JUMP_LABEL_JMP;
+        memcpy(&code[1], &offset, sizeof(offset));
+    } else {
+        memcpy(code, nop, JUMP_LABEL_SIZE);
+    }
+
+    if (!handlerInstalled) {
+        Interrupts::registerHandler(Interrupts::EXCEPTION_BREAKPOINT, breakpointCallback);
+        handlerInstalled = true;
+    }
+
+    // The instruction can't be replaced in one store, so it is done the way
+    // Linux' text_poke_bp() does it: a breakpoint on the first byte diverts
+    // anything that reaches the site while the rest is rewritten, then the
+    // first byte makes the new instruction live. Only the boot CPU runs
+    // kernel code for now. Once others do, each step needs them serialized
+    // too (an IPI) before the next.
+    volatile uint8_t* site = (volatile uint8_t*)entry->code;
+    Arch::CPU::criticalRegionNestable([&]() {
+        __atomic_store_n(&patchResume, jump ? entry->target : entry->code + JUMP_LABEL_SIZE, __ATOMIC_RELAXED);
+        __atomic_store_n(&patchSite, entry->code, __ATOMIC_RELEASE);
+
+        site[0] = JUMP_LABEL_INT3;
+        serialize();
+        for (size_t idx = 1; idx < JUMP_LABEL_SIZE; idx++) {
+            site[idx] = code[idx];
+        }
+        serialize();
+        site[0] = code[0];
+        serialize();
+
+        __atomic_store_n(&patchSite, 0, __ATOMIC_RELEASE);
+    });
+}
+
+} // !namespace Arch::JumpLabel
@@ -0,0 +1,83 @@
+/**
+ * @file jump_label.hpp
+ * @author Keeton Feavel (keeton@xyr.is)
+ * @brief i686 jump labels, the branch sites behind static keys (see
+ * Support/static_key.hpp). Each site is a single 5 byte instruction, either a
+ * NOP that falls through or a JMP to the other side of the branch, and is
+ * recorded in the `.static_keys` linker section so it can be patched from one
+ * to the other at runtime.
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @copyright Copyright the Xyris Contributors (c) 2026
+ *
+ */
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+
+#define JUMP_LABEL_SIZE     5
+#define JUMP_LABEL_JMP      0xE9    // jmp rel32
+#define JUMP_LABEL_INT3     0xCC
+// ds lea 0x0(%esi), %esi, a 5 byte NOP that every i686 has (unlike nopl)
+#define JUMP_LABEL_NOP      0x3E, 0x8D, 0x74, 0x26, 0x00
+#define JUMP_LABEL_NOP_ASM  ".byte 0x3e, 0x8d, 0x74, 0x26, 0x00\n\t"
+
+namespace Arch::JumpLabel {
+
+/**
+ * @brief A branch site, as recorded in `.static_keys`.
+ *
+ */
+struct Entry {
+    uintptr_t code;     // Address of the NOP or JMP
+    uintptr_t target;   // Where the JMP goes
+    uintptr_t key;      // Key address, bit 0 is set for sites that jump when the key is enabled
+};
+static_assert(sizeof(struct Entry) == 12, "Entries are emitted as three longs");
+
+/**
+ * @brief Emit a branch site. Sites in inline functions share the function's
+ * COMDAT group ("?"), so copies the linker throws away take their entries
+ * with them.
+ *
+ * @tparam key Key the site belongs to
+ * @tparam jumpWhenEnabled Whether the site jumps while the key is enabled (or
+ * while it is disabled)
+ * @tparam jumpInitially Whether the site is built as a JMP
+ * @return true The site jumped
+ */
+template<auto* key, bool jumpWhenEnabled, bool jumpInitially>
+[[gnu::always_inline]] inline bool site()
+{
+    asm goto(
+        "1:\n\t"
+        ".if %c[jump]\n\t"
+        ".byte 0xe9\n\t"
+        ".long %l[taken] - (. + 4)\n\t"
+        ".else\n\t"
+        JUMP_LABEL_NOP_ASM
+        ".endif\n\t"
+        ".pushsection .static_keys, \"a?\"\n\t"
+        ".balign 4\n\t"
+        ".long 1b, %l[taken], %c[key] + %c[branch]\n\t"
+        ".popsection\n\t"
+        :
+        : [key] "i"(key), [branch] "i"(jumpWhenEnabled), [jump] "i"(jumpInitially)
+        :
+        : taken);
+    return false;
+taken:
+    return true;
+}
+
+/**
+ * @brief Turn a site into a JMP or a NOP. Safe to call while other code
+ * may be running the site.
+ *
+ * @param entry Site to patch
+ * @param jump Make the site a JMP (true) or a NOP (false)
+ */
+void patch(const struct Entry* entry, bool jump);
+
+} // !namespace Arch::JumpLabel
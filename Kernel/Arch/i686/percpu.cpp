@@ -0,0 +1,42 @@
+/**
+ * @file percpu.cpp
+ * @author Keeton Feavel (keeton@xyr.is)
+ * @brief Per-CPU data blocks and their segment setup
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @copyright Copyright the Xyris Contributors (c) 2026
+ *
+ */
+#include <Arch/i686/gdt.hpp>
+#include <Arch/i686/percpu.hpp>
+
+// tasks.s reads the running task directly through %gs
+static_assert(offsetof(struct percpu, current_task) == 8, "Update PERCPU_CURRENT_TASK in tasks.s");
+// interrupt.s reloads the boot CPU's segment when entering from user mode
+static_assert(GDT_SELECTOR(GDT_PERCPU_INDEX) == 0x30, "Update PERCPU_SELECTOR in interrupt.s");
+
+namespace PerCPU {
+
+static struct percpu blocks[PERCPU_MAX_CPUS];
+
+void init(uint32_t cpu)
+{
+    struct percpu* data = &blocks[cpu];
+    data->self = data;
+    data->id = cpu;
+
+    uint16_t selector = GDT_SELECTOR(GDT_PERCPU_INDEX + cpu);
+    asm volatile("mov %0, %%gs" : : "r"(selector) : "memory");
+}
+
+struct percpu* block(uint32_t cpu)
+{
+    if (cpu >= PERCPU_MAX_CPUS) {
+        return NULL;
+    }
+
+    return &blocks[cpu];
+}
+
+} // !namespace PerCPU
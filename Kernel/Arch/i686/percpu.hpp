@@ -0,0 +1,141 @@
+/**
+ * @file percpu.hpp
+ * @author Keeton Feavel (keeton@xyr.is)
+ * @brief Per-CPU data. Each CPU has its own data block and a dedicated GDT
+ * data segment whose base is that block, loaded into %gs. Fields are
+ * accessed with `this_cpu_*()`, which compile to single %gs-prefixed
+ * instructions (two for 64-bit fields).
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @copyright Copyright the Xyris Contributors (c) 2026
+ *
+ */
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+
+#define PERCPU_MAX_CPUS 8
+
+struct task;
+
+/**
+ * @brief Per-CPU data block. Field offsets used from assembly are checked
+ * in percpu.cpp, so keep those in sync when reordering.
+ *
+ */
+struct percpu
+{
+    struct percpu *self;            // Linear address of this block
+    uint32_t id;                    // CPU index
+    struct task *current_task;      // Running task (NULL while idle)
+    // Scheduler state
+    uint64_t time_slice_remaining;
+    uint64_t last_time;
+    uint64_t last_timer_time;
+    uint64_t last_tick_time;
+    size_t scheduler_lock;          // Nesting depth of interrupts-off scheduler sections
+    size_t preempt_count;           // Preemption is disabled while non-zero
+    bool need_resched;              // A reschedule was deferred by preempt_count
+    uint32_t rcu_qs;                // Quiescent states passed, read by other CPUs (see rcu.cpp)
+    // Statistics
+    uint64_t idle_time;
+    uint64_t context_switches;
+    uint64_t irq_off_start;         // TSC when the current interrupts-off section began
+    uint64_t irq_off_max;           // Longest interrupts-off scheduler section (TSC cycles)
+    uint64_t preempt_off_start;     // TSC when preemption was last disabled
+    uint64_t preempt_off_max;       // Longest preemption-off section (TSC cycles)
+};
+
+namespace PerCPU {
+
+/**
+ * @brief Initialize the calling CPU's block and load its segment into %gs.
+ * The GDT must already be installed.
+ *
+ * @param cpu CPU index
+ */
+void init(uint32_t cpu);
+
+/**
+ * @brief Get a CPU's data block (e.g. to report statistics).
+ *
+ * @param cpu CPU index
+ * @return struct percpu* Data block or NULL if the index is out of range
+ */
+struct percpu* block(uint32_t cpu);
+
+template <typename T, size_t Offset>
+[[gnu::always_inline]] inline T load()
+{
+    static_assert(sizeof(T) == 1 || sizeof(T) == 2 || sizeof(T) == 4 || sizeof(T) == 8);
+    if constexpr (sizeof(T) == 1) {
+        uint8_t raw;
+        asm volatile("movb %%gs:%c1, %0" : "=q"(raw) : "i"(Offset));
+        return __builtin_bit_cast(T, raw);
+    } else if constexpr (sizeof(T) == 2) {
+        uint16_t raw;
+        asm volatile("movw %%gs:%c1, %0" : "=r"(raw) : "i"(Offset));
+        return __builtin_bit_cast(T, raw);
+    } else if constexpr (sizeof(T) == 4) {
+        uint32_t raw;
+        asm volatile("movl %%gs:%c1, %0" : "=r"(raw) : "i"(Offset));
+        return __builtin_bit_cast(T, raw);
+    } else {
+        // Not atomic with respect to interrupts that modify the same field
+        uint32_t low, high;
+        asm volatile("movl %%gs:%c2, %0\n\t"
+                     "movl %%gs:%c3, %1"
+                     : "=r"(low), "=r"(high)
+                     : "i"(Offset), "i"(Offset + 4));
+        return __builtin_bit_cast(T, ((uint64_t)high << 32) | low);
+    }
+}
+
+template <typename T, size_t Offset>
+[[gnu::always_inline]] inline void store(T val)
+{
+    static_assert(sizeof(T) == 1 || sizeof(T) == 2 || sizeof(T) == 4 || sizeof(T) == 8);
+    if constexpr (sizeof(T) == 1) {
+        asm volatile("movb %0, %%gs:%c1" : : "qi"(__builtin_bit_cast(uint8_t, val)), "i"(Offset) : "memory");
+    } else if constexpr (sizeof(T) == 2) {
+        asm volatile("movw %0, %%gs:%c1" : : "ri"(__builtin_bit_cast(uint16_t, val)), "i"(Offset) : "memory");
+    } else if constexpr (sizeof(T) == 4) {
+        asm volatile("movl %0, %%gs:%c1" : : "ri"(__builtin_bit_cast(uint32_t, val)), "i"(Offset) : "memory");
+    } else {
+        uint64_t raw = __builtin_bit_cast(uint64_t, val);
+        asm volatile("movl %0, %%gs:%c2\n\t"
+                     "movl %1, %%gs:%c3"
+                     :
+                     : "ri"((uint32_t)raw), "ri"((uint32_t)(raw >> 32)), "i"(Offset), "i"(Offset + 4)
+                     : "memory");
+    }
+}
+
+template <typename T, size_t Offset>
+[[gnu::always_inline]] inline void add(T val)
+{
+    static_assert(sizeof(T) == 4 || sizeof(T) == 8, "Only 32 and 64-bit counters are supported");
+    if constexpr (sizeof(T) == 4) {
+        asm volatile("addl %0, %%gs:%c1" : : "ri"((uint32_t)val), "i"(Offset) : "memory", "cc");
+    } else {
+        uint64_t raw = (uint64_t)val;
+        asm volatile("addl %0, %%gs:%c2\n\t"
+                     "adcl %1, %%gs:%c3"
+                     :
+                     : "ri"((uint32_t)raw), "ri"((uint32_t)(raw >> 32)), "i"(Offset), "i"(Offset + 4)
+                     : "memory", "cc");
+    }
+}
+
+} // !namespace PerCPU
+
+#define this_cpu_read(field) \
+    PerCPU::load<decltype(percpu::field), offsetof(struct percpu, field)>()
+#define this_cpu_write(field, val) \
+    PerCPU::store<decltype(percpu::field), offsetof(struct percpu, field)>(val)
+#define this_cpu_add(field, val) \
+    PerCPU::add<decltype(percpu::field), offsetof(struct percpu, field)>(val)
+#define this_cpu_inc(field) this_cpu_add(field, 1)
+#define this_cpu_dec(field) this_cpu_add(field, -1)
+#define this_cpu_ptr() this_cpu_read(self)
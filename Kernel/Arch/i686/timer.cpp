@@ -43,6 +43,10 @@ void timer_init(uint32_t freq) {
 
 static void timer_callback(struct registers *regs) {
     (void)regs;
+    timer_handle_tick();
+}
+
+void timer_handle_tick() {
     timer_tick = timer_tick + 1;
     for (size_t i = 0; i < _callback_count; i++) {
         _callbacks[i]();
@@ -14,6 +14,7 @@
 
 #define TIMER_COMMAND_PORT 0x43
 #define TIMER_DATA_PORT 0x40
+#define TIMER_FREQUENCY 1000    // Tick rate in Hz (1ms)
 
 extern volatile uint32_t timer_tick;
 
@@ -23,6 +24,12 @@ extern volatile uint32_t timer_tick;
  * @param freq Timer frequency
  */
 void timer_init(uint32_t freq);
+/**
+ * @brief Advance the tick count and run the tick callbacks. Called by the
+ * PIT interrupt, or by whichever timer took over its interrupt line.
+ *
+ */
+void timer_handle_tick();
 /**
  * @brief Sleeps for a certain length of time.
  *
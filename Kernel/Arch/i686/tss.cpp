@@ -0,0 +1,37 @@
+/**
+ * @file tss.cpp
+ * @author Keeton Feavel (keeton@xyr.is)
+ * @brief Task State Segment setup. Only the ring 0 stack fields are used,
+ * task switching itself is done in software.
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @copyright Copyright the Xyris Contributors (c) 2026
+ *
+ */
+#include <Arch/i686/tss.hpp>
+#include <Arch/i686/gdt.hpp>
+#include <Arch/i686/Assembly/Flush.h>
+#include <Library/string.hpp>
+
+namespace TSS {
+
+static struct tss_entry tss;
+
+void init()
+{
+    memset(&tss, 0, sizeof(tss));
+    tss.ss0 = GDT_SELECTOR(GDT_KERNEL_DATA_INDEX);
+    // No I/O permission bitmap, so ring 3 can't touch any ports
+    tss.iomap_base = sizeof(tss);
+
+    GDT::installTSS((uintptr_t)&tss, sizeof(tss) - 1);
+    tss_flush();
+}
+
+void setKernelStack(uintptr_t esp0)
+{
+    tss.esp0 = esp0;
+}
+
+} // !namespace TSS
@@ -9,8 +9,6 @@
  *
  */
 #pragma once
-#include <Arch/i686/Arch.i686.hpp>
-#include <Arch/i686/Assembly/Flush.h>
 #include <stdint.h>
 
 /**
@@ -51,4 +49,24 @@ struct [[gnu::packed]] tss_entry {
     uint32_t    ldt;
     uint16_t    trap;
     uint16_t    iomap_base;
-} tss_entry_t;
+};
+static_assert(sizeof(struct tss_entry) == 104);
+
+namespace TSS {
+
+/**
+ * @brief Install the boot CPU's TSS into the GDT and load it. Must be
+ * called after the GDT is installed.
+ *
+ */
+void init();
+
+/**
+ * @brief Set the stack the CPU switches to when an interrupt or system
+ * call arrives from ring 3.
+ *
+ * @param esp0 Top of the kernel stack
+ */
+void setKernelStack(uintptr_t esp0);
+
+} // !namespace TSS
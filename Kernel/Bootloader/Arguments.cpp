@@ -17,8 +17,10 @@ namespace Boot {
 void parseCommandLine(char* cmdline)
 {
     for (struct argument* arg = _ARGUMENTS_START; arg < _ARGUMENTS_END; arg++) {
-        if (strstr(cmdline, arg->arg)) {
-            arg->callback(arg->arg);
+        const char* found = strstr(cmdline, arg->arg);
+        if (found) {
+            // arguments ending in '=' take whatever follows as their value
+            arg->callback(found + strlen(arg->arg));
         }
     }
 }
@@ -18,6 +18,12 @@
 
 namespace Boot {
 
+/**
+ * @brief Argument callback. Receives the rest of the command line after the
+ * argument, so arguments registered as e.g. "--foo=" get their value first
+ * (terminated by a space or the end of the command line).
+ *
+ */
 typedef void (*cmdline_cb_t)(const char* arg);
 struct argument {
     char arg[MAX_ARGUMENT_LEN];
@@ -38,6 +38,8 @@ namespace Boot {
 Handoff::Handoff()
     : m_handle(NULL)
     , m_magic(0)
+    , m_rsdp(0)
+    , m_moduleCount(0)
 {
     // Initialize nothing.
 }
@@ -45,6 +47,8 @@ Handoff::Handoff()
 Handoff::Handoff(void* handoff, uint32_t magic)
     : m_handle(handoff)
     , m_magic(magic)
+    , m_rsdp(0)
+    , m_moduleCount(0)
 {
     // Parse the handle based on the magic
     Logger::Info(__func__, "Bootloader info at 0x%p", handoff);
@@ -169,6 +173,31 @@ void Handoff::parseStivale2(Handoff* that, void* handoff)
                     framebuffer->blue_mask_shift);
                 break;
             }
+            case STIVALE2_STRUCT_TAG_RSDP_ID: {
+                auto rsdp = (struct stivale2_struct_tag_rsdp*)tag;
+                Logger::Debug(__func__, "Stivale2 RSDP: 0x%0Lx", rsdp->rsdp);
+                that->m_rsdp = (uintptr_t)rsdp->rsdp;
+                break;
+            }
+            case STIVALE2_STRUCT_TAG_MODULES_ID: {
+                auto modules = (struct stivale2_struct_tag_modules*)tag;
+                Logger::Debug(__func__, "Found %Lu Stivale2 modules", modules->module_count);
+                for (size_t i = 0; i < modules->module_count; i++) {
+                    auto module = &modules->modules[i];
+                    if (that->m_moduleCount == HANDOFF_MAX_MODULES) {
+                        Logger::Warning(__func__, "Ignoring module '%s', too many modules", module->string);
+                        continue;
+                    }
+
+                    that->m_modules[that->m_moduleCount++] = {
+                        .begin = (uintptr_t)module->begin,
+                        .end = (uintptr_t)module->end,
+                        .name = module->string,
+                    };
+                    Logger::Debug(__func__, "[%zu] 0x%0Lx-0x%0Lx '%s'", i, module->begin, module->end, module->string);
+                }
+                break;
+            }
             default: {
                 Logger::Debug(__func__, "Unknown Stivale2 tag: 0x%016LX", tag->identifier);
                 break;
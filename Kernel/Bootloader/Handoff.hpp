@@ -81,10 +81,18 @@ private:
     uint64_t m_cpuCount;
 };
 
+#define HANDOFF_MAX_MODULES 8
+
+// Boot module loaded alongside the kernel
+struct HandoffModule {
+    uintptr_t begin;    // Physical start address
+    uintptr_t end;      // Physical end address (exclusive)
+    const char* name;   // Module string from the bootloader config
+};
+
 // TODO: Remaining information to be made obtainable
 //  * PXE IP address (once we have a nice IP struct)
 //  * Update Stivale2 to latest version & add missing
-//  * Kernel modules (linked list of some sort?)
 class Handoff {
 public:
     // Constructors
@@ -96,6 +104,9 @@ public:
     Graphics::Framebuffer* FramebufferInfo()    { return &m_framebuffer; }
     HandoffBootloaderType* BootType()           { return &m_bootType; }
     Memory::MemoryMap& MemoryMap()              { return m_memoryMap; }
+    uintptr_t RSDP()                            { return m_rsdp; }
+    size_t ModuleCount()                        { return m_moduleCount; }
+    const HandoffModule& Module(size_t idx)     { return m_modules[idx]; }
 
 private:
     static void parseStivale2(Handoff* that, void* handoff);
@@ -106,6 +117,9 @@ private:
     Graphics::Framebuffer m_framebuffer;
     HandoffBootloaderType m_bootType;
     Memory::MemoryMap m_memoryMap;
+    uintptr_t m_rsdp;
+    HandoffModule m_modules[HANDOFF_MAX_MODULES];
+    size_t m_moduleCount;
 };
 
 }; // !namespace Boot
@@ -0,0 +1,395 @@
+/**
+ * @file acpi.cpp
+ * @author Keeton Feavel (keeton@xyr.is)
+ * @brief ACPI static table discovery. Tables are validated once at boot and
+ * indexed by signature, and the tables the kernel depends on (MADT, HPET,
+ * FADT) are decoded into typed structures.
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @copyright Copyright the Xyris Contributors (c) 2026
+ *
+ */
+#include <Arch/Memory.hpp>
+#include <Devices/ACPI/acpi.hpp>
+#include <Library/string.hpp>
+#include <Memory/paging.hpp>
+#include <Logger.hpp>
+
+#define ACPI_EBDA_POINTER   0x040E  // Real mode segment of the extended BIOS data area
+#define ACPI_BIOS_START     0xE0000
+#define ACPI_BIOS_END       0x100000
+
+// MADT entry types
+#define MADT_LOCAL_APIC             0
+#define MADT_IOAPIC                 1
+#define MADT_INTERRUPT_OVERRIDE     2
+#define MADT_LOCAL_APIC_OVERRIDE    5
+#define MADT_LOCAL_X2APIC           9
+
+#define MADT_ENABLED                (1 << 0)
+
+namespace ACPI {
+
+struct [[gnu::packed]] MADTHeader {
+    struct SDTHeader header;
+    uint32_t localApicAddress;
+    uint32_t flags;
+};
+
+struct [[gnu::packed]] MADTEntry {
+    uint8_t type;
+    uint8_t length;
+};
+
+struct [[gnu::packed]] MADTLocalApic {
+    struct MADTEntry entry;
+    uint8_t processorId;
+    uint8_t apicId;
+    uint32_t flags;
+};
+
+struct [[gnu::packed]] MADTIOAPIC {
+    struct MADTEntry entry;
+    uint8_t id;
+    uint8_t reserved;
+    uint32_t address;
+    uint32_t gsiBase;
+};
+
+struct [[gnu::packed]] MADTInterruptOverride {
+    struct MADTEntry entry;
+    uint8_t bus;
+    uint8_t source;
+    uint32_t gsi;
+    uint16_t flags;
+};
+
+struct [[gnu::packed]] MADTLocalApicOverride {
+    struct MADTEntry entry;
+    uint16_t reserved;
+    uint64_t address;
+};
+
+struct [[gnu::packed]] MADTLocalX2Apic {
+    struct MADTEntry entry;
+    uint16_t reserved;
+    uint32_t x2apicId;
+    uint32_t flags;
+    uint32_t processorId;
+};
+
+static const struct SDTHeader* tables[ACPI_MAX_TABLES];
+static size_t tableCount = 0;
+static uint8_t rsdpRevision = 0;
+
+static uintptr_t lapicAddress = 0;
+static struct Processor processors[ACPI_MAX_PROCESSORS];
+static size_t processorTotal = 0;
+static struct IOAPIC ioapics[ACPI_MAX_IOAPICS];
+static size_t ioapicTotal = 0;
+static struct InterruptOverride overrides[ACPI_MAX_OVERRIDES];
+static size_t overrideTotal = 0;
+static struct FADT fadtCopy;
+static bool fadtPresent = false;
+
+static bool checksum(const void* data, size_t length)
+{
+    const uint8_t* bytes = (const uint8_t*)data;
+    uint8_t sum = 0;
+    for (size_t i = 0; i < length; i++) {
+        sum = (uint8_t)(sum + bytes[i]);
+    }
+
+    return sum == 0;
+}
+
+// Tables are identity mapped, the same as other firmware and device memory
+static void mapRange(uintptr_t physical, size_t length)
+{
+    uintptr_t start = Arch::Memory::pageAlign(physical);
+    uintptr_t end = Arch::Memory::pageAlignUp(physical + length);
+    Memory::mapKernelRangeVirtual(Memory::Section(start, end - start));
+}
+
+static const struct SDTHeader* mapTable(uint64_t physical)
+{
+    // Tables above 4 GiB cannot be reached without PAE
+    if (!physical || physical > UINTPTR_MAX - sizeof(struct SDTHeader)) {
+        return NULL;
+    }
+
+    mapRange((uintptr_t)physical, sizeof(struct SDTHeader));
+    const struct SDTHeader* header = (const struct SDTHeader*)(uintptr_t)physical;
+    if (header->length < sizeof(struct SDTHeader)) {
+        return NULL;
+    }
+
+    mapRange((uintptr_t)physical, header->length);
+    if (!checksum(header, header->length)) {
+        char name[ACPI_SIGNATURE_LENGTH + 1] = { 0 };
+        memcpy(name, header->signature, ACPI_SIGNATURE_LENGTH);
+        Logger::Warning(__func__, "Invalid checksum for table %s", name);
+        return NULL;
+    }
+
+    return header;
+}
+
+static void addTable(uint64_t physical)
+{
+    const struct SDTHeader* table = mapTable(physical);
+    if (!table) {
+        return;
+    }
+    if (tableCount == ACPI_MAX_TABLES) {
+        Logger::Warning(__func__, "Too many ACPI tables");
+        return;
+    }
+
+    tables[tableCount++] = table;
+}
+
+static const struct RSDP* scan(uintptr_t start, uintptr_t end)
+{
+    // The RSDP is always on a 16 byte boundary
+    for (uintptr_t addr = start; addr + sizeof(struct RSDP) <= end; addr += 16) {
+        const struct RSDP* rsdp = (const struct RSDP*)addr;
+        if (!memcmp(rsdp->signature, "RSD PTR ", sizeof(rsdp->signature)) && checksum(rsdp, 20)) {
+            return rsdp;
+        }
+    }
+
+    return NULL;
+}
+
+static const struct RSDP* findRSDP(uintptr_t address)
+{
+    if (address) {
+        mapRange(address, sizeof(struct RSDP));
+        const struct RSDP* rsdp = (const struct RSDP*)address;
+        if (!memcmp(rsdp->signature, "RSD PTR ", sizeof(rsdp->signature)) && checksum(rsdp, 20)) {
+            return rsdp;
+        }
+        Logger::Warning(__func__, "Bootloader provided an invalid RSDP");
+    }
+
+    // The first 1 MiB is identity mapped, so the BIOS areas can be read directly.
+    // The pointer is laundered so GCC cannot see a constant address near NULL,
+    // which it otherwise reports as an out of bounds access at -O2 and above.
+    const volatile uint16_t* ebdaPointer = (const volatile uint16_t*)ACPI_EBDA_POINTER;
+    asm("" : "+r"(ebdaPointer));
+    uintptr_t ebda = (uintptr_t)*ebdaPointer << 4;
+    const struct RSDP* rsdp = NULL;
+    if (ebda) {
+        rsdp = scan(ebda, ebda + 1024);
+    }
+    if (!rsdp) {
+        rsdp = scan(ACPI_BIOS_START, ACPI_BIOS_END);
+    }
+
+    return rsdp;
+}
+
+template<typename T>
+static void indexRoot(const struct SDTHeader* root)
+{
+    // Entries are not necessarily aligned to their size
+    const uint8_t* entries = (const uint8_t*)(root + 1);
+    size_t count = (root->length - sizeof(struct SDTHeader)) / sizeof(T);
+    for (size_t i = 0; i < count; i++) {
+        T address;
+        memcpy(&address, entries + i * sizeof(T), sizeof(T));
+        addTable(address);
+    }
+}
+
+static void parseMADT()
+{
+    const struct MADTHeader* madt = (const struct MADTHeader*)findTable("APIC");
+    if (!madt) {
+        return;
+    }
+
+    lapicAddress = madt->localApicAddress;
+    const uint8_t* cursor = (const uint8_t*)(madt + 1);
+    const uint8_t* end = (const uint8_t*)madt + madt->header.length;
+    while (cursor + sizeof(struct MADTEntry) <= end) {
+        const struct MADTEntry* entry = (const struct MADTEntry*)cursor;
+        if (entry->length < sizeof(struct MADTEntry) || cursor + entry->length > end) {
+            break;
+        }
+
+        switch (entry->type) {
+            case MADT_LOCAL_APIC: {
+                auto lapic = (const struct MADTLocalApic*)entry;
+                if (processorTotal < ACPI_MAX_PROCESSORS) {
+                    processors[processorTotal++] = { lapic->processorId, lapic->apicId, (bool)(lapic->flags & MADT_ENABLED) };
+                }
+                break;
+            }
+            case MADT_LOCAL_X2APIC: {
+                auto x2apic = (const struct MADTLocalX2Apic*)entry;
+                if (processorTotal < ACPI_MAX_PROCESSORS) {
+                    processors[processorTotal++] = { x2apic->processorId, x2apic->x2apicId, (bool)(x2apic->flags & MADT_ENABLED) };
+                }
+                break;
+            }
+            case MADT_IOAPIC: {
+                auto ioapic = (const struct MADTIOAPIC*)entry;
+                if (ioapicTotal < ACPI_MAX_IOAPICS) {
+                    ioapics[ioapicTotal++] = { ioapic->id, ioapic->address, ioapic->gsiBase };
+                }
+                break;
+            }
+            case MADT_INTERRUPT_OVERRIDE: {
+                auto iso = (const struct MADTInterruptOverride*)entry;
+                if (overrideTotal < ACPI_MAX_OVERRIDES) {
+                    overrides[overrideTotal++] = { iso->source, iso->gsi, iso->flags };
+                }
+                break;
+            }
+            case MADT_LOCAL_APIC_OVERRIDE: {
+                auto override = (const struct MADTLocalApicOverride*)entry;
+                if (override->address <= UINTPTR_MAX) {
+                    lapicAddress = (uintptr_t)override->address;
+                }
+                break;
+            }
+            default:
+                break;
+        }
+
+        cursor += entry->length;
+    }
+}
+
+static void parseFADT()
+{
+    const struct SDTHeader* table = findTable("FACP");
+    if (!table) {
+        return;
+    }
+
+    // Older revisions are shorter. Missing fields read as zero.
+    size_t length = table->length < sizeof(struct FADT) ? table->length : sizeof(struct FADT);
+    memset(&fadtCopy, 0, sizeof(struct FADT));
+    memcpy(&fadtCopy, table, length);
+    fadtPresent = true;
+
+    // The DSDT is referenced from the FADT rather than the root table
+    addTable(fadtCopy.extendedDsdt ? fadtCopy.extendedDsdt : fadtCopy.dsdt);
+}
+
+void init(uintptr_t address)
+{
+    const struct RSDP* rsdp = findRSDP(address);
+    if (!rsdp) {
+        Logger::Warning(__func__, "No RSDP found");
+        return;
+    }
+
+    rsdpRevision = rsdp->revision;
+    // Prefer the XSDT when the extended structure is valid
+    if (rsdp->revision >= 2 && rsdp->xsdtAddress && checksum(rsdp, sizeof(struct RSDP))) {
+        const struct SDTHeader* xsdt = mapTable(rsdp->xsdtAddress);
+        if (xsdt) {
+            indexRoot<uint64_t>(xsdt);
+        }
+    }
+    if (!tableCount) {
+        const struct SDTHeader* rsdt = mapTable(rsdp->rsdtAddress);
+        if (rsdt) {
+            indexRoot<uint32_t>(rsdt);
+        }
+    }
+
+    parseFADT();
+    parseMADT();
+
+    for (size_t i = 0; i < tableCount; i++) {
+        char name[ACPI_SIGNATURE_LENGTH + 1] = { 0 };
+        memcpy(name, tables[i]->signature, ACPI_SIGNATURE_LENGTH);
+        Logger::Debug(__func__, "%s at 0x%08lX (%lu bytes)", name, (uintptr_t)tables[i], tables[i]->length);
+    }
+    Logger::Info(
+        __func__,
+        "ACPI revision %u: %zu tables, %zu processors, %zu I/O APICs",
+        rsdpRevision,
+        tableCount,
+        processorTotal,
+        ioapicTotal);
+}
+
+const struct SDTHeader* findTable(const char* signature, size_t index)
+{
+    for (size_t i = 0; i < tableCount; i++) {
+        if (memcmp(tables[i]->signature, signature, ACPI_SIGNATURE_LENGTH)) {
+            continue;
+        }
+        if (index--) {
+            continue;
+        }
+
+        return tables[i];
+    }
+
+    return NULL;
+}
+
+uint8_t revision()
+{
+    return rsdpRevision;
+}
+
+uintptr_t localApicAddress()
+{
+    return lapicAddress;
+}
+
+size_t processorCount()
+{
+    return processorTotal;
+}
+
+const struct Processor* processor(size_t index)
+{
+    return index < processorTotal ? &processors[index] : NULL;
+}
+
+size_t ioapicCount()
+{
+    return ioapicTotal;
+}
+
+const struct IOAPIC* ioapic(size_t index)
+{
+    return index < ioapicTotal ? &ioapics[index] : NULL;
+}
+
+size_t interruptOverrideCount()
+{
+    return overrideTotal;
+}
+
+const struct InterruptOverride* interruptOverride(size_t index)
+{
+    return index < overrideTotal ? &overrides[index] : NULL;
+}
+
+const struct HPETTable* hpet()
+{
+    const struct SDTHeader* table = findTable("HPET");
+    if (!table || table->length < sizeof(struct HPETTable)) {
+        return NULL;
+    }
+
+    return (const struct HPETTable*)table;
+}
+
+const struct FADT* fadt()
+{
+    return fadtPresent ? &fadtCopy : NULL;
+}
+
+} // !namespace ACPI
@@ -0,0 +1,234 @@
+/**
+ * @file acpi.hpp
+ * @author Keeton Feavel (keeton@xyr.is)
+ * @brief ACPI static table discovery. Tables are validated once at boot and
+ * indexed by signature, and the tables the kernel depends on (MADT, HPET,
+ * FADT) are decoded into typed structures.
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @copyright Copyright the Xyris Contributors (c) 2026
+ *
+ * References:
+ *         https://uefi.org/specs/ACPI/6.4/05_ACPI_Software_Programming_Model/ACPI_Software_Programming_Model.html
+ */
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+
+#define ACPI_SIGNATURE_LENGTH   4
+#define ACPI_MAX_TABLES         32
+#define ACPI_MAX_PROCESSORS     32
+#define ACPI_MAX_IOAPICS        4
+#define ACPI_MAX_OVERRIDES      16
+
+namespace ACPI {
+
+struct [[gnu::packed]] RSDP {
+    char signature[8];      // "RSD PTR "
+    uint8_t checksum;       // Covers the first 20 bytes
+    char oemId[6];
+    uint8_t revision;       // 0 for ACPI 1.0, 2 for ACPI 2.0+
+    uint32_t rsdtAddress;
+    // ACPI 2.0+
+    uint32_t length;
+    uint64_t xsdtAddress;
+    uint8_t extendedChecksum;
+    uint8_t reserved[3];
+};
+static_assert(sizeof(struct RSDP) == 36);
+
+struct [[gnu::packed]] SDTHeader {
+    char signature[ACPI_SIGNATURE_LENGTH];
+    uint32_t length;        // Length of the whole table including this header
+    uint8_t revision;
+    uint8_t checksum;       // All bytes of the table sum to zero
+    char oemId[6];
+    char oemTableId[8];
+    uint32_t oemRevision;
+    uint32_t creatorId;
+    uint32_t creatorRevision;
+};
+static_assert(sizeof(struct SDTHeader) == 36);
+
+/**
+ * @brief Generic Address Structure, describing a register in a given address space.
+ *
+ */
+struct [[gnu::packed]] GenericAddress {
+    uint8_t addressSpace;   // ACPI_ADDRESS_SPACE_*
+    uint8_t bitWidth;
+    uint8_t bitOffset;
+    uint8_t accessSize;
+    uint64_t address;
+};
+static_assert(sizeof(struct GenericAddress) == 12);
+
+#define ACPI_ADDRESS_SPACE_MEMORY   0
+#define ACPI_ADDRESS_SPACE_IO       1
+
+struct [[gnu::packed]] HPETTable {
+    struct SDTHeader header;
+    uint32_t blockId;       // Hardware revision, comparator count, and vendor
+    struct GenericAddress address;
+    uint8_t number;
+    uint16_t minimumTick;   // Smallest periodic interval without lost interrupts
+    uint8_t pageProtection;
+};
+static_assert(sizeof(struct HPETTable) == 56);
+
+/**
+ * @brief Fixed ACPI Description Table. Fields past the end of an older
+ * (shorter) table read as zero.
+ *
+ */
+struct [[gnu::packed]] FADT {
+    struct SDTHeader header;
+    uint32_t firmwareControl;
+    uint32_t dsdt;
+    uint8_t reserved0;
+    uint8_t preferredProfile;
+    uint16_t sciInterrupt;
+    uint32_t smiCommand;
+    uint8_t acpiEnable;
+    uint8_t acpiDisable;
+    uint8_t s4biosRequest;
+    uint8_t pstateControl;
+    uint32_t pm1aEventBlock;
+    uint32_t pm1bEventBlock;
+    uint32_t pm1aControlBlock;
+    uint32_t pm1bControlBlock;
+    uint32_t pm2ControlBlock;
+    uint32_t pmTimerBlock;
+    uint32_t gpe0Block;
+    uint32_t gpe1Block;
+    uint8_t pm1EventLength;
+    uint8_t pm1ControlLength;
+    uint8_t pm2ControlLength;
+    uint8_t pmTimerLength;
+    uint8_t gpe0Length;
+    uint8_t gpe1Length;
+    uint8_t gpe1Base;
+    uint8_t cstateControl;
+    uint16_t c2Latency;     // Worst case C2 exit latency in microseconds (> 100 means unsupported)
+    uint16_t c3Latency;     // Worst case C3 exit latency in microseconds (> 1000 means unsupported)
+    uint16_t flushSize;
+    uint16_t flushStride;
+    uint8_t dutyOffset;
+    uint8_t dutyWidth;
+    uint8_t dayAlarm;
+    uint8_t monthAlarm;
+    uint8_t century;
+    uint16_t bootArchitectureFlags;
+    uint8_t reserved1;
+    uint32_t flags;         // ACPI_FADT_*
+    struct GenericAddress resetRegister;
+    uint8_t resetValue;
+    uint16_t armBootArchitectureFlags;
+    uint8_t minorVersion;
+    // ACPI 2.0+
+    uint64_t extendedFirmwareControl;
+    uint64_t extendedDsdt;
+    struct GenericAddress extendedPm1aEventBlock;
+    struct GenericAddress extendedPm1bEventBlock;
+    struct GenericAddress extendedPm1aControlBlock;
+    struct GenericAddress extendedPm1bControlBlock;
+    struct GenericAddress extendedPm2ControlBlock;
+    struct GenericAddress extendedPmTimerBlock;
+    struct GenericAddress extendedGpe0Block;
+    struct GenericAddress extendedGpe1Block;
+};
+static_assert(sizeof(struct FADT) == 244);
+
+#define ACPI_FADT_WBINVD            (1 << 0)
+#define ACPI_FADT_C1_SUPPORTED      (1 << 2)    // PROC_C1: C1 (HLT) works on all processors
+#define ACPI_FADT_C2_MP_SUPPORTED   (1 << 3)
+#define ACPI_FADT_PM_TIMER_32BIT    (1 << 8)
+#define ACPI_FADT_RESET_SUPPORTED   (1 << 10)
+#define ACPI_FADT_HW_REDUCED        (1 << 20)
+
+/**
+ * @brief A processor local APIC from the MADT.
+ *
+ */
+struct Processor {
+    uint32_t processorId;   // ACPI processor UID
+    uint32_t apicId;
+    bool enabled;           // Usable now (as opposed to only online capable)
+};
+
+/**
+ * @brief An I/O APIC from the MADT.
+ *
+ */
+struct IOAPIC {
+    uint8_t id;
+    uint32_t address;       // Physical MMIO base
+    uint32_t gsiBase;       // First global system interrupt handled
+};
+
+/**
+ * @brief An ISA interrupt that is wired to a different global system interrupt.
+ *
+ */
+struct InterruptOverride {
+    uint8_t source;         // ISA IRQ
+    uint32_t gsi;
+    uint16_t flags;         // Polarity and trigger mode
+};
+
+/**
+ * @brief Locate the RSDP, then validate and index every system description
+ * table. Must be called after paging is enabled.
+ *
+ * @param rsdp Physical address of the RSDP provided by the bootloader (0 to
+ * search the BIOS areas)
+ */
+void init(uintptr_t rsdp = 0);
+
+/**
+ * @brief Find a system description table by its signature. Lookups are
+ * served from the index built by `init()`.
+ *
+ * @param signature Four character table signature (e.g. "HPET")
+ * @param index Which instance of the table to return
+ * @return const SDTHeader* Table or NULL if it does not exist
+ */
+const struct SDTHeader* findTable(const char* signature, size_t index = 0);
+
+/**
+ * @brief ACPI revision reported by the RSDP.
+ *
+ */
+uint8_t revision();
+
+/**
+ * @brief Physical address of the local APIC.
+ *
+ */
+uintptr_t localApicAddress();
+
+size_t processorCount();
+const struct Processor* processor(size_t index);
+
+size_t ioapicCount();
+const struct IOAPIC* ioapic(size_t index);
+
+size_t interruptOverrideCount();
+const struct InterruptOverride* interruptOverride(size_t index);
+
+/**
+ * @brief HPET description table.
+ *
+ * @return const HPETTable* Table or NULL if there is no HPET
+ */
+const struct HPETTable* hpet();
+
+/**
+ * @brief Fixed ACPI description table, padded to the latest revision.
+ *
+ * @return const FADT* Table or NULL if there is no FADT
+ */
+const struct FADT* fadt();
+
+} // !namespace ACPI
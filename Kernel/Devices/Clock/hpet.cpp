@@ -0,0 +1,255 @@
+/**
+ * @file hpet.cpp
+ * @author Keeton Feavel (keeton@xyr.is)
+ * @brief High Precision Event Timer driver. The main counter is used as a
+ * clock source and the comparators as one-shot or periodic event sources.
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @copyright Copyright the Xyris Contributors (c) 2026
+ *
+ */
+#include <Arch/Arch.hpp>
+#include <Arch/Memory.hpp>
+#include <Devices/ACPI/acpi.hpp>
+#include <Devices/Clock/hpet.hpp>
+#include <Memory/paging.hpp>
+#include <Logger.hpp>
+#include <x86gprintrin.h>   // needed for __rdtsc
+
+#define HPET_REG_CAPABILITIES   0x000
+#define HPET_REG_CONFIG         0x010
+#define HPET_REG_INT_STATUS     0x020
+#define HPET_REG_COUNTER        0x0F0
+#define HPET_REG_TIMER_CONFIG(n)        (0x100 + 0x20 * (n))
+#define HPET_REG_TIMER_COMPARATOR(n)    (0x108 + 0x20 * (n))
+
+#define HPET_CAP_COUNTER_64     (1 << 13)
+#define HPET_CAP_TIMERS(c)      ((((c) >> 8) & 0x1F) + 1)
+#define HPET_CONFIG_ENABLE      (1 << 0)
+#define HPET_CONFIG_LEGACY      (1 << 1)
+
+#define HPET_TIMER_LEVEL        (1 << 1)
+#define HPET_TIMER_INT_ENABLE   (1 << 2)
+#define HPET_TIMER_PERIODIC     (1 << 3)
+#define HPET_TIMER_PERIODIC_CAP (1 << 4)
+#define HPET_TIMER_VALUE_SET    (1 << 6)
+#define HPET_TIMER_32BIT        (1 << 8)
+#define HPET_TIMER_ROUTE_MASK   (0x1F << 9)
+
+#define HPET_MAX_COMPARATORS    32
+#define HPET_READ_SAMPLES       1000
+#define HPET_FS_PER_NS          1000000
+
+// Without an I/O APIC the only routing the PIC can receive is legacy
+// replacement, where comparator 0 drives IRQ 0 (in place of the PIT) and
+// comparator 1 drives IRQ 8 (in place of the RTC)
+#define HPET_LEGACY_COMPARATORS 2
+
+namespace HPET {
+
+struct Comparator {
+    EventCallback callback;
+    uint8_t irq;
+    bool periodic;
+    bool active;
+};
+
+static volatile uint8_t* registers = NULL;
+static uint32_t tickPeriod = 0;
+static bool counter64 = false;
+static size_t comparators = 0;
+static uint64_t readCycles = 0;
+static struct Comparator events[HPET_MAX_COMPARATORS];
+static const uint8_t legacyIrqs[HPET_LEGACY_COMPARATORS] = { 0, 8 };
+
+static uint32_t readRegister(size_t offset)
+{
+    return *(volatile uint32_t*)(registers + offset);
+}
+
+static void writeRegister(size_t offset, uint32_t value)
+{
+    *(volatile uint32_t*)(registers + offset) = value;
+}
+
+static uint64_t ticksFromNanoseconds(uint64_t ns)
+{
+    return (ns / tickPeriod) * HPET_FS_PER_NS + (ns % tickPeriod) * HPET_FS_PER_NS / tickPeriod;
+}
+
+static void interruptCallback(struct registers* regs)
+{
+    uint8_t irq = (uint8_t)(regs->int_num - Interrupts::INTERRUPT_0);
+    for (size_t i = 0; i < comparators; i++) {
+        struct Comparator* event = &events[i];
+        if (!event->active || event->irq != irq) {
+            continue;
+        }
+
+        if (!event->periodic) {
+            eventStop(i);
+        }
+        event->callback();
+    }
+}
+
+void init()
+{
+    const struct ACPI::HPETTable* table = ACPI::hpet();
+    if (!table || table->address.addressSpace != ACPI_ADDRESS_SPACE_MEMORY) {
+        Logger::Debug(__func__, "No HPET found");
+        return;
+    }
+
+    uintptr_t base = (uintptr_t)table->address.address;
+    Memory::mapKernelRangeVirtual(Memory::Section(Arch::Memory::pageAlign(base), ARCH_PAGE_SIZE));
+    registers = (volatile uint8_t*)base;
+
+    uint32_t capabilities = readRegister(HPET_REG_CAPABILITIES);
+    tickPeriod = readRegister(HPET_REG_CAPABILITIES + 4);
+    // The period must be non-zero and at most 100 ns
+    if (!tickPeriod || tickPeriod > 100 * HPET_FS_PER_NS) {
+        Logger::Warning(__func__, "Invalid HPET period (%lu fs)", tickPeriod);
+        registers = NULL;
+        return;
+    }
+
+    counter64 = capabilities & HPET_CAP_COUNTER_64;
+    comparators = HPET_CAP_TIMERS(capabilities);
+    if (comparators > HPET_MAX_COMPARATORS) {
+        comparators = HPET_MAX_COMPARATORS;
+    }
+
+    // Start from a known state with every comparator disabled
+    writeRegister(HPET_REG_CONFIG, 0);
+    for (size_t i = 0; i < comparators; i++) {
+        writeRegister(HPET_REG_TIMER_CONFIG(i), readRegister(HPET_REG_TIMER_CONFIG(i)) & ~(uint32_t)HPET_TIMER_INT_ENABLE);
+    }
+    writeRegister(HPET_REG_COUNTER, 0);
+    writeRegister(HPET_REG_COUNTER + 4, 0);
+    writeRegister(HPET_REG_CONFIG, HPET_CONFIG_ENABLE);
+
+    uint64_t start = __rdtsc();
+    for (size_t i = 0; i < HPET_READ_SAMPLES; i++) {
+        (void)counter();
+    }
+    readCycles = (__rdtsc() - start) / HPET_READ_SAMPLES;
+
+    Logger::Info(
+        __func__,
+        "HPET at 0x%08lX: %zu comparators, %s counter, %lu fs resolution, %llu cycle reads",
+        base,
+        comparators,
+        counter64 ? "64-bit" : "32-bit",
+        tickPeriod,
+        readCycles);
+}
+
+bool isPresent()
+{
+    return registers != NULL;
+}
+
+uint64_t counter()
+{
+    if (!registers) {
+        return 0;
+    }
+
+    if (!counter64) {
+        return readRegister(HPET_REG_COUNTER);
+    }
+
+    // Two 32-bit reads. Retry if the low half carried into the high half in between.
+    uint32_t high, low;
+    do {
+        high = readRegister(HPET_REG_COUNTER + 4);
+        low = readRegister(HPET_REG_COUNTER);
+    } while (high != readRegister(HPET_REG_COUNTER + 4));
+
+    return ((uint64_t)high << 32) | low;
+}
+
+uint64_t nanoseconds()
+{
+    uint64_t ticks = counter();
+    return (ticks / HPET_FS_PER_NS) * tickPeriod + (ticks % HPET_FS_PER_NS) * tickPeriod / HPET_FS_PER_NS;
+}
+
+uint32_t period()
+{
+    return tickPeriod;
+}
+
+uint64_t frequency()
+{
+    return tickPeriod ? 1000000000000000ULL / tickPeriod : 0;
+}
+
+uint64_t readCost()
+{
+    return readCycles;
+}
+
+size_t comparatorCount()
+{
+    return comparators;
+}
+
+bool eventStart(size_t comparator, uint64_t ns, bool periodic, EventCallback callback)
+{
+    if (!registers || comparator >= comparators || comparator >= HPET_LEGACY_COMPARATORS || !callback) {
+        return false;
+    }
+
+    uint32_t config = readRegister(HPET_REG_TIMER_CONFIG(comparator));
+    if (periodic && !(config & HPET_TIMER_PERIODIC_CAP)) {
+        return false;
+    }
+
+    // Comparators run in 32-bit mode, which limits a single interval to 2^32 ticks
+    uint64_t ticks = ticksFromNanoseconds(ns);
+    if (!ticks || ticks > UINT32_MAX) {
+        return false;
+    }
+
+    uint8_t irq = legacyIrqs[comparator];
+    // Legacy routed interrupts are edge triggered
+    config &= ~(uint32_t)(HPET_TIMER_ROUTE_MASK | HPET_TIMER_PERIODIC | HPET_TIMER_LEVEL);
+    config |= HPET_TIMER_32BIT;
+    Arch::CPU::criticalRegionNestable([&]() {
+        // Takes the line over from the PIT or RTC handler
+        events[comparator] = { callback, irq, periodic, true };
+        Interrupts::registerHandler((uint8_t)(Interrupts::INTERRUPT_0 + irq), interruptCallback);
+        writeRegister(HPET_REG_CONFIG, readRegister(HPET_REG_CONFIG) | HPET_CONFIG_LEGACY);
+
+        uint32_t now = readRegister(HPET_REG_COUNTER);
+        if (periodic) {
+            // The first write sets the comparator, the second sets the period
+            writeRegister(HPET_REG_TIMER_CONFIG(comparator), config | HPET_TIMER_PERIODIC | HPET_TIMER_VALUE_SET);
+            writeRegister(HPET_REG_TIMER_COMPARATOR(comparator), now + (uint32_t)ticks);
+            writeRegister(HPET_REG_TIMER_COMPARATOR(comparator), (uint32_t)ticks);
+            config |= HPET_TIMER_PERIODIC;
+        } else {
+            writeRegister(HPET_REG_TIMER_CONFIG(comparator), config);
+            writeRegister(HPET_REG_TIMER_COMPARATOR(comparator), now + (uint32_t)ticks);
+        }
+        writeRegister(HPET_REG_TIMER_CONFIG(comparator), config | HPET_TIMER_INT_ENABLE);
+    });
+
+    return true;
+}
+
+void eventStop(size_t comparator)
+{
+    if (!registers || comparator >= comparators) {
+        return;
+    }
+
+    uint32_t config = readRegister(HPET_REG_TIMER_CONFIG(comparator));
+    writeRegister(HPET_REG_TIMER_CONFIG(comparator), config & ~(uint32_t)HPET_TIMER_INT_ENABLE);
+    events[comparator].active = false;
+}
+
+} // !namespace HPET
@@ -0,0 +1,97 @@
+/**
+ * @file hpet.hpp
+ * @author Keeton Feavel (keeton@xyr.is)
+ * @brief High Precision Event Timer driver. The main counter is used as a
+ * clock source and the comparators as one-shot or periodic event sources.
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @copyright Copyright the Xyris Contributors (c) 2026
+ *
+ * References:
+ *         https://www.intel.com/content/dam/www/public/us/en/documents/technical-specifications/software-developers-hpet-spec-1-0a.pdf
+ */
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+
+namespace HPET {
+
+/**
+ * @brief Called from interrupt context when a comparator fires.
+ *
+ */
+typedef void (*EventCallback)();
+
+/**
+ * @brief Locate the HPET through ACPI and start its main counter. Must be
+ * called after `ACPI::init()`.
+ *
+ */
+void init();
+
+/**
+ * @brief Check whether an HPET was found and enabled.
+ *
+ */
+bool isPresent();
+
+/**
+ * @brief Read the main counter.
+ *
+ */
+uint64_t counter();
+
+/**
+ * @brief Main counter converted to nanoseconds.
+ *
+ */
+uint64_t nanoseconds();
+
+/**
+ * @brief Length of one main counter tick in femtoseconds (the resolution).
+ *
+ */
+uint32_t period();
+
+/**
+ * @brief Main counter frequency in Hz.
+ *
+ */
+uint64_t frequency();
+
+/**
+ * @brief Average cost of reading the main counter, in TSC cycles.
+ *
+ */
+uint64_t readCost();
+
+/**
+ * @brief Number of comparators (event timers).
+ *
+ */
+size_t comparatorCount();
+
+/**
+ * @brief Arm a comparator. Comparators are routed with legacy replacement,
+ * so only comparator 0 (which takes over IRQ 0 from the PIT) and comparator
+ * 1 (which takes over IRQ 8 from the RTC) are usable. Once a comparator is
+ * armed the PIT and RTC no longer interrupt the CPU.
+ *
+ * @param comparator Comparator index
+ * @param ns Time until the event (and the period of periodic events)
+ * @param periodic Fire repeatedly rather than once
+ * @param callback Called when the event fires
+ * @return true Comparator was armed
+ * @return false Comparator does not exist, is not 0 or 1, or does not support periodic mode
+ */
+bool eventStart(size_t comparator, uint64_t ns, bool periodic, EventCallback callback);
+
+/**
+ * @brief Disarm a comparator.
+ *
+ * @param comparator Comparator index
+ */
+void eventStop(size_t comparator);
+
+} // !namespace HPET
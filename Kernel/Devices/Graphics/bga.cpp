@@ -0,0 +1,117 @@
+/**
+ * @file bga.cpp
+ * @author Keeton Feavel (keeton@xyr.is)
+ * @brief Bochs Graphics Adapter (QEMU `-vga std`) driver. Sets display modes
+ * at runtime and pans the display across a virtual framebuffer taller than
+ * the screen.
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @copyright Copyright the Xyris Contributors (c) 2026
+ *
+ */
+#include <Arch/Arch.hpp>
+#include <Devices/Graphics/bga.hpp>
+#include <Devices/PCI/pci.hpp>
+
+#define BGA_PORT_INDEX  0x01CE
+#define BGA_PORT_DATA   0x01CF
+
+#define BGA_INDEX_ID            0x0
+#define BGA_INDEX_XRES          0x1
+#define BGA_INDEX_YRES          0x2
+#define BGA_INDEX_BPP           0x3
+#define BGA_INDEX_ENABLE        0x4
+#define BGA_INDEX_BANK          0x5
+#define BGA_INDEX_VIRT_WIDTH    0x6
+#define BGA_INDEX_VIRT_HEIGHT   0x7
+#define BGA_INDEX_X_OFFSET      0x8
+#define BGA_INDEX_Y_OFFSET      0x9
+#define BGA_INDEX_VIDEO_MEMORY  0xA // In 64 KiB units
+
+#define BGA_ID_MIN  0xB0C2          // First version with virtual height and 32 bpp
+#define BGA_ID_MAX  0xB0C5
+
+#define BGA_ENABLED         0x01
+#define BGA_LFB_ENABLED     0x40
+#define BGA_NO_CLEAR_MEM    0x80
+
+#define BGA_PCI_VENDOR  0x1234
+#define BGA_PCI_DEVICE  0x1111
+
+namespace Graphics::BGA {
+
+static uint16_t readRegister(uint16_t index)
+{
+    writeWord(BGA_PORT_INDEX, index);
+    return readWord(BGA_PORT_DATA);
+}
+
+static void writeRegister(uint16_t index, uint16_t value)
+{
+    writeWord(BGA_PORT_INDEX, index);
+    writeWord(BGA_PORT_DATA, value);
+}
+
+bool isPresent()
+{
+    uint16_t id = readRegister(BGA_INDEX_ID);
+    return id >= BGA_ID_MIN && id <= BGA_ID_MAX;
+}
+
+bool setMode(uint16_t width, uint16_t height, uint16_t depth, uint16_t virtualHeight)
+{
+    if (!isPresent() || virtualHeight < height) {
+        return false;
+    }
+
+    // Mode registers may only be changed while the display is disabled
+    writeRegister(BGA_INDEX_ENABLE, 0);
+    writeRegister(BGA_INDEX_XRES, width);
+    writeRegister(BGA_INDEX_YRES, height);
+    writeRegister(BGA_INDEX_BPP, depth);
+    writeRegister(BGA_INDEX_ENABLE, BGA_ENABLED | BGA_LFB_ENABLED);
+    // The adapter clamps the virtual size to what fits in video memory
+    writeRegister(BGA_INDEX_VIRT_WIDTH, width);
+    writeRegister(BGA_INDEX_VIRT_HEIGHT, virtualHeight);
+    setOffset(0, 0);
+
+    return readRegister(BGA_INDEX_XRES) == width
+        && readRegister(BGA_INDEX_YRES) == height
+        && readRegister(BGA_INDEX_BPP) == depth
+        && readRegister(BGA_INDEX_VIRT_HEIGHT) == virtualHeight;
+}
+
+void setOffset(uint16_t x, uint16_t y)
+{
+    writeRegister(BGA_INDEX_X_OFFSET, x);
+    writeRegister(BGA_INDEX_Y_OFFSET, y);
+}
+
+uint16_t virtualWidth()
+{
+    return readRegister(BGA_INDEX_VIRT_WIDTH);
+}
+
+uint16_t virtualHeight()
+{
+    return readRegister(BGA_INDEX_VIRT_HEIGHT);
+}
+
+uintptr_t framebufferAddress()
+{
+    PCI::Device* dev = PCI::find(BGA_PCI_VENDOR, BGA_PCI_DEVICE);
+    PCI::Bar bar;
+    if (!dev || !PCI::readBar(dev, 0, bar) || bar.isIO) {
+        return 0;
+    }
+
+    return (uintptr_t)bar.address;
+}
+
+size_t videoMemory()
+{
+    return (size_t)readRegister(BGA_INDEX_VIDEO_MEMORY) * 64 * 1024;
+}
+
+} // !namespace Graphics::BGA
@@ -0,0 +1,74 @@
+/**
+ * @file bga.hpp
+ * @author Keeton Feavel (keeton@xyr.is)
+ * @brief Bochs Graphics Adapter (QEMU `-vga std`) driver. Sets display modes
+ * at runtime and pans the display across a virtual framebuffer taller than
+ * the screen.
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @copyright Copyright the Xyris Contributors (c) 2026
+ *
+ * References:
+ *         https://wiki.osdev.org/Bochs_VBE_Extensions
+ */
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+
+namespace Graphics::BGA {
+
+/**
+ * @brief Check whether a Bochs Graphics Adapter is present.
+ *
+ */
+bool isPresent();
+
+/**
+ * @brief Set the display mode. The linear framebuffer stays enabled and its
+ * address does not change.
+ *
+ * @param width Horizontal resolution
+ * @param height Vertical resolution
+ * @param depth Bits per pixel
+ * @param virtualHeight Lines of video memory available for panning (at least `height`)
+ * @return true Mode (and the full virtual height) was set
+ * @return false Mode is not supported or video memory is too small
+ */
+bool setMode(uint16_t width, uint16_t height, uint16_t depth, uint16_t virtualHeight);
+
+/**
+ * @brief Pan the display so the given virtual framebuffer pixel is shown
+ * in the top left corner.
+ *
+ * @param x Horizontal offset
+ * @param y Vertical offset
+ */
+void setOffset(uint16_t x, uint16_t y);
+
+/**
+ * @brief Width of the virtual framebuffer in pixels.
+ *
+ */
+uint16_t virtualWidth();
+
+/**
+ * @brief Height of the virtual framebuffer in lines.
+ *
+ */
+uint16_t virtualHeight();
+
+/**
+ * @brief Physical address of the linear framebuffer (PCI BAR 0).
+ *
+ * @return uintptr_t Address or 0 if the adapter was not found on the PCI bus
+ */
+uintptr_t framebufferAddress();
+
+/**
+ * @brief Size of the adapter's video memory in bytes.
+ *
+ */
+size_t videoMemory();
+
+} // !namespace Graphics::BGA
@@ -0,0 +1,174 @@
+/**
+ * @file capture.cpp
+ * @author Keeton Feavel (keeton@xyr.is)
+ * @brief Screen capture over the serial console
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @copyright Copyright the Xyris Contributors (c) 2026
+ *
+ */
+#include <Devices/Graphics/capture.hpp>
+#include <Devices/Graphics/framebuffer.hpp>
+#include <Devices/Graphics/graphics.hpp>
+#include <Devices/Serial/dump.hpp>
+#include <Bootloader/Arguments.hpp>
+#include <Library/crc32.hpp>
+#include <Library/string.hpp>
+#include <Locking/Mutex.hpp>
+#include <Locking/RAII.hpp>
+#include <Scheduler/tasks.hpp>
+#include <Logger.hpp>
+#include <Metrics.hpp>
+
+namespace Graphics::Capture {
+
+static Mutex captureLock("capture");
+static bool enabled = false;
+// a CRC-32 of every tile as last sent, which is all that is needed to tell
+// whether a tile changed without keeping a copy of the whole frame
+static uint32_t* previous = NULL;
+static size_t previousTiles = 0;
+static uint32_t previousWidth = 0;
+static uint32_t previousHeight = 0;
+static uint32_t sequence = 0;
+
+static void put16(uint8_t* dst, uint16_t value)
+{
+    dst[0] = (uint8_t)value;
+    dst[1] = (uint8_t)(value >> 8);
+}
+
+static void put32(uint8_t* dst, uint32_t value)
+{
+    put16(dst, (uint16_t)value);
+    put16(dst + 2, (uint16_t)(value >> 16));
+}
+
+static bool resize(uint32_t width, uint32_t height, size_t tiles)
+{
+    if (tiles != previousTiles) {
+        delete[] previous;
+        previous = new uint32_t[tiles];
+        previousTiles = previous ? tiles : 0;
+        if (!previous) {
+            return false;
+        }
+    }
+
+    previousWidth = width;
+    previousHeight = height;
+    return true;
+}
+
+bool frame(bool full)
+{
+    RAIIMutex lock(captureLock);
+    Framebuffer* fb = getFramebuffer();
+    const uint8_t* pixels = frontbuffer();
+    if (!fb || !pixels) {
+        return false;
+    }
+
+    uint32_t width = fb->getWidth();
+    uint32_t height = fb->getHeight();
+    uint32_t pitch = fb->getPitch();
+    uint8_t pixelWidth = fb->getPixelWidth();
+    uint32_t columns = (width + CAPTURE_TILE_SIZE - 1) / CAPTURE_TILE_SIZE;
+    uint32_t rows = (height + CAPTURE_TILE_SIZE - 1) / CAPTURE_TILE_SIZE;
+    static uint8_t dirty[(4096 / CAPTURE_TILE_SIZE) * (4096 / CAPTURE_TILE_SIZE) / 8];
+    if (columns * rows > sizeof(dirty) * 8) {
+        return false;
+    }
+    if (width != previousWidth || height != previousHeight || previous == NULL) {
+        // a new mode, nothing can be compared with the last frame
+        if (!resize(width, height, columns * rows)) {
+            Logger::Warning(__func__, "Unable to allocate checksums for %lu tiles", columns * rows);
+            return false;
+        }
+        full = true;
+    }
+
+    uint32_t tiles = 0;
+    // the tile count goes in the header, so find the dirty tiles first
+    memset(dirty, 0, sizeof(dirty));
+    for (uint32_t row = 0; row < rows; row++) {
+        for (uint32_t column = 0; column < columns; column++) {
+            uint32_t x = column * CAPTURE_TILE_SIZE;
+            uint32_t y = row * CAPTURE_TILE_SIZE;
+            uint32_t tileBytes = (width - x < CAPTURE_TILE_SIZE ? width - x : CAPTURE_TILE_SIZE) * pixelWidth;
+            uint32_t tileRows = height - y < CAPTURE_TILE_SIZE ? height - y : CAPTURE_TILE_SIZE;
+            uint32_t crc = 0;
+            for (uint32_t line = y; line < y + tileRows; line++) {
+                crc = crc32(pixels + line * pitch + x * pixelWidth, tileBytes, crc);
+            }
+            uint32_t idx = row * columns + column;
+            if (full || crc != previous[idx]) {
+                previous[idx] = crc;
+                dirty[idx / 8] |= (uint8_t)(1 << (idx % 8));
+                tiles++;
+            }
+        }
+    }
+
+    RS232::Dump out(true);
+    uint8_t header[CAPTURE_HEADER_SIZE] = { 'X', 'C', 'A', 'P' };
+    put16(header + 4, CAPTURE_VERSION);
+    put16(header + 6, CAPTURE_TILE_SIZE);
+    put32(header + 8, width);
+    put32(header + 12, height);
+    header[16] = pixelWidth;
+    header[17] = full;
+    put32(header + 20, sequence++);
+    uint64_t now = tasks_get_time_ns();
+    put32(header + 24, (uint32_t)now);
+    put32(header + 28, (uint32_t)(now >> 32));
+    put32(header + 32, tiles);
+    out.write(header, sizeof(header));
+
+    // tiles are sent straight from the screen. Anything drawn since they were
+    // checksummed no longer matches the checksum, so it is sent next time.
+    for (uint32_t idx = 0; idx < columns * rows; idx++) {
+        if (!(dirty[idx / 8] & (1 << (idx % 8)))) {
+            continue;
+        }
+        uint32_t column = idx % columns;
+        uint32_t row = idx / columns;
+        uint32_t x = column * CAPTURE_TILE_SIZE;
+        uint32_t y = row * CAPTURE_TILE_SIZE;
+        uint32_t tileBytes = (width - x < CAPTURE_TILE_SIZE ? width - x : CAPTURE_TILE_SIZE) * pixelWidth;
+        uint32_t tileRows = height - y < CAPTURE_TILE_SIZE ? height - y : CAPTURE_TILE_SIZE;
+        uint8_t position[4];
+        put16(position, (uint16_t)column);
+        put16(position + 2, (uint16_t)row);
+        out.write(position, sizeof(position));
+        for (uint32_t line = y; line < y + tileRows; line++) {
+            out.write(pixels + line * pitch + x * pixelWidth, tileBytes);
+        }
+    }
+
+    return true;
+}
+
+bool recording()
+{
+    return enabled;
+}
+
+// Kernel argument callback
+static void argumentCallback(const char* arg)
+{
+    (void)arg;
+    enabled = true;
+}
+
+// Serial command callback. A screenshot, with every tile on 'C'.
+static void commandCallback(char command)
+{
+    frame(command == 'C');
+}
+
+KERNEL_PARAM(captureArg, "--capture", argumentCallback);
+SERIAL_COMMAND(captureCommand, 'c', commandCallback);
+
+} // !namespace Graphics::Capture
@@ -0,0 +1,53 @@
+/**
+ * @file capture.hpp
+ * @author Keeton Feavel (keeton@xyr.is)
+ * @brief Screen capture over the serial console. Only the tiles that changed
+ * since the last capture are sent, so recording a sequence of frames costs
+ * little more than the parts of the screen that move.
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @copyright Copyright the Xyris Contributors (c) 2026
+ *
+ */
+#pragma once
+
+#include <stdint.h>
+
+#define CAPTURE_TILE_SIZE   32  // Tiles are square, the last row and column may be cut short
+#define CAPTURE_VERSION     1
+
+/*
+ * A capture is sent as one LZ4 frame (see lz4.hpp) containing, little endian:
+ *   header:  "XCAP", version (2 bytes), tile size (2 bytes), width (4 bytes),
+ *            height (4 bytes), bytes per pixel (1 byte, pixels are B, G, R),
+ *            full frame flag (1 byte), 2 reserved bytes, sequence number (4 bytes),
+ *            time in nanoseconds (8 bytes), tile count (4 bytes)
+ *   tile:    column (2 bytes), row (2 bytes), then the tile's pixel rows
+ */
+#define CAPTURE_MAGIC       "XCAP"
+#define CAPTURE_HEADER_SIZE 36
+
+namespace Graphics::Capture {
+
+/**
+ * @brief Capture the screen, sending the tiles that changed since the last
+ * capture (or all of them for the first one). Changes are found by comparing
+ * a CRC-32 of each tile. Also sent when 'c' (or 'C' for every tile) is
+ * received over serial. `Meta/capture-png.py` turns the captures in a serial
+ * log into PNG images.
+ *
+ * @param full Send every tile, e.g. when the receiver may have missed captures
+ * @return true The capture was sent
+ * @return false There is no framebuffer or no memory for the tile checksums
+ */
+bool frame(bool full = false);
+
+/**
+ * @brief Whether the kernel was booted with `--capture`, which asks for
+ * animations to be recorded frame by frame.
+ *
+ */
+bool recording();
+
+} // !namespace Graphics::Capture
@@ -15,6 +15,7 @@
 #include <Library/stdio.hpp>
 #include <Locking/Mutex.hpp>
 #include <Logger.hpp>
+#include <Metrics.hpp>
 #include <stddef.h>
 
 namespace Console {
@@ -95,6 +96,8 @@ static uint32_t ansiVGATable[16] = {
 
 static Mutex ttyLock;
 
+METRIC_COUNTER(consoleChars, "console.chars", "chars");
+
 static void Lock()
 {
     ttyLock.lock();
@@ -108,6 +111,7 @@ static void Unlock()
 static int putchar(unsigned c, void** ptr)
 {
     (void)ptr;
+    Metrics::inc(consoleChars);
     // Check the ANSI state
     switch (ansiState) {
     case Normal: // print the character out normally unless it's an ESC
@@ -222,11 +226,10 @@ static int putchar(unsigned c, void** ptr)
         cursorX = 0;
         cursorY++;
     }
-    // Clear the screen
+    // Scroll the screen
     // TODO: Get height of "screen" (replace 25 with height) (#275)
     if (cursorY >= 25) {
-        Logger::Debug(__func__, "Shift up the screen");
-        //TODO: Shift text up and reset the bottom line
+        Graphics::scroll((cursorY - (25 - 1)) * FONT_HEIGHT);
         cursorX = 0;
         cursorY = 25 - 1;
     }
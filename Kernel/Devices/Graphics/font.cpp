@@ -169,6 +169,7 @@ void Draw(char c, uint32_t x, uint32_t y, uint32_t fore)
             }
         }
     }
+    damage(x, y, FONT_WIDTH + 1, FONT_HEIGHT + 1);
 }
 
 void Draw(char c, uint32_t x, uint32_t y, uint32_t fore, uint32_t back)
@@ -189,6 +190,7 @@ void Draw(char c, uint32_t x, uint32_t y, uint32_t fore, uint32_t back)
             }
         }
     }
+    damage(x, y, FONT_WIDTH + 1, FONT_HEIGHT + 1);
 }
 
 } // !font
@@ -11,9 +11,12 @@
  * References:
  *     https://wiki.osdev.org/Double_Buffering
  *     https://github.com/skiftOS/skift/blob/main/kernel/system/Graphics/Graphics.cpp
+ *     https://wiki.osdev.org/Bochs_VBE_Extensions
  *
  */
+#include <Devices/Graphics/bga.hpp>
 #include <Devices/Graphics/graphics.hpp>
+#include <Devices/Virtio/gpu.hpp>
 #include <stddef.h>
 #include <stdint.h>
 #include <Memory/heap.hpp>
@@ -28,6 +31,70 @@ namespace Graphics {
 static Framebuffer* info = NULL;
 static void* backbuffer = NULL;
 static bool initialized = false;
+// When the adapter supports panning, video memory holds a virtual framebuffer
+// twice the screen height. The console draws straight into the lines being
+// shown and scrolls by moving them down the virtual framebuffer, only copying
+// when it reaches the end. Page flipping draws into the half that isn't shown.
+static bool panning = false;
+static uint8_t* videoMemory = NULL;
+static uint32_t virtualHeight = 0;
+static uint32_t drawY = 0;
+static uint32_t displayY = 0;
+// With a virtio GPU the backbuffer is the scanout source itself and only
+// the damaged region is sent to the host on swap.
+static bool scanout = false;
+static uint32_t damageX0 = UINT32_MAX;
+static uint32_t damageY0 = UINT32_MAX;
+static uint32_t damageX1 = 0;
+static uint32_t damageY1 = 0;
+
+static void damageReset()
+{
+    damageX0 = damageY0 = UINT32_MAX;
+    damageX1 = damageY1 = 0;
+}
+
+static void setXRGB(uint16_t depth, uint32_t pitch)
+{
+    info->setDepth(depth);
+    info->setPitch((uint16_t)pitch);
+    info->setRedMaskSize(8);
+    info->setRedMaskShift(16);
+    info->setGreenMaskSize(8);
+    info->setGreenMaskShift(8);
+    info->setBlueMaskSize(8);
+    info->setBlueMaskShift(0);
+    info->setModel(RGB_FBMM);
+}
+
+static bool initPanning(uint32_t width, uint32_t height, uint16_t depth)
+{
+    if (!BGA::isPresent() || (uintptr_t)videoMemory != BGA::framebufferAddress())
+        return false;
+    // Drawing only handles 24 and 32 bit pixels
+    if (depth != 24 && depth != 32)
+        return false;
+    if (!BGA::setMode((uint16_t)width, (uint16_t)height, depth, (uint16_t)(height * 2)))
+        return false;
+
+    info->setWidth((uint16_t)width);
+    info->setHeight((uint16_t)height);
+    setXRGB(depth, BGA::virtualWidth() * (depth / 8));
+
+    virtualHeight = height * 2;
+    memset(videoMemory, 0, info->getPitch() * virtualHeight);
+    displayY = 0;
+    drawY = 0;
+    BGA::setOffset(0, 0);
+    backbuffer = videoMemory;
+    return true;
+}
+
+static void show(uint32_t y)
+{
+    BGA::setOffset(0, (uint16_t)y);
+    displayY = y;
+}
 
 void init(Framebuffer* fb)
 {
@@ -37,25 +104,70 @@ void init(Framebuffer* fb)
     // Ensure valid info is provided
     if (!info->getAddress())
         return;
-    // Map in the framebuffer
+    videoMemory = (uint8_t*)info->getAddress();
+    // Map in the framebuffer (all of video memory if it can be used for panning)
     Logger::Debug(__func__, "==== MAP FRAMEBUFFER ====");
-    Memory::mapKernelRangeVirtual(Memory::Section(
-        (uintptr_t)info->getAddress(),
-        (info->getPitch() * info->getHeight())
-    ));
-    // Alloc the backbuffer
-    backbuffer = malloc(info->getPitch() * info->getHeight());
-    memcpy(backbuffer, info->getAddress(), info->getPitch() * info->getHeight());
+    size_t size = info->getPitch() * info->getHeight();
+    if (BGA::isPresent() && BGA::videoMemory() > size)
+        size = BGA::videoMemory();
+    Memory::mapKernelRangeVirtual(Memory::Section((uintptr_t)videoMemory, size));
+
+    if ((scanout = VirtioGPU::init(info->getWidth(), info->getHeight()))) {
+        setXRGB(32, VirtioGPU::pitch());
+        backbuffer = VirtioGPU::framebuffer();
+    } else if ((panning = initPanning(info->getWidth(), info->getHeight(), info->getDepth()))) {
+        Logger::Info(__func__, "BGA panning enabled (%lux%lux%u)", info->getWidth(), info->getHeight(), info->getDepth());
+        resetDoubleBuffer();
+    } else {
+        // Alloc the backbuffer
+        backbuffer = malloc(info->getPitch() * info->getHeight());
+        memcpy(backbuffer, info->getAddress(), info->getPitch() * info->getHeight());
+    }
 
     initialized = true;
 }
 
+bool setMode(uint32_t width, uint32_t height, uint16_t depth)
+{
+    if (!initialized || !panning)
+        return false;
+    if ((size_t)width * (depth / 8) * height * 2 > BGA::videoMemory())
+        return false;
+    if (!initPanning(width, height, depth)) {
+        // Restore the previous mode
+        initPanning(info->getWidth(), info->getHeight(), info->getDepth());
+        return false;
+    }
+
+    resetDoubleBuffer();
+    return true;
+}
+
+void damage(uint32_t x, uint32_t y, uint32_t w, uint32_t h)
+{
+    if (!initialized)
+        return;
+    if (x < damageX0)
+        damageX0 = x;
+    if (y < damageY0)
+        damageY0 = y;
+    if (x + w > damageX1)
+        damageX1 = x + w;
+    if (y + h > damageY1)
+        damageY1 = y + h;
+    // Keep the region on screen so it can be used without further checks
+    if (damageX1 > info->getWidth())
+        damageX1 = info->getWidth();
+    if (damageY1 > info->getHeight())
+        damageY1 = info->getHeight();
+}
+
 void pixel(uint32_t x, uint32_t y, uint32_t color)
 {
     // Ensure framebuffer information exists
     if (!initialized)
         return;
-    if ((x <= info->getWidth()) && (y <= info->getHeight())) {
+    if ((x < info->getWidth()) && (y < info->getHeight())) {
         // Special thanks to the SkiftOS contributors.
         uint8_t* pixel = (uint8_t*)backbuffer + (y * info->getPitch()) + (x * info->getPixelWidth());
         // Pixel information
@@ -79,8 +191,7 @@ void putrect(uint32_t x, uint32_t y, uint32_t w, uint32_t h, uint32_t color)
             pixel(curr_x, curr_y, color);
         }
     }
-    // Swap after doing a large operation
-    swap();
+    damage(x, y, w + 1, h + 1);
 }
 
 void resetDoubleBuffer()
@@ -88,13 +199,93 @@ void resetDoubleBuffer()
     if (!initialized)
         return;
     memset(backbuffer, 0, (info->getPitch() * info->getHeight()));
+    damage(0, 0, info->getWidth(), info->getHeight());
 }
 
 void swap()
 {
     if (!initialized)
         return;
+    if (panning) {
+        // Drawing already happens in video memory. After a flip the drawn
+        // page is hidden, so show it and keep drawing there.
+        if (drawY != displayY)
+            show(drawY);
+        damageReset();
+        return;
+    }
+    if (scanout) {
+        if (damageX1 > damageX0 && damageY1 > damageY0)
+            VirtioGPU::flush(damageX0, damageY0, damageX1 - damageX0, damageY1 - damageY0);
+        damageReset();
+        return;
+    }
     memcpy(info->getAddress(), backbuffer, (info->getPitch() * info->getHeight()));
 }
 
+void flip()
+{
+    if (!initialized)
+        return;
+    if (!panning) {
+        swap();
+        return;
+    }
+    uint32_t height = info->getHeight();
+    uint32_t pitch = info->getPitch();
+    // Show the page that was just drawn
+    show(drawY);
+    if (displayY != 0 && displayY != height) {
+        // Scrolling left it where no other page fits, so move it to the top
+        memmove(videoMemory, videoMemory + displayY * pitch, height * pitch);
+        show(0);
+    }
+    // and draw the next frame into the other one
+    drawY = (displayY ? 0 : height);
+    backbuffer = videoMemory + drawY * pitch;
+    damageReset();
+}
+
+const uint8_t* frontbuffer()
+{
+    if (!initialized)
+        return NULL;
+    // The page being shown, not the one being drawn into
+    if (panning)
+        return videoMemory + displayY * info->getPitch();
+    // Otherwise the screen is a copy of the backbuffer, which is cheaper to read
+    return (const uint8_t*)backbuffer;
+}
+
+void scroll(uint32_t lines)
+{
+    if (!initialized)
+        return;
+    uint32_t height = info->getHeight();
+    uint32_t pitch = info->getPitch();
+    if (lines >= height) {
+        resetDoubleBuffer();
+        return;
+    }
+
+    if (panning && drawY == displayY) {
+        // Show the lines further down and clear the ones that came into view
+        uint32_t y = displayY + lines;
+        if (y + height > virtualHeight) {
+            // Out of room, so bring the lines that stay back to the top
+            memmove(videoMemory, videoMemory + y * pitch, (height - lines) * pitch);
+            y = 0;
+        }
+        drawY = y;
+        backbuffer = videoMemory + drawY * pitch;
+        memset((uint8_t*)backbuffer + (height - lines) * pitch, 0, lines * pitch);
+        show(drawY);
+        return;
+    }
+
+    memmove(backbuffer, (uint8_t*)backbuffer + lines * pitch, (height - lines) * pitch);
+    memset((uint8_t*)backbuffer + (height - lines) * pitch, 0, lines * pitch);
+    damage(0, 0, info->getWidth(), height);
+}
+
 } // !namespace graphics
@@ -24,7 +24,32 @@ namespace Graphics {
 void init(Framebuffer* fb);
 
 /**
- * @brief Draws a pixel at a given coordinate.
+ * @brief Change the display resolution and depth at runtime. Only supported
+ * by adapters that can pan (Bochs Graphics Adapter). The screen is cleared.
+ *
+ * @param width Horizontal resolution
+ * @param height Vertical resolution
+ * @param depth Bits per pixel (24 or 32)
+ * @return true Mode was changed
+ * @return false Mode is not supported and the current mode is kept
+ */
+bool setMode(uint32_t width, uint32_t height, uint16_t depth);
+
+/**
+ * @brief Mark a region of the backbuffer as drawn. Drawing with `pixel()`
+ * does not track damage itself, so callers report the region they drew
+ * once it is complete. Only damaged regions are sent to a virtio GPU.
+ *
+ * @param x X-axis coordinate
+ * @param y Y-axis coordinate
+ * @param w Width
+ * @param h Height
+ */
+void damage(uint32_t x, uint32_t y, uint32_t w, uint32_t h);
+
+/**
+ * @brief Draws a pixel at a given coordinate. The pixel is not marked as
+ * damaged (see `damage()`).
  *
  * @param x X-axis coordinate
  * @param y Y-axis coordinate
@@ -34,7 +59,7 @@ void pixel(uint32_t x, uint32_t y, uint32_t color);
 
 /**
  * @brief Draws and fills a rectangle of a given width and height, and color
- * at the provided coordinates.
+ * at the provided coordinates. The result is shown on the next swap or flip.
  *
  * @param x X-axis coordinate
  * @param y Y-axis coordinate
@@ -52,9 +77,40 @@ void resetDoubleBuffer();
 
 /**
  * @brief Swap the data on backbuffer to memory video buffer
- * and show in the screen.
+ * and show in the screen. When the display can pan, drawing already goes to
+ * video memory and nothing is copied (after a flip the drawn page is shown
+ * and drawing continues there). With a virtio GPU only the region drawn
+ * since the last swap is sent to the host.
  *
  */
 void swap();
 
+/**
+ * @brief Show the frame drawn since the last flip and start drawing the
+ * next frame into a hidden page, so a frame is never seen half drawn. When
+ * the display can pan this only changes which half of video memory is shown,
+ * so the new frame must be drawn in full. Otherwise it is the same as `swap()`.
+ *
+ */
+void flip();
+
+/**
+ * @brief Scroll the backbuffer contents up, clearing the lines at the bottom.
+ * The result is shown on the next swap. When the display can pan (and isn't
+ * flipping pages) this moves the displayed lines down video memory instead,
+ * which is shown immediately and only copies once the end is reached.
+ *
+ * @param lines Number of pixel lines to scroll
+ */
+void scroll(uint32_t lines);
+
+/**
+ * @brief Get the pixels currently being displayed, laid out as described by
+ * the framebuffer (`getFramebuffer()`). Read from RAM where possible since
+ * video memory is slow to read.
+ *
+ * @return const uint8_t* Displayed pixels, or NULL if there is no framebuffer
+ */
+const uint8_t* frontbuffer();
+
 }; // !namespace graphics
@@ -0,0 +1,232 @@
+/**
+ * @file pci.cpp
+ * @author Keeton Feavel (keeton@xyr.is)
+ * @brief Peripheral Component Interconnect (PCI) bus enumeration and
+ * configuration space access using the legacy 0xCF8/0xCFC mechanism.
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @copyright Copyright the Xyris Contributors (c) 2026
+ *
+ */
+#include <Arch/Arch.hpp>
+#include <Devices/PCI/pci.hpp>
+#include <Logger.hpp>
+
+#define PCI_CONFIG_ADDRESS_PORT 0xCF8
+#define PCI_CONFIG_DATA_PORT    0xCFC
+#define PCI_CONFIG_ENABLE       (1UL << 31)
+
+#define PCI_BUS_COUNT           256
+#define PCI_SLOT_COUNT          32
+#define PCI_FUNCTION_COUNT      8
+
+#define PCI_HEADER_MULTIFUNCTION 0x80
+#define PCI_HEADER_TYPE_MASK     0x7F
+#define PCI_VENDOR_NONE          0xFFFF
+
+#define PCI_BAR_IO               0x1
+#define PCI_BAR_TYPE_MASK        0x6
+#define PCI_BAR_TYPE_64          0x4
+
+namespace PCI {
+
+static Device devices[PCI_MAX_DEVICES];
+static size_t deviceCount = 0;
+
+static uint32_t configAddress(uint8_t bus, uint8_t slot, uint8_t function, uint8_t offset)
+{
+    return PCI_CONFIG_ENABLE
+        | ((uint32_t)bus << 16)
+        | ((uint32_t)slot << 11)
+        | ((uint32_t)function << 8)
+        | (offset & 0xFC);
+}
+
+static uint32_t configRead(uint8_t bus, uint8_t slot, uint8_t function, uint8_t offset)
+{
+    ::writeLong(PCI_CONFIG_ADDRESS_PORT, configAddress(bus, slot, function, offset));
+    return ::readLong(PCI_CONFIG_DATA_PORT);
+}
+
+static void configWrite(uint8_t bus, uint8_t slot, uint8_t function, uint8_t offset, uint32_t value)
+{
+    ::writeLong(PCI_CONFIG_ADDRESS_PORT, configAddress(bus, slot, function, offset));
+    ::writeLong(PCI_CONFIG_DATA_PORT, value);
+}
+
+uint32_t readConfigLong(Device* dev, uint8_t offset)
+{
+    return configRead(dev->bus, dev->slot, dev->function, offset);
+}
+
+uint16_t readConfigWord(Device* dev, uint8_t offset)
+{
+    return (uint16_t)(readConfigLong(dev, offset) >> ((offset & 2) * 8));
+}
+
+uint8_t readConfigByte(Device* dev, uint8_t offset)
+{
+    return (uint8_t)(readConfigLong(dev, offset) >> ((offset & 3) * 8));
+}
+
+void writeConfigLong(Device* dev, uint8_t offset, uint32_t value)
+{
+    configWrite(dev->bus, dev->slot, dev->function, offset, value);
+}
+
+// Narrow writes use a narrow access to the data port so the rest of the
+// dword isn't written back (the status register's error bits are cleared by
+// writing 1s to them)
+void writeConfigWord(Device* dev, uint8_t offset, uint16_t value)
+{
+    ::writeLong(PCI_CONFIG_ADDRESS_PORT, configAddress(dev->bus, dev->slot, dev->function, offset));
+    ::writeWord((uint16_t)(PCI_CONFIG_DATA_PORT + (offset & 2)), value);
+}
+
+void writeConfigByte(Device* dev, uint8_t offset, uint8_t value)
+{
+    ::writeLong(PCI_CONFIG_ADDRESS_PORT, configAddress(dev->bus, dev->slot, dev->function, offset));
+    ::writeByte((uint16_t)(PCI_CONFIG_DATA_PORT + (offset & 3)), value);
+}
+
+static void probeFunction(uint8_t bus, uint8_t slot, uint8_t function)
+{
+    uint32_t id = configRead(bus, slot, function, PCI_CONFIG_VENDOR_ID);
+    if ((id & 0xFFFF) == PCI_VENDOR_NONE) {
+        return;
+    }
+
+    if (deviceCount >= PCI_MAX_DEVICES) {
+        Logger::Warning(__func__, "Too many PCI devices. Ignoring %02X:%02X.%X", bus, slot, function);
+        return;
+    }
+
+    Device* dev = &devices[deviceCount++];
+    dev->bus = bus;
+    dev->slot = slot;
+    dev->function = function;
+    dev->vendorId = (uint16_t)(id & 0xFFFF);
+    dev->deviceId = (uint16_t)(id >> 16);
+    dev->headerType = readConfigByte(dev, PCI_CONFIG_HEADER_TYPE);
+    dev->classCode = readConfigByte(dev, PCI_CONFIG_CLASS);
+    dev->subclass = readConfigByte(dev, PCI_CONFIG_SUBCLASS);
+    dev->progIf = readConfigByte(dev, PCI_CONFIG_PROG_IF);
+    dev->interruptLine = readConfigByte(dev, PCI_CONFIG_INTERRUPT_LINE);
+
+    Logger::Debug(
+        __func__,
+        "%02X:%02X.%X [%04X:%04X] class %02X:%02X IRQ %u",
+        bus, slot, function,
+        dev->vendorId, dev->deviceId,
+        dev->classCode, dev->subclass,
+        dev->interruptLine);
+}
+
+void init()
+{
+    deviceCount = 0;
+    for (size_t bus = 0; bus < PCI_BUS_COUNT; bus++) {
+        for (uint8_t slot = 0; slot < PCI_SLOT_COUNT; slot++) {
+            uint32_t id = configRead((uint8_t)bus, slot, 0, PCI_CONFIG_VENDOR_ID);
+            if ((id & 0xFFFF) == PCI_VENDOR_NONE) {
+                continue;
+            }
+
+            uint8_t header = (uint8_t)(configRead((uint8_t)bus, slot, 0, PCI_CONFIG_HEADER_TYPE & 0xFC) >> 16);
+            uint8_t functions = (header & PCI_HEADER_MULTIFUNCTION) ? PCI_FUNCTION_COUNT : 1;
+            for (uint8_t function = 0; function < functions; function++) {
+                probeFunction((uint8_t)bus, slot, function);
+            }
+        }
+    }
+
+    Logger::Info(__func__, "Found %zu PCI devices", deviceCount);
+}
+
+Device* find(uint16_t vendorId, uint16_t deviceId, size_t index)
+{
+    for (size_t i = 0; i < deviceCount; i++) {
+        if (devices[i].vendorId == vendorId && devices[i].deviceId == deviceId) {
+            if (index-- == 0) {
+                return &devices[i];
+            }
+        }
+    }
+
+    return NULL;
+}
+
+bool readBar(Device* dev, uint8_t index, Bar& bar)
+{
+    if (index >= PCI_MAX_BARS || (dev->headerType & PCI_HEADER_TYPE_MASK) != 0) {
+        return false;
+    }
+
+    uint8_t offset = (uint8_t)(PCI_CONFIG_BAR0 + index * sizeof(uint32_t));
+    uint32_t low = readConfigLong(dev, offset);
+
+    // Probe the size by writing all ones and reading back the writable bits.
+    // Decoding is disabled while probing so the device does not respond at a bogus address.
+    uint16_t command = readConfigWord(dev, PCI_CONFIG_COMMAND);
+    writeConfigWord(dev, PCI_CONFIG_COMMAND, command & ~(PCI_COMMAND_IO_SPACE | PCI_COMMAND_MEMORY_SPACE));
+    writeConfigLong(dev, offset, 0xFFFFFFFF);
+    uint32_t mask = readConfigLong(dev, offset);
+    writeConfigLong(dev, offset, low);
+    writeConfigWord(dev, PCI_CONFIG_COMMAND, command);
+
+    if (mask == 0 || mask == 0xFFFFFFFF) {
+        return false;
+    }
+
+    if (low & PCI_BAR_IO) {
+        bar.isIO = true;
+        bar.is64Bit = false;
+        bar.address = low & ~0x3UL;
+        bar.size = ~(mask & ~0x3UL) + 1;
+        bar.size &= 0xFFFF;
+        return true;
+    }
+
+    bar.isIO = false;
+    bar.is64Bit = (low & PCI_BAR_TYPE_MASK) == PCI_BAR_TYPE_64;
+    bar.address = low & ~0xFUL;
+    bar.size = ~(mask & ~0xFUL) + 1;
+    if (bar.is64Bit && index + 1 < PCI_MAX_BARS) {
+        uint64_t high = readConfigLong(dev, (uint8_t)(offset + sizeof(uint32_t)));
+        bar.address |= high << 32;
+    }
+
+    return true;
+}
+
+void enableBusMastering(Device* dev)
+{
+    uint16_t command = readConfigWord(dev, PCI_CONFIG_COMMAND);
+    command |= PCI_COMMAND_IO_SPACE | PCI_COMMAND_MEMORY_SPACE | PCI_COMMAND_BUS_MASTER;
+    command &= ~PCI_COMMAND_INTX_DISABLE;
+    writeConfigWord(dev, PCI_CONFIG_COMMAND, command);
+}
+
+uint8_t findCapability(Device* dev, uint8_t id, uint8_t start)
+{
+    if (!(readConfigWord(dev, PCI_CONFIG_STATUS) & PCI_STATUS_CAPABILITIES)) {
+        return 0;
+    }
+
+    uint8_t offset = start
+        ? readConfigByte(dev, (uint8_t)(start + 1))
+        : readConfigByte(dev, PCI_CONFIG_CAPABILITIES);
+    // Bound the walk in case of a malformed (circular) list
+    for (size_t hops = 0; offset && hops < 48; hops++) {
+        offset &= 0xFC;
+        if (readConfigByte(dev, offset) == id) {
+            return offset;
+        }
+        offset = readConfigByte(dev, (uint8_t)(offset + 1));
+    }
+
+    return 0;
+}
+
+} // !namespace PCI
@@ -0,0 +1,142 @@
+/**
+ * @file pci.hpp
+ * @author Keeton Feavel (keeton@xyr.is)
+ * @brief Peripheral Component Interconnect (PCI) bus enumeration and
+ * configuration space access using the legacy 0xCF8/0xCFC mechanism.
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @copyright Copyright the Xyris Contributors (c) 2026
+ *
+ * References:
+ *         https://wiki.osdev.org/PCI
+ */
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+
+#define PCI_MAX_DEVICES 32
+#define PCI_MAX_BARS    6
+
+#define PCI_CONFIG_VENDOR_ID        0x00
+#define PCI_CONFIG_DEVICE_ID        0x02
+#define PCI_CONFIG_COMMAND          0x04
+#define PCI_CONFIG_STATUS           0x06
+#define PCI_CONFIG_REVISION         0x08
+#define PCI_CONFIG_PROG_IF          0x09
+#define PCI_CONFIG_SUBCLASS         0x0A
+#define PCI_CONFIG_CLASS            0x0B
+#define PCI_CONFIG_HEADER_TYPE      0x0E
+#define PCI_CONFIG_BAR0             0x10
+#define PCI_CONFIG_CAPABILITIES     0x34
+#define PCI_CONFIG_INTERRUPT_LINE   0x3C
+#define PCI_CONFIG_INTERRUPT_PIN    0x3D
+
+#define PCI_COMMAND_IO_SPACE        (1 << 0)
+#define PCI_COMMAND_MEMORY_SPACE    (1 << 1)
+#define PCI_COMMAND_BUS_MASTER      (1 << 2)
+#define PCI_COMMAND_INTX_DISABLE    (1 << 10)
+
+#define PCI_STATUS_CAPABILITIES     (1 << 4)
+
+#define PCI_CAPABILITY_VENDOR       0x09
+
+namespace PCI {
+
+/**
+ * @brief A function on the PCI bus discovered during enumeration.
+ *
+ */
+struct Device {
+    uint8_t bus;
+    uint8_t slot;
+    uint8_t function;
+    uint8_t headerType;
+    uint16_t vendorId;
+    uint16_t deviceId;
+    uint8_t classCode;
+    uint8_t subclass;
+    uint8_t progIf;
+    uint8_t interruptLine;
+};
+
+/**
+ * @brief Decoded Base Address Register (BAR) information.
+ *
+ */
+struct Bar {
+    uint64_t address;   // Physical (memory) or port (I/O) base address
+    uint32_t size;      // Size of the decoded region in bytes
+    bool isIO;          // Port I/O (true) or memory mapped (false)
+    bool is64Bit;       // Memory BAR consumes two BAR slots
+};
+
+/**
+ * @brief Enumerates every function on every bus and caches the devices
+ * found so that drivers may look them up without rescanning.
+ *
+ */
+void init();
+
+/**
+ * @brief Find a device by vendor and device ID.
+ *
+ * @param vendorId PCI vendor ID
+ * @param deviceId PCI device ID
+ * @param index Skip this many earlier matches (for multiple identical devices)
+ * @return Device* Matching device or NULL if not present
+ */
+Device* find(uint16_t vendorId, uint16_t deviceId, size_t index = 0);
+
+/**
+ * @brief Read from a device's configuration space.
+ *
+ * @param dev PCI device
+ * @param offset Configuration space offset
+ * @return Value read (byte, word, or long)
+ */
+uint8_t readConfigByte(Device* dev, uint8_t offset);
+uint16_t readConfigWord(Device* dev, uint8_t offset);
+uint32_t readConfigLong(Device* dev, uint8_t offset);
+
+/**
+ * @brief Write to a device's configuration space.
+ *
+ * @param dev PCI device
+ * @param offset Configuration space offset
+ * @param value Value to write (byte, word, or long)
+ */
+void writeConfigByte(Device* dev, uint8_t offset, uint8_t value);
+void writeConfigWord(Device* dev, uint8_t offset, uint16_t value);
+void writeConfigLong(Device* dev, uint8_t offset, uint32_t value);
+
+/**
+ * @brief Decode a base address register. The size of the region is probed
+ * by temporarily writing all ones to the register.
+ *
+ * @param dev PCI device
+ * @param index BAR index (0-5)
+ * @param bar Decoded BAR information
+ * @return true BAR is implemented and was decoded
+ * @return false BAR is unused
+ */
+bool readBar(Device* dev, uint8_t index, Bar& bar);
+
+/**
+ * @brief Enable memory space, I/O space, and bus mastering (DMA) for the device.
+ *
+ * @param dev PCI device
+ */
+void enableBusMastering(Device* dev);
+
+/**
+ * @brief Find a capability in the device's capability list.
+ *
+ * @param dev PCI device
+ * @param id Capability ID to look for
+ * @param start Offset of the previous match (0 to start from the beginning)
+ * @return uint8_t Configuration space offset of the capability (0 if not found)
+ */
+uint8_t findCapability(Device* dev, uint8_t id, uint8_t start = 0);
+
+} // !namespace PCI
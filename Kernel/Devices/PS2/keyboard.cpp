@@ -0,0 +1,236 @@
+/**
+ * @file keyboard.cpp
+ * @author Keeton Feavel (keeton@xyr.is)
+ * @brief PS/2 keyboard driver. The interrupt handler only queues raw
+ * scancodes; decoding and event delivery happen in a kernel task.
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @copyright Copyright the Xyris Contributors (c) 2026
+ *
+ */
+#include <Arch/Arch.hpp>
+#include <Devices/PS2/keyboard.hpp>
+#include <Library/SPSCRingBuffer.hpp>
+#include <Scheduler/tasks.hpp>
+#include <Logger.hpp>
+
+#define PS2_DATA_PORT       0x60
+#define PS2_STATUS_PORT     0x64
+#define PS2_STATUS_OUTPUT   (1 << 0)
+
+#define SCANCODE_EXTENDED   0xE0
+#define SCANCODE_PAUSE      0xE1    // Followed by five more bytes and has no release
+#define SCANCODE_PAUSE_SIZE 5
+#define SCANCODE_RELEASE    0x80
+
+#define KEY_LEFT_SHIFT      0x2A
+#define KEY_RIGHT_SHIFT     0x36
+#define KEY_CTRL            0x1D
+#define KEY_ALT             0x38
+#define KEY_CAPS_LOCK       0x3A
+
+#define KEYBOARD_RING_SIZE  256
+
+namespace PS2::Keyboard {
+
+// US layout, scan code set 1
+static const char keymap[0x3A] = {
+    0, 0x1B, '1', '2', '3', '4', '5', '6', '7', '8', '9', '0', '-', '=', '\b',
+    '\t', 'q', 'w', 'e', 'r', 't', 'y', 'u', 'i', 'o', 'p', '[', ']', '\n',
+    0, 'a', 's', 'd', 'f', 'g', 'h', 'j', 'k', 'l', ';', '\'', '`',
+    0, '\\', 'z', 'x', 'c', 'v', 'b', 'n', 'm', ',', '.', '/', 0,
+    '*', 0, ' ',
+};
+
+static const char keymapShift[0x3A] = {
+    0, 0x1B, '!', '@', '#', '$', '%', '^', '&', '*', '(', ')', '_', '+', '\b',
+    '\t', 'Q', 'W', 'E', 'R', 'T', 'Y', 'U', 'I', 'O', 'P', '{', '}', '\n',
+    0, 'A', 'S', 'D', 'F', 'G', 'H', 'J', 'K', 'L', ':', '"', '~',
+    0, '|', 'Z', 'X', 'C', 'V', 'B', 'N', 'M', '<', '>', '?', 0,
+    '*', 0, ' ',
+};
+
+// Written only by the interrupt handler, read only by the decoding task
+static SPSCRingBuffer<uint8_t, KEYBOARD_RING_SIZE> scancodes;
+static EventHandler subscribers[KEYBOARD_MAX_SUBSCRIBERS];
+static struct task decodeTask;
+static bool decodeWaiting = false;
+static bool decodePending = false;
+static uint64_t droppedCount = 0;
+
+// Decoder state (only touched by the decoding task)
+static bool extended = false;
+static size_t pauseRemaining = 0;
+static uint8_t modifiers = 0;
+static uint8_t leftShift = 0;
+static uint8_t rightShift = 0;
+
+static void interruptCallback(struct registers* regs)
+{
+    (void)regs;
+    while (readByte(PS2_STATUS_PORT) & PS2_STATUS_OUTPUT) {
+        if (!scancodes.Enqueue(readByte(PS2_DATA_PORT))) {
+            droppedCount++;
+        }
+    }
+
+    if (decodeWaiting) {
+        decodeWaiting = false;
+        tasks_unblock(&decodeTask);
+    } else {
+        decodePending = true;
+    }
+}
+
+static char translate(uint8_t keycode)
+{
+    if (keycode >= sizeof(keymap)) {
+        return 0;
+    }
+
+    bool shift = modifiers & KEYBOARD_MOD_SHIFT;
+    char c = keymap[keycode];
+    // Caps lock only applies to letters, and shift undoes it
+    if (c >= 'a' && c <= 'z' && (modifiers & KEYBOARD_MOD_CAPS_LOCK)) {
+        shift = !shift;
+    }
+
+    return shift ? keymapShift[keycode] : c;
+}
+
+static void updateModifiers(uint8_t keycode, bool pressed)
+{
+    switch (keycode & ~KEYBOARD_KEY_EXTENDED) {
+        case KEY_LEFT_SHIFT:
+            leftShift = pressed;
+            break;
+        case KEY_RIGHT_SHIFT:
+            rightShift = pressed;
+            break;
+        case KEY_CTRL:
+            modifiers = (uint8_t)(pressed ? modifiers | KEYBOARD_MOD_CTRL : modifiers & ~KEYBOARD_MOD_CTRL);
+            break;
+        case KEY_ALT:
+            modifiers = (uint8_t)(pressed ? modifiers | KEYBOARD_MOD_ALT : modifiers & ~KEYBOARD_MOD_ALT);
+            break;
+        case KEY_CAPS_LOCK:
+            if (pressed && !(keycode & KEYBOARD_KEY_EXTENDED)) {
+                modifiers ^= KEYBOARD_MOD_CAPS_LOCK;
+            }
+            break;
+        default:
+            return;
+    }
+
+    modifiers = (uint8_t)((leftShift || rightShift) ? modifiers | KEYBOARD_MOD_SHIFT : modifiers & ~KEYBOARD_MOD_SHIFT);
+}
+
+static void decode(uint8_t scancode)
+{
+    if (pauseRemaining) {
+        pauseRemaining--;
+        return;
+    }
+    if (scancode == SCANCODE_PAUSE) {
+        pauseRemaining = SCANCODE_PAUSE_SIZE;
+        return;
+    }
+    if (scancode == SCANCODE_EXTENDED) {
+        extended = true;
+        return;
+    }
+
+    bool pressed = !(scancode & SCANCODE_RELEASE);
+    uint8_t keycode = (uint8_t)((scancode & ~SCANCODE_RELEASE) | (extended ? KEYBOARD_KEY_EXTENDED : 0));
+    extended = false;
+    // Print screen sends fake shift presses around its real code
+    if (keycode == (KEYBOARD_KEY_EXTENDED | KEY_LEFT_SHIFT) || keycode == (KEYBOARD_KEY_EXTENDED | KEY_RIGHT_SHIFT)) {
+        return;
+    }
+
+    updateModifiers(keycode, pressed);
+    struct Event event = {
+        .keycode = keycode,
+        .modifiers = modifiers,
+        .character = (keycode & KEYBOARD_KEY_EXTENDED) ? (char)0 : translate(keycode),
+        .pressed = pressed,
+    };
+
+    for (size_t i = 0; i < KEYBOARD_MAX_SUBSCRIBERS; i++) {
+        EventHandler handler = subscribers[i];
+        if (handler) {
+            handler(event);
+        }
+    }
+}
+
+static void decodeWait()
+{
+    Arch::CPU::interruptsDisable();
+    if (!decodePending) {
+        decodeWaiting = true;
+        // Interrupts are re-enabled once another task is scheduled
+        tasks_block_current(TASK_PAUSED);
+    }
+    decodePending = false;
+    Arch::CPU::interruptsEnable();
+}
+
+static void decodeLoop()
+{
+    for (;;) {
+        uint8_t scancode;
+        while (scancodes.Dequeue(&scancode)) {
+            decode(scancode);
+        }
+
+        decodeWait();
+    }
+}
+
+void init()
+{
+    // Discard anything the firmware left in the output buffer
+    while (readByte(PS2_STATUS_PORT) & PS2_STATUS_OUTPUT) {
+        (void)readByte(PS2_DATA_PORT);
+    }
+
+    tasks_new(decodeLoop, &decodeTask, TASK_READY, "ps2-keyboard");
+    Interrupts::registerHandler(Interrupts::INTERRUPT_1, interruptCallback);
+    Logger::Info(__func__, "PS/2 keyboard ready");
+}
+
+bool subscribe(EventHandler handler)
+{
+    bool subscribed = false;
+    Arch::CPU::criticalRegionNestable([&]() {
+        for (size_t i = 0; i < KEYBOARD_MAX_SUBSCRIBERS; i++) {
+            if (!subscribers[i]) {
+                subscribers[i] = handler;
+                subscribed = true;
+                return;
+            }
+        }
+    });
+
+    return subscribed;
+}
+
+void unsubscribe(EventHandler handler)
+{
+    Arch::CPU::criticalRegionNestable([handler]() {
+        for (size_t i = 0; i < KEYBOARD_MAX_SUBSCRIBERS; i++) {
+            if (subscribers[i] == handler) {
+                subscribers[i] = NULL;
+            }
+        }
+    });
+}
+
+uint64_t dropped()
+{
+    return droppedCount;
+}
+
+} // !namespace PS2::Keyboard
@@ -0,0 +1,80 @@
+/**
+ * @file keyboard.hpp
+ * @author Keeton Feavel (keeton@xyr.is)
+ * @brief PS/2 keyboard driver. The interrupt handler only queues raw
+ * scancodes; decoding and event delivery happen in a kernel task.
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @copyright Copyright the Xyris Contributors (c) 2026
+ *
+ * References:
+ *         https://wiki.osdev.org/PS/2_Keyboard
+ */
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+
+#define KEYBOARD_MAX_SUBSCRIBERS    4
+
+// Modifier state bits
+#define KEYBOARD_MOD_SHIFT          (1 << 0)
+#define KEYBOARD_MOD_CTRL           (1 << 1)
+#define KEYBOARD_MOD_ALT            (1 << 2)
+#define KEYBOARD_MOD_CAPS_LOCK      (1 << 3)
+
+// Keycodes are scan code set 1 make codes. Extended (0xE0 prefixed) keys set the high bit.
+#define KEYBOARD_KEY_EXTENDED       0x80
+#define KEYBOARD_KEY_ESCAPE         0x01
+#define KEYBOARD_KEY_BACKSPACE      0x0E
+#define KEYBOARD_KEY_ENTER          0x1C
+#define KEYBOARD_KEY_UP             (KEYBOARD_KEY_EXTENDED | 0x48)
+#define KEYBOARD_KEY_LEFT           (KEYBOARD_KEY_EXTENDED | 0x4B)
+#define KEYBOARD_KEY_RIGHT          (KEYBOARD_KEY_EXTENDED | 0x4D)
+#define KEYBOARD_KEY_DOWN           (KEYBOARD_KEY_EXTENDED | 0x50)
+
+namespace PS2::Keyboard {
+
+struct Event {
+    uint8_t keycode;    // KEYBOARD_KEY_* (scan code set 1)
+    uint8_t modifiers;  // KEYBOARD_MOD_* held when the event occurred
+    char character;     // Character produced by the key (0 if none)
+    bool pressed;       // Pressed (true) or released (false)
+};
+
+/**
+ * @brief Called from the keyboard task for every key press and release.
+ *
+ */
+typedef void (*EventHandler)(const struct Event& event);
+
+/**
+ * @brief Install the interrupt handler and start the decoding task. Must be
+ * called after the scheduler is initialized.
+ *
+ */
+void init();
+
+/**
+ * @brief Deliver keyboard events to a handler.
+ *
+ * @param handler Event handler
+ * @return true Handler was subscribed
+ * @return false Too many subscribers
+ */
+bool subscribe(EventHandler handler);
+
+/**
+ * @brief Stop delivering keyboard events to a handler.
+ *
+ * @param handler Event handler
+ */
+void unsubscribe(EventHandler handler);
+
+/**
+ * @brief Number of scancodes dropped because the decoding task fell behind.
+ *
+ */
+uint64_t dropped();
+
+} // !namespace PS2::Keyboard
@@ -0,0 +1,81 @@
+/**
+ * @file dump.cpp
+ * @author Keeton Feavel (keeton@xyr.is)
+ * @brief Diagnostic dumps over the serial console, optionally LZ4 compressed
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @copyright Copyright the Xyris Contributors (c) 2026
+ *
+ */
+#include <Devices/Serial/dump.hpp>
+#include <Devices/Serial/rs232.hpp>
+#include <Library/stdio.hpp>
+#include <Locking/Mutex.hpp>
+#include <Logger.hpp>
+
+namespace RS232 {
+
+// shared by all compressed dumps, nothing is allocated while dumping
+static uint8_t buffer[LZ4::FrameWriter::bufferSize(RS_232_DUMP_BLOCK_LOG)];
+static struct LZ4::HashTable table;
+static Mutex lock("serial-dump");
+
+Dump::Dump(bool compressed)
+    : m_compressed(compressed)
+    , m_writer(buffer, RS_232_DUMP_BLOCK_LOG, table, sink, NULL)
+{
+    if (m_compressed) {
+        lock.lock();
+    }
+}
+
+Dump::~Dump()
+{
+    if (!m_compressed) {
+        return;
+    }
+
+    m_writer.finish();
+    lock.unlock();
+    Logger::Debug(__func__, "compressed %llu bytes to %llu", m_writer.consumed(), m_writer.produced());
+}
+
+void Dump::sink(const void* data, size_t size, void* context)
+{
+    (void)context;
+    RS232::write((const char*)data, size);
+}
+
+int Dump::printfHelper(unsigned c, void** ptr)
+{
+    char ch = (char)c;
+    static_cast<Dump*>(*ptr)->m_writer.write(&ch, 1);
+    return 0;
+}
+
+void Dump::write(const void* data, size_t size)
+{
+    if (m_compressed) {
+        m_writer.write(data, size);
+    } else {
+        RS232::write((const char*)data, size);
+    }
+}
+
+int Dump::printf(const char* format, ...)
+{
+    va_list args;
+    int ret_val;
+
+    va_start(args, format);
+    if (m_compressed) {
+        ret_val = printf_helper(format, args, printfHelper, this);
+    } else {
+        ret_val = RS232::vprintf(format, args);
+    }
+    va_end(args);
+    return ret_val;
+}
+
+} // !namespace RS232
@@ -0,0 +1,46 @@
+/**
+ * @file dump.hpp
+ * @author Keeton Feavel (keeton@xyr.is)
+ * @brief Diagnostic dumps over the serial console, optionally LZ4 compressed
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @copyright Copyright the Xyris Contributors (c) 2026
+ *
+ */
+#pragma once
+
+#include <Library/lz4.hpp>
+#include <stdarg.h>
+#include <stddef.h>
+
+#define RS_232_DUMP_BLOCK_LOG 12    // 4 KiB blocks
+
+namespace RS232 {
+
+/**
+ * @brief A dump written to the serial console. Compressed dumps are sent as
+ * a single LZ4 frame (see lz4.hpp) that `Meta/lz4-decode.py` expands back
+ * into text in the captured log. Compressed dumps share one set of buffers,
+ * so they are written one at a time.
+ *
+ */
+class Dump {
+public:
+    Dump(bool compressed);
+    ~Dump();
+
+    [[gnu::format (printf, 2, 3)]]
+    int printf(const char* format, ...);
+
+    void write(const void* data, size_t size);
+
+private:
+    static void sink(const void* data, size_t size, void* context);
+    static int printfHelper(unsigned c, void** ptr);
+
+    bool m_compressed;
+    LZ4::FrameWriter m_writer;
+};
+
+} // !namespace RS232
@@ -7,21 +7,21 @@
  *
  * @copyright Copyright the Xyris Contributors (c) 2020
  *
- * TODO: Make this module robust enough for fast transmission of binary data
- * currently it adequately supports slow, character transmission.
+ * References:
+ *         https://wiki.osdev.org/Serial_Ports
+ *         http://www.byterunner.com/16550.html
  *
  */
 
 #include <Arch/Arch.hpp>
 #include <Devices/Serial/rs232.hpp>
-#include <Library/RingBuffer.hpp>
 #include <Library/stdio.hpp>
 #include <Library/string.hpp>
 #include <Locking/RAII.hpp>
 #include <Logger.hpp>
-#include <Memory/heap.hpp>
 #include <stdarg.h>
 
+// COM1 and COM3 share one line, COM2 and COM4 the other
 #define RS_232_COM1_IRQ 0x04
 #define RS_232_COM3_IRQ 0x04
 #define RS_232_COM2_IRQ 0x03
@@ -30,60 +30,303 @@
 #define RS_232_DATA_REG 0x0
 #define RS_232_INTERRUPT_ENABLE_REG 0x1
 #define RS_232_INTERRUPT_IDENTIFICATION_REG 0x2
+#define RS_232_FIFO_CONTROL_REG 0x2
 #define RS_232_LINE_CONTROL_REG 0x3
 #define RS_232_MODEM_CONTROL_REG 0x4
 #define RS_232_LINE_STATUS_REG 0x5
 #define RS_232_MODEM_STATUS_REG 0x6
 #define RS_232_SCRATCH_REG 0x7
 
-namespace RS232 {
+#define RS_232_IER_RX_AVAILABLE 0x01
+#define RS_232_IER_TX_EMPTY 0x02
+#define RS_232_IER_LINE_STATUS 0x04
+
+#define RS_232_IIR_NONE_PENDING 0x01
+#define RS_232_IIR_ID_MASK 0x0E
+#define RS_232_IIR_TX_EMPTY 0x02
+#define RS_232_IIR_RX_AVAILABLE 0x04
+#define RS_232_IIR_LINE_STATUS 0x06
+#define RS_232_IIR_RX_TIMEOUT 0x0C
+
+#define RS_232_FCR_ENABLE 0x01
+#define RS_232_FCR_CLEAR_RX 0x02
+#define RS_232_FCR_CLEAR_TX 0x04
+
+#define RS_232_LCR_8N1 0x03
+#define RS_232_LCR_DLAB 0x80
+
+#define RS_232_MCR_NORMAL 0x0B      // DTR, RTS and OUT2 (routes the UART interrupt to the PIC)
+#define RS_232_MCR_LOOPBACK 0x1E    // RTS, OUT1, OUT2 and loopback
+
+#define RS_232_LSR_DATA_READY 0x01
+#define RS_232_LSR_OVERRUN 0x02
+#define RS_232_LSR_THR_EMPTY 0x20
+
+#define RS_232_FIFO_DEPTH 16
+#define RS_232_LOOPBACK_BYTE 0xAE
 
-static uint16_t rs_232_port_base;
-static RingBuffer<char, 1024> ring;
-static Mutex mutex_rs232("rs232");
+namespace RS232 {
 
-static int received();
-static int is_transmit_empty();
-static char read_byte();
-static void callback(struct registers* regs);
+static Port ports[] = {
+    Port(RS_232_COM1, RS_232_COM1_IRQ),
+    Port(RS_232_COM2, RS_232_COM2_IRQ),
+    Port(RS_232_COM3, RS_232_COM3_IRQ),
+    Port(RS_232_COM4, RS_232_COM4_IRQ),
+};
+static Port* console = NULL;
 
-static int received()
+static void dispatch(uint8_t irq)
 {
-    return readByte(rs_232_port_base + RS_232_LINE_STATUS_REG) & 1;
+    for (auto& serial : ports) {
+        if (serial.isPresent() && serial.irq() == irq) {
+            serial.handleInterrupt();
+        }
+    }
 }
 
-static int is_transmit_empty()
+static void com1Callback(struct registers* regs)
 {
-    return readByte(rs_232_port_base + RS_232_LINE_STATUS_REG) & 0x20;
+    (void)regs;
+    dispatch(RS_232_COM1_IRQ);
 }
 
-static char read_byte()
+static void com2Callback(struct registers* regs)
 {
-    lockedRegion([]() {
-        while (received() == 0)
-            ;
-    },
-        mutex_rs232);
-    return readByte(rs_232_port_base + RS_232_DATA_REG);
+    (void)regs;
+    dispatch(RS_232_COM2_IRQ);
 }
 
 static int vprintf_helper(unsigned c, void** ptr)
 {
-    // Unfortunately very hacky...
-    (void)ptr;
     char buf = (char)c;
-    write(&buf, 1);
+    static_cast<Port*>(*ptr)->write(&buf, 1);
     return 0;
 }
 
-int vprintf(const char* fmt, va_list args)
+Port::Port(uint16_t base, uint8_t irq)
+    : m_base(base)
+    , m_irq(irq)
+    , m_baud(0)
+    , m_fifoControl(RS_232_FCR_ENABLE)
+    , m_present(false)
+    , m_console(false)
+    , m_transmitting(false)
+    , m_rxDropped(0)
+    , m_rxOverruns(0)
+    , m_readLock("rs232")
 {
-    int retval;
-    retval = printf_helper(fmt, args, vprintf_helper, NULL);
-    return retval;
+    // Ports are configured by init()
 }
 
-int printf(const char* format, ...)
+bool Port::init(uint32_t baud, FIFOTrigger trigger)
+{
+    if (baud == 0 || baud > RS_232_MAX_BAUD || RS_232_MAX_BAUD % baud) {
+        return false;
+    }
+
+    uint16_t divisor = (uint16_t)(RS_232_MAX_BAUD / baud);
+    writeByte(m_base + RS_232_INTERRUPT_ENABLE_REG, 0x00);
+    writeByte(m_base + RS_232_LINE_CONTROL_REG, RS_232_LCR_DLAB);
+    writeByte(m_base + RS_232_DATA_REG, divisor & 0xFF);
+    writeByte(m_base + RS_232_INTERRUPT_ENABLE_REG, divisor >> 8);
+    writeByte(m_base + RS_232_LINE_CONTROL_REG, RS_232_LCR_8N1);
+    m_fifoControl = RS_232_FCR_ENABLE | trigger;
+    writeByte(m_base + RS_232_FIFO_CONTROL_REG, m_fifoControl | RS_232_FCR_CLEAR_RX | RS_232_FCR_CLEAR_TX);
+
+    // A missing port reads back as 0xFF, so check that a byte makes it through loopback
+    writeByte(m_base + RS_232_MODEM_CONTROL_REG, RS_232_MCR_LOOPBACK);
+    writeByte(m_base + RS_232_DATA_REG, RS_232_LOOPBACK_BYTE);
+    if (readByte(m_base + RS_232_DATA_REG) != RS_232_LOOPBACK_BYTE) {
+        return false;
+    }
+
+    writeByte(m_base + RS_232_MODEM_CONTROL_REG, RS_232_MCR_NORMAL);
+    while (readByte(m_base + RS_232_LINE_STATUS_REG) & RS_232_LSR_DATA_READY) {
+        (void)readByte(m_base + RS_232_DATA_REG);
+    }
+
+    m_baud = baud;
+    m_present = true;
+    uint8_t vector = (uint8_t)(Interrupts::INTERRUPT_0 + m_irq);
+    if (!Interrupts::isRegistered(vector)) {
+        Interrupts::registerHandler(vector, m_irq == RS_232_COM1_IRQ ? com1Callback : com2Callback);
+    }
+
+    writeByte(m_base + RS_232_INTERRUPT_ENABLE_REG, RS_232_IER_RX_AVAILABLE | RS_232_IER_LINE_STATUS);
+    return true;
+}
+
+bool Port::setBaudRate(uint32_t baud)
+{
+    if (!m_present || baud == 0 || baud > RS_232_MAX_BAUD || RS_232_MAX_BAUD % baud) {
+        return false;
+    }
+
+    flush();
+    uint16_t divisor = (uint16_t)(RS_232_MAX_BAUD / baud);
+    // The divisor latch hides the interrupt enable register, so keep the handler out
+    Arch::CPU::criticalRegionNestable([this, divisor]() {
+        uint8_t lineControl = readByte(m_base + RS_232_LINE_CONTROL_REG);
+        writeByte(m_base + RS_232_LINE_CONTROL_REG, lineControl | RS_232_LCR_DLAB);
+        writeByte(m_base + RS_232_DATA_REG, divisor & 0xFF);
+        writeByte(m_base + RS_232_INTERRUPT_ENABLE_REG, divisor >> 8);
+        writeByte(m_base + RS_232_LINE_CONTROL_REG, lineControl);
+    });
+
+    m_baud = baud;
+    return true;
+}
+
+void Port::setFIFOTrigger(FIFOTrigger trigger)
+{
+    m_fifoControl = RS_232_FCR_ENABLE | trigger;
+    if (m_present) {
+        writeByte(m_base + RS_232_FIFO_CONTROL_REG, m_fifoControl);
+    }
+}
+
+void Port::handleInterrupt()
+{
+    for (;;) {
+        uint8_t id = readByte(m_base + RS_232_INTERRUPT_IDENTIFICATION_REG);
+        if (id & RS_232_IIR_NONE_PENDING) {
+            break;
+        }
+
+        switch (id & RS_232_IIR_ID_MASK) {
+        case RS_232_IIR_LINE_STATUS:
+        case RS_232_IIR_RX_AVAILABLE:
+        case RS_232_IIR_RX_TIMEOUT:
+            receive();
+            break;
+        case RS_232_IIR_TX_EMPTY:
+            transmit();
+            break;
+        default:
+            // Modem status change. Reading the register acknowledges it.
+            (void)readByte(m_base + RS_232_MODEM_STATUS_REG);
+            break;
+        }
+    }
+}
+
+void Port::receive()
+{
+    bool received = false;
+    for (;;) {
+        uint8_t status = readByte(m_base + RS_232_LINE_STATUS_REG);
+        if (status & RS_232_LSR_OVERRUN) {
+            m_rxOverruns++;
+        }
+        if (!(status & RS_232_LSR_DATA_READY)) {
+            break;
+        }
+
+        char in = readByte(m_base + RS_232_DATA_REG);
+        if (m_console) {
+            // Change carriage returns to newlines and echo the character back
+            if (in == '\r') {
+                in = '\n';
+            }
+            if (m_tx.Enqueue(in) && !m_transmitting) {
+                transmit();
+            }
+        }
+
+        if (!m_rx.Enqueue(in)) {
+            m_rxDropped++;
+        } else {
+            received = true;
+        }
+    }
+
+    if (received) {
+        notify();
+    }
+}
+
+void Port::transmit()
+{
+    // Must be called with interrupts disabled. An empty holding register
+    // means the whole transmit FIFO is free.
+    if (readByte(m_base + RS_232_LINE_STATUS_REG) & RS_232_LSR_THR_EMPTY) {
+        char out;
+        for (size_t idx = 0; idx < RS_232_FIFO_DEPTH && m_tx.Dequeue(&out); idx++) {
+            writeByte(m_base + RS_232_DATA_REG, out);
+        }
+    }
+
+    // Keep the transmit-empty interrupt enabled only while output is queued
+    bool pending = !m_tx.IsEmpty();
+    if (pending != m_transmitting) {
+        uint8_t enable = readByte(m_base + RS_232_INTERRUPT_ENABLE_REG);
+        enable = pending ? (enable | RS_232_IER_TX_EMPTY) : (enable & ~RS_232_IER_TX_EMPTY);
+        writeByte(m_base + RS_232_INTERRUPT_ENABLE_REG, enable);
+        m_transmitting = pending;
+    }
+}
+
+void Port::transmitPolled()
+{
+    while (!(readByte(m_base + RS_232_LINE_STATUS_REG) & RS_232_LSR_THR_EMPTY))
+        ;
+    transmit();
+}
+
+size_t Port::read(char* buf, size_t count)
+{
+    size_t bytes = 0;
+    RAIIMutex lock(m_readLock);
+    while (bytes < count && m_rx.Dequeue(&buf[bytes])) {
+        bytes++;
+    }
+    return bytes;
+}
+
+size_t Port::write(const char* buf, size_t count)
+{
+    if (!m_present) {
+        return 0;
+    }
+
+    size_t bytes = 0;
+    while (bytes < count) {
+        Arch::CPU::criticalRegionNestable([this, buf, count, &bytes]() {
+            while (bytes < count && m_tx.Enqueue(buf[bytes])) {
+                bytes++;
+            }
+            if (bytes < count) {
+                // The ring is full, make room by feeding the UART directly
+                transmitPolled();
+            } else if (!m_transmitting) {
+                transmit();
+            }
+        });
+    }
+
+    // The transmit-empty interrupt can't drain the ring (e.g. during a panic)
+    if (!Arch::CPU::interruptsEnabled()) {
+        flush();
+    }
+
+    return bytes;
+}
+
+void Port::flush()
+{
+    while (m_present && !m_tx.IsEmpty()) {
+        Arch::CPU::criticalRegionNestable([this]() {
+            transmitPolled();
+        });
+    }
+}
+
+int Port::vprintf(const char* fmt, va_list args)
+{
+    return printf_helper(fmt, args, vprintf_helper, this);
+}
+
+int Port::printf(const char* format, ...)
 {
     va_list args;
     int ret_val;
@@ -94,39 +337,42 @@ int printf(const char* format, ...)
     return ret_val;
 }
 
-static void callback(struct registers* regs)
+Port* port(uint16_t com_id)
 {
-    (void)regs;
-    // Grab the input character
-    char in = read_byte();
-    // Change carriage returns to newlines
-    if (in == '\r') {
-        in = '\n';
+    for (auto& serial : ports) {
+        if (serial.base() == com_id) {
+            return &serial;
+        }
     }
-    printf("%c", in);
-    // Add the character to the circular buffer
-    ring.Enqueue(in);
+
+    return NULL;
+}
+
+int vprintf(const char* fmt, va_list args)
+{
+    return console ? console->vprintf(fmt, args) : 0;
+}
+
+int printf(const char* format, ...)
+{
+    va_list args;
+    int ret_val;
+
+    va_start(args, format);
+    ret_val = vprintf(format, args);
+    va_end(args);
+    return ret_val;
 }
 
-// FIXME: Use separate ring buffers for COM1 & COM2
 void init(uint16_t com_id)
 {
-    // Register the IRQ callback
-    rs_232_port_base = com_id;
-    uint8_t IRQ = 0x20 + (com_id == RS_232_COM1 ? RS_232_COM1_IRQ : RS_232_COM2_IRQ);
-    Interrupts::registerHandler(IRQ, callback);
-    // Write the port data to activate the device
-    // disable interrupts
-    writeByte(rs_232_port_base + RS_232_INTERRUPT_ENABLE_REG, 0x00);
-    writeByte(rs_232_port_base + RS_232_LINE_CONTROL_REG, 0x80);
-    writeByte(rs_232_port_base + RS_232_DATA_REG, 0x03);
-    writeByte(rs_232_port_base + RS_232_INTERRUPT_ENABLE_REG, 0x00);
-    writeByte(rs_232_port_base + RS_232_LINE_CONTROL_REG, 0x03);
-    writeByte(rs_232_port_base + RS_232_INTERRUPT_IDENTIFICATION_REG, 0xC7);
-    writeByte(rs_232_port_base + RS_232_MODEM_CONTROL_REG, 0x0B);
-    writeByte(rs_232_port_base + RS_232_LINE_CONTROL_REG, 0x00);
-    // re-enable interrupts
-    writeByte(rs_232_port_base + RS_232_INTERRUPT_ENABLE_REG, 0x01);
+    Port* serial = port(com_id);
+    if (!serial || !serial->init()) {
+        return;
+    }
+
+    serial->setConsoleMode(true);
+    console = serial;
 
     Logger::addWriter(vprintf);
     Logger::Print(
@@ -143,26 +389,12 @@ void init(uint16_t com_id)
 
 size_t read(char* buf, size_t count)
 {
-    size_t bytes = 0;
-    mutex_rs232.lock();
-    for (size_t idx = 0; idx < count && !ring.IsEmpty(); idx++) {
-        buf[idx] = ring.Dequeue();
-        bytes++;
-    }
-    mutex_rs232.unlock();
-    return bytes;
+    return console ? console->read(buf, count) : 0;
 }
 
 size_t write(const char* buf, size_t count)
 {
-    // Wait for previous transfer to complete
-    while (is_transmit_empty() == 0);
-    size_t bytes = 0;
-    for (size_t idx = 0; idx < count; idx++) {
-        writeByte(rs_232_port_base + RS_232_DATA_REG, buf[idx]);
-        bytes++;
-    }
-    return bytes;
+    return console ? console->write(buf, count) : 0;
 }
 
 int close()
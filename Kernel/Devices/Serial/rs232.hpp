@@ -1,8 +1,9 @@
 /**
  * @file rs232.hpp
  * @author Keeton Feavel (keetonfeavel@cedarville.edu)
- * @brief A simple, write-only driver for the RS232 serial
- * device standard. Code mostly ported from Panix-Archive (v2).
+ * @brief An interrupt driven driver for the RS232 serial device standard.
+ * Each COM port is an independent device with its own receive and transmit
+ * rings. Code originally ported from Panix-Archive (v2).
  * @version 0.3
  * @date 2020-06-29
  *
@@ -11,6 +12,9 @@
  */
 #pragma once
 
+#include <IPC/Waitable.hpp>
+#include <Library/SPSCRingBuffer.hpp>
+#include <Locking/Mutex.hpp>
 #include <stdarg.h>
 #include <stdint.h>
 #include <stddef.h>
@@ -20,10 +24,154 @@
 #define RS_232_COM3 0x3E8
 #define RS_232_COM4 0x2E8
 
+#define RS_232_MAX_BAUD     115200  // UART input clock (1.8432 MHz) divided by 16
+#define RS_232_RX_RING_SIZE 1024
+#define RS_232_TX_RING_SIZE 4096
+
 namespace RS232 {
 
 /**
- * @brief Activates the RS232 serial driver
+ * @brief Number of received bytes in the FIFO that raises a receive interrupt.
+ * Lower levels reduce latency (interactive use), higher levels reduce the
+ * interrupt rate (bulk transfers).
+ *
+ */
+enum FIFOTrigger : uint8_t {
+    FIFO_TRIGGER_1 = 0x00,
+    FIFO_TRIGGER_4 = 0x40,
+    FIFO_TRIGGER_8 = 0x80,
+    FIFO_TRIGGER_14 = 0xC0,
+};
+
+/**
+ * @brief A single COM port. Received bytes are queued by the interrupt
+ * handler and transmitted bytes are queued by writers and fed to the UART
+ * FIFO from the transmit-empty interrupt. The port is ready (as a Waitable)
+ * while received bytes are queued.
+ *
+ */
+class Port : public IPC::Waitable {
+public:
+    Port(uint16_t base, uint8_t irq);
+
+    /**
+     * @brief Probe and configure the port (8N1) and enable its interrupts.
+     *
+     * @param baud Baud rate. Must evenly divide RS_232_MAX_BAUD.
+     * @param trigger Receive FIFO trigger level
+     * @return true Port is present and configured
+     * @return false Port did not pass the loopback test or the baud rate is invalid
+     */
+    bool init(uint32_t baud = RS_232_MAX_BAUD, FIFOTrigger trigger = FIFO_TRIGGER_8);
+
+    /**
+     * @brief Change the baud rate. Queued output is flushed at the old rate first.
+     *
+     * @param baud Baud rate. Must evenly divide RS_232_MAX_BAUD.
+     * @return true Baud rate was changed
+     */
+    bool setBaudRate(uint32_t baud);
+
+    /**
+     * @brief Change the receive FIFO trigger level.
+     *
+     */
+    void setFIFOTrigger(FIFOTrigger trigger);
+
+    /**
+     * @brief Console mode echoes received bytes back to the sender and
+     * translates carriage returns to newlines. Leave it disabled for binary data.
+     *
+     */
+    void setConsoleMode(bool enabled) { m_console = enabled; }
+
+    /**
+     * @brief Read received bytes without blocking.
+     *
+     * @param buf Buffer to hold the serial input
+     * @param count Maximum number of bytes to read
+     * @return size_t Number of bytes read
+     */
+    size_t read(char* buf, size_t count);
+
+    /**
+     * @brief Queue bytes for transmission. Only blocks (by draining the
+     * transmit ring) when the ring is full or interrupts are disabled.
+     *
+     * @param buf Buffer containing bytes to write
+     * @param count Number of bytes to write
+     * @return size_t Number of bytes written
+     */
+    size_t write(const char* buf, size_t count);
+
+    /**
+     * @brief Busy-wait until all queued output has been handed to the UART.
+     *
+     */
+    void flush();
+
+    [[gnu::format (printf, 2, 3)]]
+    int printf(const char* format, ...);
+
+    [[gnu::format (printf, 2, 0)]]
+    int vprintf(const char* fmt, va_list args);
+
+    bool isPresent() { return m_present; }
+    uint16_t base() { return m_base; }
+    uint8_t irq() { return m_irq; }
+    uint32_t baudRate() { return m_baud; }
+
+    /**
+     * @brief Bytes lost because the receive ring was full.
+     *
+     */
+    uint64_t rxDropped() { return m_rxDropped; }
+
+    /**
+     * @brief Bytes lost because the UART FIFO overflowed before it was serviced.
+     *
+     */
+    uint64_t rxOverruns() { return m_rxOverruns; }
+
+    bool isReady() override { return !m_rx.IsEmpty(); }
+
+    /**
+     * @brief Service everything the UART has pending. Called from the IRQ
+     * dispatcher, which is shared by the ports on the same line.
+     *
+     */
+    void handleInterrupt();
+
+private:
+    void receive();
+    void transmit();
+    void transmitPolled();
+
+    uint16_t m_base;
+    uint8_t m_irq;
+    uint32_t m_baud;
+    uint8_t m_fifoControl;
+    bool m_present;
+    bool m_console;
+    bool m_transmitting;
+    uint64_t m_rxDropped;
+    uint64_t m_rxOverruns;
+    Mutex m_readLock;
+    SPSCRingBuffer<char, RS_232_RX_RING_SIZE> m_rx;
+    SPSCRingBuffer<char, RS_232_TX_RING_SIZE> m_tx;
+};
+
+/**
+ * @brief Get the device object for a COM port.
+ *
+ * @param com_id Port base (RS_232_COM1 through RS_232_COM4)
+ * @return Port* Port or NULL if the base is not a standard COM port
+ */
+Port* port(uint16_t com_id);
+
+/**
+ * @brief Activates the serial console on the given port. The console port
+ * receives kernel log output and backs the functions below.
  *
  */
 void init(uint16_t com_id);
@@ -0,0 +1,197 @@
+/**
+ * @file console.cpp
+ * @author Keeton Feavel (keeton@xyr.is)
+ * @brief Virtio console driver. Provides a high throughput log and debug
+ * channel by batching output into page sized virtqueue buffers rather than
+ * writing to the UART one byte at a time.
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @copyright Copyright the Xyris Contributors (c) 2026
+ *
+ */
+#include <Arch/Arch.hpp>
+#include <Arch/Memory.hpp>
+#include <Arch/i686/timer.hpp> // TODO: Remove ASAP
+#include <Devices/Serial/rs232.hpp>
+#include <Devices/Virtio/console.hpp>
+#include <Devices/Virtio/virtio.hpp>
+#include <Library/stdio.hpp>
+#include <Memory/paging.hpp>
+#include <Logger.hpp>
+#include <Panic.hpp>
+
+#define VIRTIO_CONSOLE_QUEUE_TX     1   // Port 0 transmit queue
+#define VIRTIO_CONSOLE_TX_BUFFERS   8   // Number of page sized transmit buffers
+#define VIRTIO_CONSOLE_FLUSH_TICKS  10  // Partially filled buffers are sent after this many ms
+
+namespace VirtioConsole {
+
+struct TxBuffer {
+    char* data;
+    uintptr_t physical;
+    size_t length;
+    bool busy;
+};
+
+// Output may come from interrupt handlers (including the timer flush), so
+// buffer state is only touched with interrupts masked.
+static Virtio::Device device;
+static Virtio::Queue txQueue;
+static struct TxBuffer buffers[VIRTIO_CONSOLE_TX_BUFFERS];
+static size_t current = 0;
+static bool present = false;
+static uint32_t lastFlush = 0;
+
+static void reclaim()
+{
+    struct TxBuffer* buffer;
+    while ((buffer = (struct TxBuffer*)txQueue.pop(NULL))) {
+        buffer->length = 0;
+        buffer->busy = false;
+    }
+}
+
+static void submitCurrent()
+{
+    struct TxBuffer* buffer = &buffers[current];
+    if (!buffer->length) {
+        return;
+    }
+
+    Virtio::Buffer segment = { buffer->physical, (uint32_t)buffer->length };
+    buffer->busy = true;
+    txQueue.submit(&segment, 1, 0, buffer);
+    txQueue.kick();
+
+    // Buffers are used round robin. The device completes them in order, so
+    // waiting on the next one only blocks when every buffer is in flight.
+    current = (current + 1) % VIRTIO_CONSOLE_TX_BUFFERS;
+    reclaim();
+    while (buffers[current].busy) {
+        asm volatile("pause");
+        reclaim();
+    }
+}
+
+static void append(char c)
+{
+    struct TxBuffer* buffer = &buffers[current];
+    buffer->data[buffer->length++] = c;
+    if (buffer->length == ARCH_PAGE_SIZE) {
+        submitCurrent();
+    }
+}
+
+static void flushCallback()
+{
+    // Called from the timer interrupt (interrupts already disabled)
+    if (timer_tick - lastFlush < VIRTIO_CONSOLE_FLUSH_TICKS) {
+        return;
+    }
+
+    lastFlush = timer_tick;
+    reclaim();
+    submitCurrent();
+}
+
+static int vprintf_helper(unsigned c, void** ptr)
+{
+    (void)ptr;
+    append((char)c);
+    return 0;
+}
+
+void init()
+{
+    PCI::Device* pci = Virtio::find(VIRTIO_TYPE_CONSOLE, VIRTIO_TRANSITIONAL_CONSOLE);
+    if (!pci) {
+        Logger::Debug(__func__, "No virtio console found");
+        return;
+    }
+
+    if (!device.init(pci) || !device.negotiate(0)) {
+        Logger::Warning(__func__, "Failed to initialize virtio console");
+        return;
+    }
+
+    if (!txQueue.init(&device, VIRTIO_CONSOLE_QUEUE_TX, VIRTIO_CONSOLE_TX_BUFFERS)) {
+        Logger::Warning(__func__, "Failed to initialize virtio console transmit queue");
+        device.fail();
+        return;
+    }
+
+    // Completions are reaped when buffers are reused, so there is no need
+    // for the device to interrupt us.
+    txQueue.interruptsDisable();
+
+    for (size_t i = 0; i < VIRTIO_CONSOLE_TX_BUFFERS; i++) {
+        buffers[i].data = (char*)Memory::newFrame();
+        if (!buffers[i].data) {
+            panic("Failed to allocate virtio console buffers!");
+        }
+        buffers[i].physical = Memory::virtToPhys(buffers[i].data);
+        buffers[i].length = 0;
+        buffers[i].busy = false;
+    }
+
+    device.ready();
+    present = true;
+    lastFlush = timer_tick;
+    timer_register_callback(flushCallback);
+
+    // The serial writer remains the fallback if the sink cannot be added
+    if (Logger::addWriter(vprintf)) {
+        Logger::removeWriter(RS232::vprintf);
+    }
+
+    Logger::Info(__func__, "Virtio console ready (%u buffers)", VIRTIO_CONSOLE_TX_BUFFERS);
+}
+
+bool isPresent()
+{
+    return present;
+}
+
+size_t write(const char* buf, size_t count)
+{
+    if (!present) {
+        return 0;
+    }
+
+    Arch::CPU::criticalRegionNestable([buf, count]() {
+        for (size_t idx = 0; idx < count; idx++) {
+            append(buf[idx]);
+        }
+    });
+
+    return count;
+}
+
+void flush()
+{
+    if (!present) {
+        return;
+    }
+
+    Arch::CPU::criticalRegionNestable([]() {
+        reclaim();
+        submitCurrent();
+    });
+}
+
+int vprintf(const char* fmt, va_list args)
+{
+    if (!present) {
+        return 0;
+    }
+
+    int retval;
+    Arch::CPU::criticalRegionNestable([&retval, fmt, args]() {
+        retval = printf_helper(fmt, args, vprintf_helper, NULL);
+    });
+
+    return retval;
+}
+
+} // !namespace VirtioConsole
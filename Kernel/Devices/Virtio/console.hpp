@@ -0,0 +1,61 @@
+/**
+ * @file console.hpp
+ * @author Keeton Feavel (keeton@xyr.is)
+ * @brief Virtio console driver. Provides a high throughput log and debug
+ * channel by batching output into page sized virtqueue buffers rather than
+ * writing to the UART one byte at a time.
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @copyright Copyright the Xyris Contributors (c) 2026
+ *
+ */
+#pragma once
+#include <stdarg.h>
+#include <stddef.h>
+#include <stdint.h>
+
+namespace VirtioConsole {
+
+/**
+ * @brief Probe for a virtio console device and, if present, replace the
+ * serial log writer with the virtio console writer. The serial writer is
+ * kept when no device is found.
+ *
+ */
+void init();
+
+/**
+ * @brief Check whether a virtio console device was found and initialized.
+ *
+ */
+bool isPresent();
+
+/**
+ * @brief Queue bytes for transmission. Data is sent once a buffer fills,
+ * when `flush()` is called, or after a short timeout.
+ *
+ * @param buf Buffer containing bytes to write
+ * @param count Number of bytes to write
+ * @return size_t Number of bytes queued
+ */
+size_t write(const char* buf, size_t count);
+
+/**
+ * @brief Submit any partially filled buffer to the device immediately.
+ *
+ */
+void flush();
+
+/**
+ * @brief Prints a formatted string to the virtio console using
+ * a va_list of arguments. Suitable for use as a Logger writer.
+ *
+ * @param fmt Format string
+ * @param args Arguments list
+ * @return int Number of characters printed
+ */
+[[gnu::format (printf, 1, 0)]]
+int vprintf(const char* fmt, va_list args);
+
+} // !namespace VirtioConsole
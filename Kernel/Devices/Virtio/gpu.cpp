@@ -0,0 +1,329 @@
+/**
+ * @file gpu.cpp
+ * @author Keeton Feavel (keeton@xyr.is)
+ * @brief Virtio GPU (2D) driver. The host scans out of a resource backed by
+ * guest memory, so only the damaged parts of a frame are ever transferred.
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @copyright Copyright the Xyris Contributors (c) 2026
+ *
+ * References:
+ *         https://docs.oasis-open.org/virtio/virtio/v1.1/csprd01/virtio-v1.1-csprd01.html#x1-3200007
+ */
+#include <Arch/Arch.hpp>
+#include <Arch/Memory.hpp>
+#include <Devices/Virtio/gpu.hpp>
+#include <Devices/Virtio/virtio.hpp>
+#include <Library/string.hpp>
+#include <Memory/paging.hpp>
+#include <Logger.hpp>
+
+#define VIRTIO_GPU_QUEUE_CONTROL    0
+#define VIRTIO_GPU_QUEUE_SIZE       16
+
+// Control commands
+#define VIRTIO_GPU_CMD_RESOURCE_CREATE_2D       0x0101
+#define VIRTIO_GPU_CMD_SET_SCANOUT              0x0103
+#define VIRTIO_GPU_CMD_RESOURCE_FLUSH           0x0104
+#define VIRTIO_GPU_CMD_TRANSFER_TO_HOST_2D      0x0105
+#define VIRTIO_GPU_CMD_RESOURCE_ATTACH_BACKING  0x0106
+#define VIRTIO_GPU_RESP_OK_NODATA               0x1100
+
+#define VIRTIO_GPU_FORMAT_B8G8R8X8_UNORM        2   // XRGB in a little endian 32-bit word
+
+#define VIRTIO_GPU_RESOURCE_ID  1
+#define VIRTIO_GPU_SCANOUT_ID   0
+#define VIRTIO_GPU_MAX_ENTRY_PAGES  8   // Backing entries describe up to 8 MiB (more when contiguous)
+
+namespace VirtioGPU {
+
+struct [[gnu::packed]] ControlHeader {
+    uint32_t type;
+    uint32_t flags;
+    uint64_t fenceId;
+    uint32_t contextId;
+    uint32_t padding;
+};
+
+struct [[gnu::packed]] Rect {
+    uint32_t x;
+    uint32_t y;
+    uint32_t width;
+    uint32_t height;
+};
+
+struct [[gnu::packed]] ResourceCreate2D {
+    struct ControlHeader header;
+    uint32_t resourceId;
+    uint32_t format;
+    uint32_t width;
+    uint32_t height;
+};
+
+struct [[gnu::packed]] AttachBacking {
+    struct ControlHeader header;
+    uint32_t resourceId;
+    uint32_t entryCount;
+};
+
+struct [[gnu::packed]] MemoryEntry {
+    uint64_t address;
+    uint32_t length;
+    uint32_t padding;
+};
+
+struct [[gnu::packed]] SetScanout {
+    struct ControlHeader header;
+    struct Rect rect;
+    uint32_t scanoutId;
+    uint32_t resourceId;
+};
+
+struct [[gnu::packed]] TransferToHost2D {
+    struct ControlHeader header;
+    struct Rect rect;
+    uint64_t offset;
+    uint32_t resourceId;
+    uint32_t padding;
+};
+
+struct [[gnu::packed]] ResourceFlush {
+    struct ControlHeader header;
+    struct Rect rect;
+    uint32_t resourceId;
+    uint32_t padding;
+};
+
+// Requests and responses live in a single page so each is physically contiguous
+struct Commands {
+    union {
+        struct ResourceCreate2D create;
+        struct AttachBacking attach;
+        struct SetScanout scanout;
+        struct TransferToHost2D transfer;
+    };
+    struct ResourceFlush flush;
+    struct ControlHeader responses[2];
+};
+static_assert(sizeof(struct Commands) <= ARCH_PAGE_SIZE);
+
+static Virtio::Device device;
+static Virtio::Queue controlQueue;
+static struct Commands* commands = NULL;
+static uintptr_t commandsPhysical = 0;
+static uint8_t* backing = NULL;
+static uint32_t backingPitch = 0;
+static uint32_t scanoutWidth = 0;
+static uint32_t scanoutHeight = 0;
+static bool present = false;
+
+static uintptr_t physicalOf(const void* ptr)
+{
+    return commandsPhysical + ((uintptr_t)ptr - (uintptr_t)commands);
+}
+
+static void prepare(struct ControlHeader* header, uint32_t type)
+{
+    memset(header, 0, sizeof(struct ControlHeader));
+    header->type = type;
+}
+
+/**
+ * @brief Wait for every submitted command to complete. Commands are short
+ * and processed synchronously by the host, so polling is cheaper than
+ * taking an interrupt.
+ *
+ */
+static void wait(size_t count)
+{
+    controlQueue.kick();
+    while (count) {
+        if (controlQueue.pop(NULL)) {
+            count--;
+        } else {
+            asm volatile("pause");
+        }
+    }
+}
+
+static bool execute(const Virtio::Buffer* buffers, size_t readable)
+{
+    Virtio::Buffer chain[VIRTIO_GPU_MAX_ENTRY_PAGES + 2];
+    memcpy(chain, buffers, readable * sizeof(Virtio::Buffer));
+    chain[readable] = { physicalOf(&commands->responses[0]), sizeof(struct ControlHeader) };
+    if (!controlQueue.submit(chain, readable, 1, commands)) {
+        return false;
+    }
+
+    wait(1);
+    return commands->responses[0].type == VIRTIO_GPU_RESP_OK_NODATA;
+}
+
+static bool createResource()
+{
+    prepare(&commands->create.header, VIRTIO_GPU_CMD_RESOURCE_CREATE_2D);
+    commands->create.resourceId = VIRTIO_GPU_RESOURCE_ID;
+    commands->create.format = VIRTIO_GPU_FORMAT_B8G8R8X8_UNORM;
+    commands->create.width = scanoutWidth;
+    commands->create.height = scanoutHeight;
+
+    Virtio::Buffer request = { commandsPhysical, sizeof(struct ResourceCreate2D) };
+    return execute(&request, 1);
+}
+
+static bool attachBacking(size_t size)
+{
+    // One entry per physically contiguous run of backing pages
+    size_t pages = size / ARCH_PAGE_SIZE;
+    struct MemoryEntry* entries = (struct MemoryEntry*)Memory::newPage(pages * sizeof(struct MemoryEntry) - 1);
+    if (!entries) {
+        return false;
+    }
+
+    size_t count = 0;
+    for (size_t page = 0; page < pages; page++) {
+        uintptr_t physical = Memory::getPhysicalAddress((uintptr_t)backing + page * ARCH_PAGE_SIZE);
+        if (count && entries[count - 1].address + entries[count - 1].length == physical) {
+            entries[count - 1].length += ARCH_PAGE_SIZE;
+        } else {
+            entries[count++] = { physical, ARCH_PAGE_SIZE, 0 };
+        }
+    }
+
+    // The entry array is only virtually contiguous, so give each page its own descriptor
+    size_t entryBytes = count * sizeof(struct MemoryEntry);
+    size_t entryPages = (entryBytes + ARCH_PAGE_SIZE - 1) / ARCH_PAGE_SIZE;
+    bool success = false;
+    if (entryPages <= VIRTIO_GPU_MAX_ENTRY_PAGES) {
+        prepare(&commands->attach.header, VIRTIO_GPU_CMD_RESOURCE_ATTACH_BACKING);
+        commands->attach.resourceId = VIRTIO_GPU_RESOURCE_ID;
+        commands->attach.entryCount = (uint32_t)count;
+
+        Virtio::Buffer request[VIRTIO_GPU_MAX_ENTRY_PAGES + 1];
+        request[0] = { commandsPhysical, sizeof(struct AttachBacking) };
+        for (size_t i = 0; i < entryPages; i++) {
+            size_t length = entryBytes - i * ARCH_PAGE_SIZE;
+            request[i + 1] = {
+                Memory::getPhysicalAddress((uintptr_t)entries + i * ARCH_PAGE_SIZE),
+                (uint32_t)(length < ARCH_PAGE_SIZE ? length : ARCH_PAGE_SIZE),
+            };
+        }
+        success = execute(request, entryPages + 1);
+    }
+
+    // The device copies the entries when the command is processed
+    Memory::freePage(entries, pages * sizeof(struct MemoryEntry) - 1);
+    return success;
+}
+
+static bool setScanout()
+{
+    prepare(&commands->scanout.header, VIRTIO_GPU_CMD_SET_SCANOUT);
+    commands->scanout.rect = { 0, 0, scanoutWidth, scanoutHeight };
+    commands->scanout.scanoutId = VIRTIO_GPU_SCANOUT_ID;
+    commands->scanout.resourceId = VIRTIO_GPU_RESOURCE_ID;
+
+    Virtio::Buffer request = { commandsPhysical, sizeof(struct SetScanout) };
+    return execute(&request, 1);
+}
+
+bool init(uint32_t width, uint32_t height)
+{
+    PCI::Device* pci = Virtio::find(VIRTIO_TYPE_GPU, 0);
+    if (!pci) {
+        Logger::Debug(__func__, "No virtio GPU found");
+        return false;
+    }
+
+    if (!device.init(pci) || !device.negotiate(0)) {
+        Logger::Warning(__func__, "Failed to initialize virtio GPU");
+        return false;
+    }
+
+    if (!controlQueue.init(&device, VIRTIO_GPU_QUEUE_CONTROL, VIRTIO_GPU_QUEUE_SIZE)) {
+        Logger::Warning(__func__, "Failed to initialize virtio GPU control queue");
+        device.fail();
+        return false;
+    }
+    controlQueue.interruptsDisable();
+    device.ready();
+
+    scanoutWidth = width;
+    scanoutHeight = height;
+    backingPitch = width * sizeof(uint32_t);
+    size_t size = backingPitch * height;
+    size = (size + ARCH_PAGE_SIZE - 1) & ~(size_t)(ARCH_PAGE_SIZE - 1);
+    commands = (struct Commands*)Memory::newPage(sizeof(struct Commands) - 1);
+    backing = (uint8_t*)Memory::newPage(size - 1);
+    if (!commands || !backing) {
+        Logger::Warning(__func__, "Failed to allocate virtio GPU scanout");
+        device.fail();
+        return false;
+    }
+    commandsPhysical = Memory::getPhysicalAddress((uintptr_t)commands);
+    memset(backing, 0, size);
+
+    if (!createResource() || !attachBacking(size) || !setScanout()) {
+        Logger::Warning(__func__, "Virtio GPU rejected scanout setup");
+        device.fail();
+        return false;
+    }
+
+    present = true;
+    flush(0, 0, width, height);
+    Logger::Info(__func__, "Virtio GPU scanout ready (%lux%lu)", width, height);
+    return true;
+}
+
+bool isPresent()
+{
+    return present;
+}
+
+void* framebuffer()
+{
+    return backing;
+}
+
+uint32_t pitch()
+{
+    return backingPitch;
+}
+
+void flush(uint32_t x, uint32_t y, uint32_t width, uint32_t height)
+{
+    if (!present || !width || !height) {
+        return;
+    }
+
+    Arch::CPU::criticalRegionNestable([x, y, width, height]() {
+        struct Rect rect = { x, y, width, height };
+
+        prepare(&commands->transfer.header, VIRTIO_GPU_CMD_TRANSFER_TO_HOST_2D);
+        commands->transfer.rect = rect;
+        commands->transfer.offset = (uint64_t)y * backingPitch + x * sizeof(uint32_t);
+        commands->transfer.resourceId = VIRTIO_GPU_RESOURCE_ID;
+        commands->transfer.padding = 0;
+
+        prepare(&commands->flush.header, VIRTIO_GPU_CMD_RESOURCE_FLUSH);
+        commands->flush.rect = rect;
+        commands->flush.resourceId = VIRTIO_GPU_RESOURCE_ID;
+        commands->flush.padding = 0;
+
+        // The device processes commands in order, so the flush sees the transfer
+        Virtio::Buffer transfer[2] = {
+            { physicalOf(&commands->transfer), sizeof(struct TransferToHost2D) },
+            { physicalOf(&commands->responses[0]), sizeof(struct ControlHeader) },
+        };
+        Virtio::Buffer flush[2] = {
+            { physicalOf(&commands->flush), sizeof(struct ResourceFlush) },
+            { physicalOf(&commands->responses[1]), sizeof(struct ControlHeader) },
+        };
+        controlQueue.submit(transfer, 1, 1, commands);
+        controlQueue.submit(flush, 1, 1, commands);
+        wait(2);
+    });
+}
+
+} // !namespace VirtioGPU
@@ -0,0 +1,59 @@
+/**
+ * @file gpu.hpp
+ * @author Keeton Feavel (keeton@xyr.is)
+ * @brief Virtio GPU (2D) driver. The host scans out of a resource backed by
+ * guest memory, so only the damaged parts of a frame are ever transferred.
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @copyright Copyright the Xyris Contributors (c) 2026
+ *
+ */
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+
+namespace VirtioGPU {
+
+/**
+ * @brief Probe for a virtio GPU and create a 32 bits per pixel (XRGB) scanout
+ * of the given size, backed by newly allocated guest memory.
+ *
+ * @param width Horizontal resolution
+ * @param height Vertical resolution
+ * @return true Scanout was created
+ * @return false No device or the device rejected a command
+ */
+bool init(uint32_t width, uint32_t height);
+
+/**
+ * @brief Check whether a virtio GPU was found and initialized.
+ *
+ */
+bool isPresent();
+
+/**
+ * @brief Guest memory backing the scanout. Drawing here is not visible
+ * until the region is flushed.
+ *
+ */
+void* framebuffer();
+
+/**
+ * @brief Bytes per line of the scanout backing.
+ *
+ */
+uint32_t pitch();
+
+/**
+ * @brief Copy a rectangle of the backing to the host resource and update
+ * the display.
+ *
+ * @param x Horizontal position
+ * @param y Vertical position
+ * @param width Width of the rectangle
+ * @param height Height of the rectangle
+ */
+void flush(uint32_t x, uint32_t y, uint32_t width, uint32_t height);
+
+} // !namespace VirtioGPU
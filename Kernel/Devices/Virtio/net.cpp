@@ -0,0 +1,366 @@
+/**
+ * @file net.cpp
+ * @author Keeton Feavel (keeton@xyr.is)
+ * @brief Virtio network device driver. Receive buffers are pre-posted from
+ * the packet buffer pool and handed to the network stack without copying.
+ * Under load the driver switches from interrupts to budgeted polling.
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @copyright Copyright the Xyris Contributors (c) 2026
+ *
+ */
+#include <Arch/Arch.hpp>
+#include <Devices/Virtio/net.hpp>
+#include <Devices/Virtio/virtio.hpp>
+#include <Library/string.hpp>
+#include <Scheduler/tasks.hpp>
+#include <Logger.hpp>
+
+// Feature bits
+#define VIRTIO_NET_F_MAC            5
+#define VIRTIO_NET_F_MRG_RXBUF      15
+#define VIRTIO_NET_F_STATUS         16
+
+#define VIRTIO_NET_QUEUE_RX         0
+#define VIRTIO_NET_QUEUE_TX         1
+
+#define NET_RX_QUEUE_SIZE           128 // Receive buffers kept posted to the device
+#define NET_TX_QUEUE_SIZE           256
+#define NET_TX_BATCH                32  // Packets queued before the device is notified
+#define NET_TX_MAX_SEGMENTS         4   // Fragments per transmitted packet
+#define NET_POLL_BUDGET             64  // Packets processed per poll before yielding
+
+namespace VirtioNet {
+
+/**
+ * @brief Header preceding every packet. With VIRTIO_F_VERSION_1 the header
+ * always includes the buffer count, even without mergeable buffers.
+ *
+ */
+struct [[gnu::packed]] Header {
+    uint8_t flags;
+    uint8_t gsoType;
+    uint16_t headerLength;
+    uint16_t gsoSize;
+    uint16_t checksumStart;
+    uint16_t checksumOffset;
+    uint16_t numBuffers;
+};
+static_assert(sizeof(struct Header) == 12);
+
+struct [[gnu::packed]] Config {
+    uint8_t mac[NET_MAC_LENGTH];
+    uint16_t status;
+    uint16_t maxQueuePairs;
+};
+
+static Virtio::Device device;
+static Virtio::Queue rxQueue;
+static Virtio::Queue txQueue;
+static bool present = false;
+static bool mergeable = false;
+static uint8_t mac[NET_MAC_LENGTH];
+static ReceiveHandler receiveHandler = NULL;
+static struct Statistics stats;
+static size_t txPending = 0;
+
+static struct task pollTask;
+static volatile bool pollPending = false;
+static volatile bool pollWaiting = false;
+
+static void refill()
+{
+    bool posted = false;
+    while (rxQueue.freeCount()) {
+        Network::PacketBuffer* packet = Network::allocPacket();
+        if (!packet) {
+            break;
+        }
+
+        // The whole page is given to the device, header included
+        Virtio::Buffer buffer = { packet->physical, NET_PACKET_SIZE };
+        rxQueue.submit(&buffer, 0, 1, packet);
+        posted = true;
+    }
+
+    if (posted) {
+        rxQueue.kick();
+    }
+}
+
+static void reclaimTransmitted()
+{
+    Network::PacketBuffer* packet;
+    while ((packet = (Network::PacketBuffer*)txQueue.pop(NULL))) {
+        Network::releasePacket(packet);
+    }
+}
+
+static Network::PacketBuffer* popReceived(uint32_t* length)
+{
+    Network::PacketBuffer* packet = (Network::PacketBuffer*)rxQueue.pop(length);
+    if (packet) {
+        packet->offset = 0;
+        packet->length = (uint16_t)*length;
+    }
+
+    return packet;
+}
+
+/**
+ * @brief Process up to `budget` received packets.
+ *
+ * @return size_t Number of packets processed
+ */
+static size_t poll(size_t budget)
+{
+    size_t done = 0;
+    stats.polls++;
+
+    while (done < budget) {
+        uint32_t length;
+        Network::PacketBuffer* packet = popReceived(&length);
+        if (!packet) {
+            break;
+        }
+
+        struct Header* header = (struct Header*)packet->data();
+        uint16_t buffers = mergeable ? header->numBuffers : 1;
+        packet->pull(sizeof(struct Header));
+
+        // Mergeable buffers: the rest of the packet follows in the next
+        // used entries and is chained on as fragments rather than copied.
+        Network::PacketBuffer* tail = packet;
+        bool complete = true;
+        for (uint16_t i = 1; i < buffers; i++) {
+            Network::PacketBuffer* fragment = popReceived(&length);
+            if (!fragment) {
+                complete = false;
+                break;
+            }
+            tail->fragment = fragment;
+            tail = fragment;
+        }
+
+        done++;
+        if (!complete || !receiveHandler) {
+            stats.rxDropped++;
+            Network::releasePacket(packet);
+            continue;
+        }
+
+        stats.rxPackets++;
+        stats.rxBytes += packet->totalLength();
+        receiveHandler(packet);
+    }
+
+    refill();
+    Arch::CPU::criticalRegionNestable(reclaimTransmitted);
+    // Send anything the receive handlers queued in response
+    transmitFlush();
+    return done;
+}
+
+static void interruptCallback(uint8_t status)
+{
+    // The shared dispatcher already read (and so acknowledged) the ISR status
+    if (!(status & 1)) {
+        return;
+    }
+
+    // Further completions are picked up by polling until the queue drains
+    stats.interrupts++;
+    rxQueue.interruptsDisable();
+    if (pollWaiting) {
+        pollWaiting = false;
+        tasks_unblock(&pollTask);
+    } else {
+        pollPending = true;
+    }
+}
+
+static void pollWait()
+{
+    Arch::CPU::interruptsDisable();
+    if (!pollPending) {
+        pollWaiting = true;
+        // Interrupts are re-enabled once another task is scheduled
+        tasks_block_current(TASK_PAUSED);
+    }
+    pollPending = false;
+    Arch::CPU::interruptsEnable();
+}
+
+static void pollLoop()
+{
+    for (;;) {
+        if (poll(NET_POLL_BUDGET) == NET_POLL_BUDGET) {
+            // Still busy. Stay in polling mode but let other tasks run.
+            tasks_schedule();
+            continue;
+        }
+
+        // Idle. Re-arm the interrupt, making sure nothing slipped in while
+        // it was disabled, and sleep until the device has more packets.
+        if (rxQueue.interruptsEnable()) {
+            rxQueue.interruptsDisable();
+            continue;
+        }
+
+        pollWait();
+    }
+}
+
+void init()
+{
+    PCI::Device* pci = Virtio::find(VIRTIO_TYPE_NET, VIRTIO_TRANSITIONAL_NET);
+    if (!pci) {
+        Logger::Debug(__func__, "No virtio network device found");
+        return;
+    }
+
+    if (!device.init(pci)) {
+        Logger::Warning(__func__, "Failed to initialize virtio network device");
+        return;
+    }
+
+    uint64_t features = device.negotiate(
+        (1ULL << VIRTIO_NET_F_MAC) | (1ULL << VIRTIO_NET_F_MRG_RXBUF) | (1ULL << VIRTIO_NET_F_STATUS));
+    if (!features) {
+        Logger::Warning(__func__, "Virtio network feature negotiation failed");
+        return;
+    }
+    mergeable = features & (1ULL << VIRTIO_NET_F_MRG_RXBUF);
+
+    if (!rxQueue.init(&device, VIRTIO_NET_QUEUE_RX, NET_RX_QUEUE_SIZE)
+        || !txQueue.init(&device, VIRTIO_NET_QUEUE_TX, NET_TX_QUEUE_SIZE)) {
+        Logger::Warning(__func__, "Failed to initialize virtio network queues");
+        device.fail();
+        return;
+    }
+
+    // Transmit completions are reaped lazily, never by interrupt
+    txQueue.interruptsDisable();
+
+    if (features & (1ULL << VIRTIO_NET_F_MAC)) {
+        volatile struct Config* config = device.config<struct Config>();
+        for (size_t i = 0; i < NET_MAC_LENGTH; i++) {
+            mac[i] = config->mac[i];
+        }
+    }
+
+    if (!device.registerInterrupt(interruptCallback)) {
+        Logger::Warning(__func__, "Virtio network device has no usable IRQ");
+        device.fail();
+        return;
+    }
+
+    refill();
+    device.ready();
+    present = true;
+    tasks_new(pollLoop, &pollTask, TASK_READY, "virtio-net");
+
+    Logger::Info(
+        __func__,
+        "Virtio network device %02X:%02X:%02X:%02X:%02X:%02X (IRQ %u, %s)",
+        mac[0], mac[1], mac[2], mac[3], mac[4], mac[5],
+        device.interruptLine(),
+        mergeable ? "mergeable" : "single buffer");
+}
+
+bool isPresent()
+{
+    return present;
+}
+
+const uint8_t* macAddress()
+{
+    return mac;
+}
+
+void setReceiveHandler(ReceiveHandler handler)
+{
+    receiveHandler = handler;
+}
+
+bool transmit(Network::PacketBuffer* packet)
+{
+    if (!present) {
+        Network::releasePacket(packet);
+        return false;
+    }
+
+    struct Header* header = (struct Header*)packet->push(sizeof(struct Header));
+    if (!header) {
+        stats.txDropped++;
+        Network::releasePacket(packet);
+        return false;
+    }
+    memset(header, 0, sizeof(struct Header));
+
+    Virtio::Buffer segments[NET_TX_MAX_SEGMENTS];
+    size_t count = 0;
+    for (Network::PacketBuffer* frag = packet; frag; frag = frag->fragment) {
+        if (count == NET_TX_MAX_SEGMENTS) {
+            stats.txDropped++;
+            Network::releasePacket(packet);
+            return false;
+        }
+        segments[count++] = { frag->dataPhysical(), frag->length };
+    }
+
+    bool queued = false;
+    size_t length = packet->totalLength() - sizeof(struct Header);
+    Arch::CPU::criticalRegionNestable([&]() {
+        queued = txQueue.submit(segments, count, 0, packet);
+        if (!queued) {
+            // Ring is full. Reclaim completed packets and try once more.
+            reclaimTransmitted();
+            queued = txQueue.submit(segments, count, 0, packet);
+        }
+
+        if (!queued) {
+            stats.txDropped++;
+            return;
+        }
+
+        stats.txPackets++;
+        stats.txBytes += length;
+        if (++txPending >= NET_TX_BATCH) {
+            txPending = 0;
+            stats.txKicks++;
+            txQueue.kick();
+        }
+    });
+
+    if (!queued) {
+        Network::releasePacket(packet);
+    }
+
+    return queued;
+}
+
+void transmitFlush()
+{
+    if (!present) {
+        return;
+    }
+
+    Arch::CPU::criticalRegionNestable([]() {
+        if (txPending) {
+            txPending = 0;
+            stats.txKicks++;
+            txQueue.kick();
+        }
+    });
+}
+
+void statistics(struct Statistics& out)
+{
+    Arch::CPU::criticalRegionNestable([&out]() {
+        out = stats;
+    });
+}
+
+} // !namespace VirtioNet
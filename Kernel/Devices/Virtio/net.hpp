@@ -0,0 +1,95 @@
+/**
+ * @file net.hpp
+ * @author Keeton Feavel (keeton@xyr.is)
+ * @brief Virtio network device driver. Receive buffers are pre-posted from
+ * the packet buffer pool and handed to the network stack without copying.
+ * Under load the driver switches from interrupts to budgeted polling.
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @copyright Copyright the Xyris Contributors (c) 2026
+ *
+ */
+#pragma once
+#include <Network/Network.hpp>
+#include <Network/PacketBuffer.hpp>
+#include <stddef.h>
+#include <stdint.h>
+
+namespace VirtioNet {
+
+/**
+ * @brief Driver counters. Packet rates are derived by sampling these.
+ *
+ */
+struct Statistics {
+    uint64_t rxPackets;
+    uint64_t rxBytes;
+    uint64_t rxDropped;
+    uint64_t txPackets;
+    uint64_t txBytes;
+    uint64_t txDropped;
+    uint64_t txKicks;
+    uint64_t interrupts;
+    uint64_t polls;
+};
+
+/**
+ * @brief Called from the poll task for every received packet. The handler
+ * takes ownership of the packet and must release it when done.
+ *
+ */
+typedef void (*ReceiveHandler)(Network::PacketBuffer* packet);
+
+/**
+ * @brief Probe for a virtio network device and start its poll task.
+ * Must be called after the packet pool and scheduler are initialized.
+ *
+ */
+void init();
+
+/**
+ * @brief Check whether a virtio network device was found and initialized.
+ *
+ */
+bool isPresent();
+
+/**
+ * @brief Hardware (MAC) address of the device.
+ *
+ */
+const uint8_t* macAddress();
+
+/**
+ * @brief Set the handler that received packets are delivered to. Packets
+ * received without a handler are dropped.
+ *
+ * @param handler Receive handler
+ */
+void setReceiveHandler(ReceiveHandler handler);
+
+/**
+ * @brief Queue a packet for transmission. The driver takes ownership of
+ * the packet and releases it once the device is done with it. The device
+ * is notified in batches, or when `transmitFlush()` is called.
+ *
+ * @param packet Ethernet frame with at least 12 bytes of headroom
+ * @return true Packet was queued
+ * @return false Packet was dropped
+ */
+bool transmit(Network::PacketBuffer* packet);
+
+/**
+ * @brief Notify the device of any packets queued since the last notification.
+ *
+ */
+void transmitFlush();
+
+/**
+ * @brief Copy the current driver counters.
+ *
+ * @param stats Destination for the counters
+ */
+void statistics(struct Statistics& stats);
+
+} // !namespace VirtioNet
@@ -0,0 +1,424 @@
+/**
+ * @file virtio.cpp
+ * @author Keeton Feavel (keeton@xyr.is)
+ * @brief Virtio 1.0 PCI transport and split virtqueue implementation
+ * shared by all virtio device drivers.
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @copyright Copyright the Xyris Contributors (c) 2026
+ *
+ */
+#include <Arch/Arch.hpp>
+#include <Arch/Memory.hpp>
+#include <Devices/Virtio/virtio.hpp>
+#include <Library/string.hpp>
+#include <Memory/heap.hpp>
+#include <Memory/paging.hpp>
+#include <Logger.hpp>
+
+// Virtio PCI capability configuration types
+#define VIRTIO_PCI_CAP_COMMON_CFG   1
+#define VIRTIO_PCI_CAP_NOTIFY_CFG   2
+#define VIRTIO_PCI_CAP_ISR_CFG      3
+#define VIRTIO_PCI_CAP_DEVICE_CFG   4
+
+// Virtio PCI capability field offsets
+#define VIRTIO_PCI_CAP_CFG_TYPE     3
+#define VIRTIO_PCI_CAP_BAR          4
+#define VIRTIO_PCI_CAP_OFFSET       8
+#define VIRTIO_PCI_CAP_LENGTH       12
+#define VIRTIO_PCI_CAP_NOTIFY_MULT  16
+
+#define VIRTQ_DESC_NONE             0xFFFF
+
+#define VIRTIO_INTERRUPT_MAX        8       // Devices that can share INTx lines
+
+namespace Virtio {
+
+// Compiler barrier. x86 does not reorder stores with other stores, so this
+// is sufficient to publish descriptors before the available index.
+[[gnu::always_inline]] static inline void barrier()
+{
+    asm volatile("" ::: "memory");
+}
+
+// Full fence. Needed when a store (available index) must be visible before
+// a subsequent load (used ring flags). The locked add works on every i686.
+[[gnu::always_inline]] static inline void fence()
+{
+    asm volatile("lock; addl $0, (%%esp)" ::: "memory", "cc");
+}
+
+PCI::Device* find(uint16_t type, uint16_t transitionalId)
+{
+    PCI::Device* dev = PCI::find(VIRTIO_PCI_VENDOR, (uint16_t)(VIRTIO_PCI_MODERN_BASE + type));
+    if (!dev && transitionalId) {
+        dev = PCI::find(VIRTIO_PCI_VENDOR, transitionalId);
+    }
+
+    return dev;
+}
+
+/*
+ *  ___          _
+ * |   \ _____ _(_)__ ___
+ * | |) / -_) V / / _/ -_)
+ * |___/\___|\_/|_\__\___|
+ */
+
+Device::Device()
+    : m_pci(NULL)
+    , m_common(NULL)
+    , m_notifyBase(NULL)
+    , m_notifyMultiplier(0)
+    , m_isr(NULL)
+    , m_deviceConfig(NULL)
+{
+}
+
+volatile uint8_t* Device::mapCapability(uint8_t cap)
+{
+    uint8_t barIndex = PCI::readConfigByte(m_pci, (uint8_t)(cap + VIRTIO_PCI_CAP_BAR));
+    uint32_t offset = PCI::readConfigLong(m_pci, (uint8_t)(cap + VIRTIO_PCI_CAP_OFFSET));
+    uint32_t length = PCI::readConfigLong(m_pci, (uint8_t)(cap + VIRTIO_PCI_CAP_LENGTH));
+
+    PCI::Bar bar;
+    if (!PCI::readBar(m_pci, barIndex, bar) || bar.isIO) {
+        Logger::Warning(__func__, "Virtio capability uses unsupported BAR%u", barIndex);
+        return NULL;
+    }
+
+    uint64_t start = bar.address + offset;
+    if (start + length > 0x100000000ULL) {
+        Logger::Warning(__func__, "Virtio BAR%u is above 4GiB", barIndex);
+        return NULL;
+    }
+
+    // MMIO regions are identity mapped, same as the framebuffer
+    uintptr_t base = Arch::Memory::pageAlign((uintptr_t)start);
+    uintptr_t end = Arch::Memory::pageAlignUp((uintptr_t)start + length);
+    Memory::mapKernelRangeVirtual(Memory::Section(base, end - base));
+
+    return (volatile uint8_t*)(uintptr_t)start;
+}
+
+bool Device::init(PCI::Device* pci)
+{
+    m_pci = pci;
+
+    for (uint8_t cap = PCI::findCapability(pci, PCI_CAPABILITY_VENDOR); cap; cap = PCI::findCapability(pci, PCI_CAPABILITY_VENDOR, cap)) {
+        uint8_t type = PCI::readConfigByte(pci, (uint8_t)(cap + VIRTIO_PCI_CAP_CFG_TYPE));
+        // The specification asks drivers to use the first capability of each type
+        switch (type) {
+            case VIRTIO_PCI_CAP_COMMON_CFG:
+                if (!m_common)
+                    m_common = (volatile struct CommonConfig*)mapCapability(cap);
+                break;
+            case VIRTIO_PCI_CAP_NOTIFY_CFG:
+                if (!m_notifyBase) {
+                    m_notifyBase = mapCapability(cap);
+                    m_notifyMultiplier = PCI::readConfigLong(pci, (uint8_t)(cap + VIRTIO_PCI_CAP_NOTIFY_MULT));
+                }
+                break;
+            case VIRTIO_PCI_CAP_ISR_CFG:
+                if (!m_isr)
+                    m_isr = mapCapability(cap);
+                break;
+            case VIRTIO_PCI_CAP_DEVICE_CFG:
+                if (!m_deviceConfig)
+                    m_deviceConfig = mapCapability(cap);
+                break;
+            default:
+                break;
+        }
+    }
+
+    if (!m_common || !m_notifyBase || !m_isr) {
+        Logger::Warning(__func__, "Device %04X is not a modern virtio device", pci->deviceId);
+        return false;
+    }
+
+    PCI::enableBusMastering(pci);
+
+    // Reset the device and wait for the reset to complete
+    m_common->deviceStatus = 0;
+    while (m_common->deviceStatus != 0) {
+        asm volatile("pause");
+    }
+
+    m_common->deviceStatus = VIRTIO_STATUS_ACKNOWLEDGE;
+    m_common->deviceStatus = VIRTIO_STATUS_ACKNOWLEDGE | VIRTIO_STATUS_DRIVER;
+    return true;
+}
+
+uint64_t Device::negotiate(uint64_t wanted)
+{
+    wanted |= 1ULL << VIRTIO_F_VERSION_1;
+
+    m_common->deviceFeatureSelect = 0;
+    uint64_t offered = m_common->deviceFeature;
+    m_common->deviceFeatureSelect = 1;
+    offered |= (uint64_t)m_common->deviceFeature << 32;
+
+    uint64_t accepted = offered & wanted;
+    if (!(accepted & (1ULL << VIRTIO_F_VERSION_1))) {
+        fail();
+        return 0;
+    }
+
+    m_common->driverFeatureSelect = 0;
+    m_common->driverFeature = (uint32_t)accepted;
+    m_common->driverFeatureSelect = 1;
+    m_common->driverFeature = (uint32_t)(accepted >> 32);
+
+    m_common->deviceStatus = m_common->deviceStatus | VIRTIO_STATUS_FEATURES_OK;
+    if (!(m_common->deviceStatus & VIRTIO_STATUS_FEATURES_OK)) {
+        fail();
+        return 0;
+    }
+
+    return accepted;
+}
+
+void Device::ready()
+{
+    m_common->deviceStatus = m_common->deviceStatus | VIRTIO_STATUS_DRIVER_OK;
+}
+
+void Device::fail()
+{
+    m_common->deviceStatus = m_common->deviceStatus | VIRTIO_STATUS_FAILED;
+}
+
+uint8_t Device::interruptStatus()
+{
+    // Reading the ISR status register also de-asserts the INTx line
+    return *m_isr;
+}
+
+static struct InterruptEntry {
+    Device* device;
+    Device::InterruptHandler handler;
+} interruptEntries[VIRTIO_INTERRUPT_MAX];
+static size_t interruptEntryCount;
+static uint16_t interruptLines;     // Lines owned by the dispatcher
+
+static void interruptDispatch(struct registers* regs)
+{
+    uint8_t line = (uint8_t)(regs->int_num - Interrupts::INTERRUPT_0);
+    size_t count = __atomic_load_n(&interruptEntryCount, __ATOMIC_ACQUIRE);
+    // Every device on the line has to be checked since any of them
+    // (or several) may be asserting it
+    for (size_t i = 0; i < count; i++) {
+        struct InterruptEntry* entry = &interruptEntries[i];
+        if (entry->device->interruptLine() != line) {
+            continue;
+        }
+
+        uint8_t status = entry->device->interruptStatus();
+        if (status) {
+            entry->handler(status);
+        }
+    }
+}
+
+bool Device::registerInterrupt(InterruptHandler handler)
+{
+    uint8_t line = interruptLine();
+    if (line >= ARCH_INTERRUPT_NUM) {
+        return false;
+    }
+
+    uint8_t vector = (uint8_t)(Interrupts::INTERRUPT_0 + line);
+    bool owned = interruptLines & (1 << line);
+    if (!owned && Interrupts::isRegistered(vector)) {
+        Logger::Warning(__func__, "IRQ %u is in use by another driver", line);
+        return false;
+    }
+    if (interruptEntryCount >= VIRTIO_INTERRUPT_MAX) {
+        Logger::Warning(__func__, "Too many virtio interrupt handlers");
+        return false;
+    }
+
+    // Publish the entry before the dispatcher can observe it
+    interruptEntries[interruptEntryCount] = { this, handler };
+    __atomic_store_n(&interruptEntryCount, interruptEntryCount + 1, __ATOMIC_RELEASE);
+    if (!owned) {
+        interruptLines |= (uint16_t)(1 << line);
+        Interrupts::registerHandler(vector, interruptDispatch);
+    }
+
+    return true;
+}
+
+/*
+ *   ___
+ *  / _ \ _  _ ___ _  _ ___
+ * | (_) | || / -_) || / -_)
+ *  \__\_\\_,_\___|\_,_\___|
+ */
+
+Queue::Queue()
+    : m_device(NULL)
+    , m_index(0)
+    , m_size(0)
+    , m_freeHead(VIRTQ_DESC_NONE)
+    , m_freeCount(0)
+    , m_availIndex(0)
+    , m_lastUsed(0)
+    , m_pending(0)
+    , m_desc(NULL)
+    , m_avail(NULL)
+    , m_used(NULL)
+    , m_notify(NULL)
+    , m_tokens(NULL)
+{
+}
+
+bool Queue::init(Device* device, uint16_t index, uint16_t maxSize)
+{
+    volatile struct CommonConfig* common = device->m_common;
+    common->queueSelect = index;
+    uint16_t size = common->queueSize;
+    if (size == 0) {
+        return false;
+    }
+
+    if (size > maxSize)
+        size = maxSize;
+    if (size > VIRTQ_MAX_SIZE)
+        size = VIRTQ_MAX_SIZE;
+    // Split virtqueue sizes must be a power of two
+    while (size & (size - 1)) {
+        size &= (uint16_t)(size - 1);
+    }
+
+    // With at most 256 entries each ring area fits in a single (zeroed) frame,
+    // so physical contiguity within an area is guaranteed.
+    m_desc = (volatile struct Descriptor*)Memory::newFrame();
+    m_avail = (volatile struct Available*)Memory::newFrame();
+    m_used = (volatile struct Used*)Memory::newFrame();
+    m_tokens = (void**)malloc(sizeof(void*) * size);
+    if (!m_desc || !m_avail || !m_used || !m_tokens) {
+        return false;
+    }
+
+    memset(m_tokens, 0, sizeof(void*) * size);
+
+    // Chain every descriptor onto the free list
+    for (uint16_t i = 0; i < size; i++) {
+        m_desc[i].next = (uint16_t)(i + 1 < size ? i + 1 : VIRTQ_DESC_NONE);
+    }
+
+    m_device = device;
+    m_index = index;
+    m_size = size;
+    m_freeHead = 0;
+    m_freeCount = size;
+    m_availIndex = 0;
+    m_lastUsed = 0;
+    m_pending = 0;
+
+    common->queueSize = size;
+    common->queueDesc = Memory::virtToPhys((const void*)m_desc);
+    common->queueDriver = Memory::virtToPhys((const void*)m_avail);
+    common->queueDevice = Memory::virtToPhys((const void*)m_used);
+    m_notify = (volatile uint16_t*)(device->m_notifyBase + common->queueNotifyOff * device->m_notifyMultiplier);
+    common->queueEnable = 1;
+
+    return true;
+}
+
+bool Queue::submit(const Buffer* buffers, size_t readable, size_t writable, void* token)
+{
+    size_t count = readable + writable;
+    if (count == 0 || count > m_freeCount) {
+        return false;
+    }
+
+    uint16_t head = m_freeHead;
+    uint16_t idx = head;
+    for (size_t i = 0; i < count; i++) {
+        volatile struct Descriptor* desc = &m_desc[idx];
+        desc->address = buffers[i].physical;
+        desc->length = buffers[i].length;
+        desc->flags = (uint16_t)((i < readable ? 0 : VIRTQ_DESC_F_WRITE) | (i + 1 < count ? VIRTQ_DESC_F_NEXT : 0));
+        idx = desc->next;
+    }
+
+    // The last descriptor keeps its free list link. It is overwritten when
+    // the chain completes and is spliced back onto the free list.
+    m_freeHead = idx;
+    m_freeCount = (uint16_t)(m_freeCount - count);
+    m_tokens[head] = token;
+
+    m_avail->ring[(uint16_t)(m_availIndex + m_pending) & (m_size - 1)] = head;
+    m_pending++;
+    return true;
+}
+
+void Queue::kick()
+{
+    if (!m_pending) {
+        return;
+    }
+
+    // Descriptors and ring entries must be visible before the index moves
+    barrier();
+    m_availIndex = (uint16_t)(m_availIndex + m_pending);
+    m_avail->index = m_availIndex;
+    m_pending = 0;
+
+    // The device may suppress notifications while it is already processing
+    fence();
+    if (!(m_used->flags & VIRTQ_USED_F_NO_NOTIFY)) {
+        *m_notify = m_index;
+    }
+}
+
+void* Queue::pop(uint32_t* length)
+{
+    if (!hasUsed()) {
+        return NULL;
+    }
+
+    // Read the used element only after observing the index update
+    barrier();
+    volatile struct UsedElement* elem = &m_used->ring[m_lastUsed & (m_size - 1)];
+    uint16_t head = (uint16_t)elem->id;
+    if (length) {
+        *length = elem->length;
+    }
+    m_lastUsed++;
+
+    // Walk to the end of the chain and splice it back onto the free list
+    uint16_t tail = head;
+    uint16_t count = 1;
+    while (m_desc[tail].flags & VIRTQ_DESC_F_NEXT) {
+        tail = m_desc[tail].next;
+        count++;
+    }
+    m_desc[tail].next = m_freeHead;
+    m_freeHead = head;
+    m_freeCount = (uint16_t)(m_freeCount + count);
+
+    void* token = m_tokens[head];
+    m_tokens[head] = NULL;
+    return token;
+}
+
+void Queue::interruptsDisable()
+{
+    m_avail->flags = m_avail->flags | VIRTQ_AVAIL_F_NO_INTERRUPT;
+}
+
+bool Queue::interruptsEnable()
+{
+    m_avail->flags = m_avail->flags & ~VIRTQ_AVAIL_F_NO_INTERRUPT;
+    // Completions that raced with re-enabling would otherwise go unnoticed
+    fence();
+    return hasUsed();
+}
+
+} // !namespace Virtio
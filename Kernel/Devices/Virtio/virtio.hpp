@@ -0,0 +1,293 @@
+/**
+ * @file virtio.hpp
+ * @author Keeton Feavel (keeton@xyr.is)
+ * @brief Virtio 1.0 PCI transport and split virtqueue implementation
+ * shared by all virtio device drivers.
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @copyright Copyright the Xyris Contributors (c) 2026
+ *
+ * References:
+ *         https://docs.oasis-open.org/virtio/virtio/v1.1/virtio-v1.1.html
+ */
+#pragma once
+#include <Devices/PCI/pci.hpp>
+#include <stddef.h>
+#include <stdint.h>
+
+#define VIRTIO_PCI_VENDOR           0x1AF4
+#define VIRTIO_PCI_MODERN_BASE      0x1040  // Modern device ID = base + virtio device type
+
+// Virtio device types (and their transitional PCI device IDs)
+#define VIRTIO_TYPE_NET             1
+#define VIRTIO_TYPE_CONSOLE         3
+#define VIRTIO_TYPE_GPU             16
+#define VIRTIO_TRANSITIONAL_NET     0x1000
+#define VIRTIO_TRANSITIONAL_CONSOLE 0x1003
+
+// Device status bits
+#define VIRTIO_STATUS_ACKNOWLEDGE   1
+#define VIRTIO_STATUS_DRIVER        2
+#define VIRTIO_STATUS_DRIVER_OK     4
+#define VIRTIO_STATUS_FEATURES_OK   8
+#define VIRTIO_STATUS_FAILED        128
+
+// Device independent feature bits
+#define VIRTIO_F_RING_EVENT_IDX     29
+#define VIRTIO_F_VERSION_1          32
+
+// Descriptor flags
+#define VIRTQ_DESC_F_NEXT           1
+#define VIRTQ_DESC_F_WRITE          2
+
+// Ring flags
+#define VIRTQ_AVAIL_F_NO_INTERRUPT  1
+#define VIRTQ_USED_F_NO_NOTIFY      1
+
+// Largest queue that keeps every ring area within a single page
+#define VIRTQ_MAX_SIZE              256
+
+namespace Virtio {
+
+struct [[gnu::packed]] Descriptor {
+    uint64_t address;   // Guest physical address of the buffer
+    uint32_t length;    // Buffer length in bytes
+    uint16_t flags;     // VIRTQ_DESC_F_*
+    uint16_t next;      // Next descriptor in the chain (if VIRTQ_DESC_F_NEXT)
+};
+static_assert(sizeof(struct Descriptor) == 16);
+
+struct [[gnu::packed]] Available {
+    uint16_t flags;
+    uint16_t index;
+    uint16_t ring[];
+};
+
+struct [[gnu::packed]] UsedElement {
+    uint32_t id;        // Head descriptor of the completed chain
+    uint32_t length;    // Bytes written into device-writable buffers
+};
+
+struct [[gnu::packed]] Used {
+    uint16_t flags;
+    uint16_t index;
+    struct UsedElement ring[];
+};
+
+/**
+ * @brief Virtio PCI common configuration structure (VIRTIO_PCI_CAP_COMMON_CFG)
+ *
+ */
+struct [[gnu::packed]] CommonConfig {
+    uint32_t deviceFeatureSelect;
+    uint32_t deviceFeature;
+    uint32_t driverFeatureSelect;
+    uint32_t driverFeature;
+    uint16_t msixConfig;
+    uint16_t numQueues;
+    uint8_t deviceStatus;
+    uint8_t configGeneration;
+    uint16_t queueSelect;
+    uint16_t queueSize;
+    uint16_t queueMsixVector;
+    uint16_t queueEnable;
+    uint16_t queueNotifyOff;
+    uint64_t queueDesc;
+    uint64_t queueDriver;
+    uint64_t queueDevice;
+};
+static_assert(sizeof(struct CommonConfig) == 0x38);
+
+/**
+ * @brief A physically addressed buffer segment handed to the device.
+ *
+ */
+struct Buffer {
+    uintptr_t physical;
+    uint32_t length;
+};
+
+class Device;
+
+/**
+ * @brief Split virtqueue. Buffers are published to the available ring in
+ * batches and the device is only notified on `kick()`, and only if it has
+ * not asked to suppress notifications.
+ *
+ */
+class Queue {
+public:
+    Queue();
+
+    /**
+     * @brief Allocate ring memory and register the queue with the device.
+     *
+     * @param device Owning virtio device
+     * @param index Queue index
+     * @param maxSize Upper bound on the number of descriptors
+     * @return true Queue is ready for use
+     */
+    bool init(Device* device, uint16_t index, uint16_t maxSize);
+
+    /**
+     * @brief Place a descriptor chain on the available ring without notifying
+     * the device. Device-readable buffers must come before device-writable ones.
+     *
+     * @param buffers Buffer segments
+     * @param readable Number of device-readable segments
+     * @param writable Number of device-writable segments
+     * @param token Opaque value returned by `pop()` on completion
+     * @return true Chain was queued
+     * @return false Not enough free descriptors
+     */
+    bool submit(const Buffer* buffers, size_t readable, size_t writable, void* token);
+
+    /**
+     * @brief Publish all chains submitted since the last kick and notify
+     * the device if required.
+     *
+     */
+    void kick();
+
+    /**
+     * @brief Reclaim the next completed chain from the used ring.
+     *
+     * @param length Bytes written by the device (may be NULL)
+     * @return void* Token passed to `submit()` or NULL if nothing completed
+     */
+    void* pop(uint32_t* length);
+
+    /**
+     * @brief Check whether the device has completed any chains.
+     *
+     */
+    bool hasUsed() { return m_lastUsed != m_used->index; }
+
+    /**
+     * @brief Ask the device not to interrupt when chains complete. Used to
+     * switch between interrupt and polling mode.
+     *
+     */
+    void interruptsDisable();
+
+    /**
+     * @brief Re-enable completion interrupts.
+     *
+     * @return true Completions arrived while interrupts were disabled and
+     * the caller should poll again to avoid a lost wakeup.
+     */
+    bool interruptsEnable();
+
+    uint16_t size() { return m_size; }
+    uint16_t freeCount() { return m_freeCount; }
+    uint16_t index() { return m_index; }
+
+private:
+    Device* m_device;
+    uint16_t m_index;
+    uint16_t m_size;
+    uint16_t m_freeHead;
+    uint16_t m_freeCount;
+    uint16_t m_availIndex;
+    uint16_t m_lastUsed;
+    uint16_t m_pending;
+    volatile struct Descriptor* m_desc;
+    volatile struct Available* m_avail;
+    volatile struct Used* m_used;
+    volatile uint16_t* m_notify;
+    void** m_tokens;
+};
+
+/**
+ * @brief Virtio device bound to a PCI function using the modern
+ * (capability based) virtio-pci transport.
+ *
+ */
+class Device {
+public:
+    typedef void (*InterruptHandler)(uint8_t status);
+
+    Device();
+
+    /**
+     * @brief Locate the virtio capabilities, map their BARs, and reset the device.
+     *
+     * @param pci PCI function of the device
+     * @return true Device is usable
+     */
+    bool init(PCI::Device* pci);
+
+    /**
+     * @brief Negotiate features. VIRTIO_F_VERSION_1 is always requested.
+     *
+     * @param wanted Feature bits the driver supports
+     * @return uint64_t Features accepted by both sides (0 on failure)
+     */
+    uint64_t negotiate(uint64_t wanted);
+
+    /**
+     * @brief Tell the device that the driver is ready.
+     *
+     */
+    void ready();
+
+    /**
+     * @brief Mark the device as failed.
+     *
+     */
+    void fail();
+
+    /**
+     * @brief Read and acknowledge the ISR status register.
+     *
+     * @return uint8_t ISR status (bit 0 = queue interrupt, bit 1 = config change)
+     */
+    uint8_t interruptStatus();
+
+    /**
+     * @brief Attach a handler to the device's INTx line. Virtio devices
+     * commonly share a line, so a single dispatcher is installed per line
+     * and it polls the ISR status of every device attached to it. The
+     * handler is only called when the device's status is non-zero.
+     *
+     * @param handler Called from interrupt context with the ISR status
+     * @return true Handler attached
+     * @return false Line unusable or owned by a non-virtio driver
+     */
+    bool registerInterrupt(InterruptHandler handler);
+
+    /**
+     * @brief Device specific configuration structure.
+     *
+     */
+    template<typename T>
+    volatile T* config() { return (volatile T*)m_deviceConfig; }
+
+    PCI::Device* pci() { return m_pci; }
+    uint8_t interruptLine() { return m_pci->interruptLine; }
+
+private:
+    friend class Queue;
+
+    volatile uint8_t* mapCapability(uint8_t cap);
+
+    PCI::Device* m_pci;
+    volatile struct CommonConfig* m_common;
+    volatile uint8_t* m_notifyBase;
+    uint32_t m_notifyMultiplier;
+    volatile uint8_t* m_isr;
+    volatile uint8_t* m_deviceConfig;
+};
+
+/**
+ * @brief Find a virtio device of the given type by either its modern or
+ * transitional PCI device ID.
+ *
+ * @param type Virtio device type
+ * @param transitionalId Transitional PCI device ID (0 if none)
+ * @return PCI::Device* PCI function or NULL if not present
+ */
+PCI::Device* find(uint16_t type, uint16_t transitionalId);
+
+} // !namespace Virtio
@@ -9,6 +9,7 @@
  *
  */
 #include "Logger.hpp"
+#include "Metrics.hpp"
 #include "Panic.hpp"
 // System library functions
 #include <Library/stdio.hpp>
@@ -18,18 +19,30 @@
 #include <Bootloader/Handoff.hpp>
 // Architecture specific code
 #include <Arch/Arch.hpp>
+#include <Arch/i686/timer.hpp> // TODO: Remove ASAP
 // Memory management & paging
 #include <Memory/paging.hpp>
 #include <Memory/Physical.hpp>
 // Generic devices
+#include <Devices/ACPI/acpi.hpp>
+#include <Devices/Clock/hpet.hpp>
 #include <Devices/Clock/rtc.hpp>
 #include <Devices/Graphics/console.hpp>
 #include <Devices/Graphics/graphics.hpp>
+#include <Devices/PCI/pci.hpp>
 #include <Devices/PCSpeaker/spkr.hpp>
+#include <Devices/PS2/keyboard.hpp>
 #include <Devices/Serial/rs232.hpp>
+#include <Devices/Virtio/console.hpp>
+#include <Network/Network.hpp>
+// User mode
+#include <Userspace/Process.hpp>
 // Apps
+#include <Applications/netbench.hpp>
 #include <Applications/primes.hpp>
 #include <Applications/spinner.hpp>
+#include <Applications/top.hpp>
+#include <Applications/udpstream.hpp>
 // Meta
 #include <stdint.h>
 
@@ -41,6 +54,7 @@
 
 static void printSplash();
 static void bootTone();
+static void startModules(Boot::Handoff& handoff);
 
 // TODO: Find a better way of doing this in the future
 //       Maybe some sort of way to register driver init
@@ -65,6 +79,23 @@ static void printSplash()
     Console::printf("Commit %s (v%s.%s.%s) built on %s at %s.\n\n", COMMIT, VER_MAJOR, VER_MINOR, VER_PATCH, __DATE__, __TIME__);
 }
 
+static void startModules(Boot::Handoff& handoff)
+{
+    // every boot module is taken to be a user program
+    Userspace::init();
+    for (size_t idx = 0; idx < handoff.ModuleCount(); idx++) {
+        const Boot::HandoffModule& module = handoff.Module(idx);
+        // the image is read for as long as the process runs, so it has to
+        // stay mapped and only modules entirely inside the physmap qualify
+        void* image = Memory::physToVirt(module.begin);
+        if (!image || module.end <= module.begin || !Memory::physToVirt(module.end - 1)) {
+            Logger::Warning(__func__, "Module %s is not in the physmap, not starting it", module.name);
+            continue;
+        }
+        Userspace::Process::spawn(module.name, image, module.end - module.begin);
+    }
+}
+
 static void bootTone()
 {
     // Beep beep!
@@ -93,8 +124,18 @@ void kernelEntry(void* info, uint32_t magic)
     Boot::Handoff handoff(info, magic);
     Memory::Physical::Manager::initialize(handoff.MemoryMap());
     Memory::init();
+    PCI::init();
     Graphics::init(handoff.FramebufferInfo());
+    VirtioConsole::init();
+    ACPI::init(handoff.RSDP());
+    HPET::init();
+    // The HPET replaces the PIT as the tick source when it can
+    if (HPET::eventStart(0, 1000000000ULL / TIMER_FREQUENCY, true, timer_handle_tick)) {
+        Logger::Info(__func__, "Timer tick driven by the HPET");
+    }
     tasks_init();
+    PS2::Keyboard::init();
+    Network::init();
 
     printSplash();
     Time::TimeDescriptor time;
@@ -106,10 +147,15 @@ void kernelEntry(void* info, uint32_t magic)
         time.getMinutes());
     Logger::Info(__func__, "%s\n%s\n", Arch::CPU::vendor(), Arch::CPU::model());
 
-    struct task compute, status, spinner;
+    struct task compute, status, spinner, netbench, udpstream, metrics, top;
     tasks_new(Apps::find_primes, &compute, TASK_READY, "prime_compute");
     tasks_new(Apps::show_primes, &status, TASK_READY, "prime_display");
     tasks_new(Apps::spinner, &spinner, TASK_READY, "spinner");
+    tasks_new(Apps::net_bench, &netbench, TASK_READY, "net_bench");
+    tasks_new(Apps::udp_stream, &udpstream, TASK_READY, "udp_stream");
+    tasks_new(Metrics::exporter, &metrics, TASK_READY, "metrics");
+    tasks_new(Apps::top, &top, TASK_READY, "top");
+    startModules(handoff);
     // Now that we're done make a joyful noise
     bootTone();
 
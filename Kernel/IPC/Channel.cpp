@@ -0,0 +1,48 @@
+/**
+ * @file Channel.cpp
+ * @author Keeton Feavel (keeton@xyr.is)
+ * @brief Channel payload allocation
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @copyright Copyright the Xyris Contributors (c) 2026
+ *
+ */
+#include <Arch/Memory.hpp>
+#include <IPC/Channel.hpp>
+#include <Memory/paging.hpp>
+
+namespace IPC {
+
+Payload allocate(size_t size)
+{
+    // every kernel task shares the kernel address space, so handing the
+    // pointer over is all it takes to move the pages to another task
+    if (size == 0) {
+        return { NULL, 0 };
+    }
+
+    // a single page comes straight from the physmap without touching page tables
+    void* data = (size <= ARCH_PAGE_SIZE) ? Memory::newFrame() : Memory::newPage(size - 1);
+    if (data == NULL) {
+        return { NULL, 0 };
+    }
+
+    return { data, size };
+}
+
+void release(Payload& payload)
+{
+    // must mirror the choice made by allocate()
+    if (payload.data != NULL) {
+        if (payload.size <= ARCH_PAGE_SIZE) {
+            Memory::freeFrame(payload.data);
+        } else {
+            Memory::freePage(payload.data, payload.size - 1);
+        }
+    }
+
+    payload = { NULL, 0 };
+}
+
+} // !namespace IPC
@@ -0,0 +1,214 @@
+/**
+ * @file Channel.hpp
+ * @author Keeton Feavel (keeton@xyr.is)
+ * @brief Typed message channels between kernel tasks. Messages are small
+ * descriptors passed through a lock-free ring. Large data travels as a
+ * page-backed payload whose ownership moves from the sender to the receiver,
+ * so it is never copied.
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @copyright Copyright the Xyris Contributors (c) 2026
+ *
+ */
+#pragma once
+
+#include <IPC/Waitable.hpp>
+#include <Library/SPSCRingBuffer.hpp>
+#include <Scheduler/tasks.hpp>
+#include <stddef.h>
+#include <stdint.h>
+
+namespace IPC {
+
+/**
+ * @brief Page-backed message payload. Whoever holds it owns the pages and
+ * must either send it on or release it.
+ *
+ */
+struct Payload {
+    void* data;     // Page aligned, NULL when there is no payload
+    size_t size;    // Size in bytes as requested from allocate(), must not be changed
+};
+
+/**
+ * @brief Allocate a payload of at least `size` bytes.
+ *
+ * @param size Size in bytes
+ * @return Payload Payload, with a NULL data pointer if allocation failed
+ */
+Payload allocate(size_t size);
+
+/**
+ * @brief Free a payload's pages.
+ *
+ */
+void release(Payload& payload);
+
+/**
+ * @brief Channel carrying values of type T with room for S messages in
+ * flight. There must be a single sending task and a single receiving task.
+ * Full and empty channels block the sender and receiver respectively
+ * instead of polling. As a Waitable the channel is ready when a receive
+ * would not block.
+ *
+ * @tparam T Message type. Copied by value, so keep it small.
+ * @tparam S Capacity. Must be a power of two.
+ */
+template <typename T, size_t S>
+class Channel : public Waitable {
+    static_assert(__is_trivially_copyable(T), "Channel messages are copied by value");
+
+public:
+    explicit Channel(const char* name = nullptr)
+        : m_closed(false)
+    {
+        tasks_sync_init(&m_senders);
+        tasks_sync_init(&m_receivers);
+        m_senders.dbg_name = name;
+        m_receivers.dbg_name = name;
+    }
+
+    /**
+     * @brief Send a message, blocking while the channel is full. On success
+     * the payload belongs to the receiver.
+     *
+     * @param value Message
+     * @param payload Optional payload to hand over
+     * @return true Message was queued
+     * @return false The channel is closed. The caller still owns the payload.
+     */
+    bool send(const T& value, Payload payload = { NULL, 0 })
+    {
+        struct Message msg = { value, payload };
+        preempt_disable();
+        // checking for room and joining the wait list can't be interleaved with a receive
+        while (!m_closed && !m_ring.Enqueue(msg)) {
+            // blocks right away and returns with preemption still disabled
+            tasks_sync_block(&m_senders);
+            preempt_enable();
+            preempt_disable();
+        }
+        bool sent = !m_closed;
+        preempt_enable();
+
+        if (sent) {
+            wake(&m_receivers);
+            notify();
+        }
+        return sent;
+    }
+
+    /**
+     * @brief Send a message without blocking.
+     *
+     * @return true Message was queued and the payload belongs to the receiver
+     * @return false The channel is full or closed. The caller still owns the payload.
+     */
+    bool trySend(const T& value, Payload payload = { NULL, 0 })
+    {
+        struct Message msg = { value, payload };
+        if (__atomic_load_n(&m_closed, __ATOMIC_ACQUIRE) || !m_ring.Enqueue(msg)) {
+            return false;
+        }
+
+        wake(&m_receivers);
+        notify();
+        return true;
+    }
+
+    /**
+     * @brief Receive a message, blocking while the channel is empty.
+     *
+     * @param value Receives the message
+     * @param payload Receives ownership of the message's payload. If NULL any
+     * payload is released.
+     * @return true A message was received
+     * @return false The channel is closed and has been drained
+     */
+    bool receive(T* value, Payload* payload = NULL)
+    {
+        struct Message msg;
+        preempt_disable();
+        while (!m_ring.Dequeue(&msg)) {
+            if (m_closed) {
+                preempt_enable();
+                return false;
+            }
+            tasks_sync_block(&m_receivers);
+            preempt_enable();
+            preempt_disable();
+        }
+        preempt_enable();
+
+        wake(&m_senders);
+        deliver(msg, value, payload);
+        return true;
+    }
+
+    /**
+     * @brief Receive a message without blocking.
+     *
+     * @return true A message was received
+     * @return false The channel is empty
+     */
+    bool tryReceive(T* value, Payload* payload = NULL)
+    {
+        struct Message msg;
+        if (!m_ring.Dequeue(&msg)) {
+            return false;
+        }
+
+        wake(&m_senders);
+        deliver(msg, value, payload);
+        return true;
+    }
+
+    /**
+     * @brief Close the channel. Blocked senders fail, and the receiver
+     * fails once the queued messages have been drained.
+     *
+     */
+    void close()
+    {
+        __atomic_store_n(&m_closed, true, __ATOMIC_RELEASE);
+        wake(&m_senders);
+        wake(&m_receivers);
+        notify();
+    }
+
+    bool isClosed() { return __atomic_load_n(&m_closed, __ATOMIC_ACQUIRE); }
+
+    bool isReady() override { return !m_ring.IsEmpty() || isClosed(); }
+
+private:
+    struct Message {
+        T value;
+        Payload payload;
+    };
+
+    static void wake(struct task_sync* ts)
+    {
+        // skip the scheduler entirely when nobody is waiting
+        if (__atomic_load_n(&ts->waiting.head, __ATOMIC_ACQUIRE) != NULL) {
+            tasks_sync_unblock(ts);
+        }
+    }
+
+    static void deliver(struct Message& msg, T* value, Payload* payload)
+    {
+        *value = msg.value;
+        if (payload) {
+            *payload = msg.payload;
+        } else {
+            release(msg.payload);
+        }
+    }
+
+    bool m_closed;
+    struct task_sync m_senders;
+    struct task_sync m_receivers;
+    SPSCRingBuffer<struct Message, S> m_ring;
+};
+
+} // !namespace IPC
@@ -0,0 +1,114 @@
+/**
+ * @file Waitable.cpp
+ * @author Keeton Feavel (keeton@xyr.is)
+ * @brief Waitable objects and waiting on several of them at once
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @copyright Copyright the Xyris Contributors (c) 2026
+ *
+ */
+#include <IPC/Waitable.hpp>
+#include <Arch/Arch.hpp>
+
+namespace IPC {
+
+void Waitable::notify()
+{
+    if (__atomic_load_n(&m_waiters, __ATOMIC_ACQUIRE) == NULL) {
+        return;
+    }
+
+    // waiter lists are also walked from interrupt handlers
+    Arch::CPU::criticalRegionNestable([this]() {
+        for (struct Waiter* waiter = m_waiters; waiter != NULL; waiter = waiter->next) {
+            tasks_wait_signal(waiter->wait);
+        }
+    });
+}
+
+void Waitable::addWaiter(struct Waiter* waiter)
+{
+    Arch::CPU::criticalRegionNestable([this, waiter]() {
+        waiter->next = m_waiters;
+        m_waiters = waiter;
+    });
+}
+
+void Waitable::removeWaiter(struct Waiter* waiter)
+{
+    Arch::CPU::criticalRegionNestable([this, waiter]() {
+        for (struct Waiter** link = &m_waiters; *link != NULL; link = &(*link)->next) {
+            if (*link == waiter) {
+                *link = waiter->next;
+                break;
+            }
+        }
+    });
+}
+
+static size_t poll(Waitable* const* set, size_t count, bool* ready)
+{
+    size_t found = 0;
+    for (size_t i = 0; i < count; i++) {
+        bool isReady = set[i]->isReady();
+        if (ready) {
+            ready[i] = isReady;
+        }
+        found += isReady;
+    }
+
+    return found;
+}
+
+size_t waitAny(Waitable* const* set, size_t count, bool* ready, uint64_t timeout)
+{
+    if (count > WAIT_MAX_OBJECTS) {
+        count = WAIT_MAX_OBJECTS;
+    }
+    if (timeout == 0) {
+        return poll(set, count, ready);
+    }
+
+    uint64_t end = 0;
+    if (timeout != WAIT_FOREVER) {
+        end = tasks_get_time_ns() + timeout;
+    }
+
+    // join every object's waiter list before checking them, so a
+    // notification that lands between the check and blocking isn't lost
+    struct task_wait wait;
+    tasks_wait_init(&wait);
+    Waitable::Waiter waiters[WAIT_MAX_OBJECTS];
+    for (size_t i = 0; i < count; i++) {
+        waiters[i].wait = &wait;
+        set[i]->addWaiter(&waiters[i]);
+    }
+
+    size_t found;
+    for (;;) {
+        __atomic_store_n(&wait.signaled, false, __ATOMIC_RELEASE);
+        found = poll(set, count, ready);
+        if (found != 0 || (end != 0 && tasks_get_time_ns() >= end)) {
+            break;
+        }
+
+        // sleep until the nearest of the timeout and any object's own deadline
+        uint64_t deadline = end;
+        for (size_t i = 0; i < count; i++) {
+            uint64_t objectDeadline = set[i]->deadline();
+            if (objectDeadline != 0 && (deadline == 0 || objectDeadline < deadline)) {
+                deadline = objectDeadline;
+            }
+        }
+        tasks_wait_block(&wait, deadline);
+    }
+
+    for (size_t i = 0; i < count; i++) {
+        set[i]->removeWaiter(&waiters[i]);
+    }
+
+    return found;
+}
+
+} // !namespace IPC
@@ -0,0 +1,126 @@
+/**
+ * @file Waitable.hpp
+ * @author Keeton Feavel (keeton@xyr.is)
+ * @brief Objects a task can block on, alone or together with others. A task
+ * serving several event sources calls `waitAny()` once instead of polling
+ * each source in turn.
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @copyright Copyright the Xyris Contributors (c) 2026
+ *
+ */
+#pragma once
+
+#include <Scheduler/tasks.hpp>
+#include <stddef.h>
+#include <stdint.h>
+
+#define WAIT_FOREVER        UINT64_MAX
+#define WAIT_MAX_OBJECTS    16
+
+namespace IPC {
+
+class Waitable;
+
+/**
+ * @brief Block until at least one object in the set is ready or the timeout
+ * expires. Must be called from a task with preemption enabled.
+ *
+ * @param set Objects to wait on
+ * @param count Number of objects (at most WAIT_MAX_OBJECTS)
+ * @param ready Set to whether each object was ready. May be NULL.
+ * @param timeout Timeout in nanoseconds. 0 only polls and WAIT_FOREVER never expires.
+ * @return size_t Number of ready objects, 0 on timeout
+ */
+size_t waitAny(Waitable* const* set, size_t count, bool* ready, uint64_t timeout);
+
+/**
+ * @brief Something that becomes ready at some point, e.g. a queue that
+ * received data. Implementations call `notify()` whenever they may have
+ * become ready.
+ *
+ */
+class Waitable {
+public:
+    Waitable()
+        : m_waiters(NULL)
+    {
+        // Default constructor
+    }
+
+    /**
+     * @brief Whether a wait on this object would be satisfied right now.
+     * Must not block and may be called with interrupts disabled.
+     *
+     */
+    virtual bool isReady() = 0;
+
+    /**
+     * @brief Time at which the object becomes ready without a notification,
+     * for objects such as timers.
+     *
+     * @return uint64_t Absolute time (in nanoseconds) or 0 if there is none
+     */
+    virtual uint64_t deadline() { return 0; }
+
+protected:
+    ~Waitable() = default;
+
+    /**
+     * @brief Wake every task waiting on this object. Safe to call from
+     * interrupt handlers and cheap when nobody is waiting.
+     *
+     */
+    void notify();
+
+private:
+    friend size_t waitAny(Waitable* const* set, size_t count, bool* ready, uint64_t timeout);
+
+    struct Waiter {
+        struct task_wait* wait;
+        struct Waiter* next;
+    };
+
+    void addWaiter(struct Waiter* waiter);
+    void removeWaiter(struct Waiter* waiter);
+
+    struct Waiter* m_waiters;
+};
+
+/**
+ * @brief One-shot timer. Ready once it has been armed and its deadline has passed.
+ *
+ */
+class Timer : public Waitable {
+public:
+    Timer()
+        : m_deadline(0)
+    {
+        // Default constructor
+    }
+
+    /**
+     * @brief Arm the timer to expire after a period of time.
+     *
+     * @param ns Nanoseconds from now
+     */
+    void arm(uint64_t ns) { armAt(tasks_get_time_ns() + ns); }
+
+    /**
+     * @brief Arm the timer to expire at an absolute time.
+     *
+     * @param time Absolute time (in nanoseconds since boot)
+     */
+    void armAt(uint64_t time) { m_deadline = time ? time : 1; }
+
+    void disarm() { m_deadline = 0; }
+
+    bool isReady() override { return m_deadline != 0 && tasks_get_time_ns() >= m_deadline; }
+    uint64_t deadline() override { return m_deadline; }
+
+private:
+    uint64_t m_deadline;
+};
+
+} // !namespace IPC
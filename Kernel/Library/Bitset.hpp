@@ -11,8 +11,6 @@
  */
 #pragma once
 
-#include <Arch/Arch.hpp>
-#include <Library/string.hpp>
 #include <limits.h>
 #include <stddef.h>
 #include <stdint.h>
@@ -82,6 +80,8 @@ public:
 
     /**
      * @brief Finds a range of `count` clear bits and returns the starting position.
+     * Ranges may be any length and cross word boundaries. Whole words that
+     * cannot extend the current range are skipped without testing each bit.
      *
      * @param count Number of clear bits desired
      * @param isSet If true, find the first range of `count` bits that are set.
@@ -90,18 +90,39 @@ public:
      */
     [[gnu::always_inline]] size_t FindFirstRange(size_t count, bool isSet)
     {
-        size_t checkLow, checkHigh, check, idx, offset;
-        size_t mask = ((size_t)1 << count) - (size_t)1;
-        for (size_t i = 0UL; i < t_num_bits - count; i++) {
-            idx = Index(i);
-            offset = Offset(i);
-            checkLow = m_bitset[idx] >> offset;
-            checkHigh = offset ? m_bitset[idx + 1] << (TypeSize() - offset) : 0;
-            check = checkLow | checkHigh;
-
-            if ((check & mask) == isSet) {
-                return i;
+        const size_t match = isSet ? SIZE_MAX : 0;
+        size_t run = 0;
+        if (!count || count > t_num_bits) {
+            return Bitset::npos;
+        }
+
+        for (size_t i = 0UL; i < t_num_bits;) {
+            if (!Offset(i)) {
+                size_t word = m_bitset[Index(i)];
+                if (word == match) {
+                    // The whole word extends the range
+                    if (run + TypeSize() >= count) {
+                        return i - run;
+                    }
+                    run += TypeSize();
+                    i += TypeSize();
+                    continue;
+                }
+                if (word == ~match) {
+                    run = 0;
+                    i += TypeSize();
+                    continue;
+                }
+            }
+
+            if (Test(i) == isSet) {
+                if (++run == count) {
+                    return i + 1 - count;
+                }
+            } else {
+                run = 0;
             }
+            i++;
         }
 
         return Bitset::npos;
@@ -112,7 +133,7 @@ public:
      * When provided as a return value, it indicates no matches.
      *
      */
-    static const size_t npos = SIZE_MAX;
+    static constexpr size_t npos = SIZE_MAX;
 
 private:
     size_t m_numBits;
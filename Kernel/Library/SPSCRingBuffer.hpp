@@ -0,0 +1,121 @@
+/**
+ * @file SPSCRingBuffer.hpp
+ * @author Keeton Feavel (keeton@xyr.is)
+ * @brief A lock-free, single producer single consumer ring buffer. One
+ * context (a task or an interrupt handler) may enqueue while another
+ * dequeues without any locking or disabling of interrupts.
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @copyright Copyright the Xyris Contributors (c) 2026
+ *
+ */
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+template <typename T, size_t S>
+class SPSCRingBuffer {
+    static_assert(S && !(S & (S - 1)), "SPSCRingBuffer size must be a power of two");
+
+public:
+    /**
+     * @brief Initializes an empty ring buffer.
+     *
+     */
+    explicit SPSCRingBuffer()
+        : head(0)
+        , tail(0)
+    {
+        // Default constructor
+    }
+
+    /**
+     * @brief Writes a value into the ring buffer. Must only be called by the producer.
+     *
+     * @param val Data to write to the buffer
+     * @return true Value was enqueued
+     * @return false The buffer is full
+     */
+    bool Enqueue(const T& val)
+    {
+        size_t h = __atomic_load_n(&head, __ATOMIC_RELAXED);
+        if (h - __atomic_load_n(&tail, __ATOMIC_ACQUIRE) == S) {
+            return false;
+        }
+
+        data[h & (S - 1)] = val;
+        // Publish the value before the consumer can observe the new head
+        __atomic_store_n(&head, h + 1, __ATOMIC_RELEASE);
+        return true;
+    }
+
+    /**
+     * @brief Removes a value from the ring buffer. Must only be called by the consumer.
+     *
+     * @param buf Buffer to contain the data
+     * @return true A value was dequeued
+     * @return false The buffer is empty
+     */
+    bool Dequeue(T* buf)
+    {
+        size_t t = __atomic_load_n(&tail, __ATOMIC_RELAXED);
+        if (t == __atomic_load_n(&head, __ATOMIC_ACQUIRE)) {
+            return false;
+        }
+
+        *buf = data[t & (S - 1)];
+        // Release the slot only after the value has been read out
+        __atomic_store_n(&tail, t + 1, __ATOMIC_RELEASE);
+        return true;
+    }
+
+    /**
+     * @brief Query whether the ring buffer is empty.
+     *
+     * @return true The buffer is empty
+     * @return false The buffer is not empty
+     */
+    bool IsEmpty()
+    {
+        return Length() == 0;
+    }
+
+    /**
+     * @brief Query whether the ring buffer is full.
+     *
+     * @return true The buffer is full
+     * @return false The buffer is not full
+     */
+    bool IsFull()
+    {
+        return Length() == S;
+    }
+
+    /**
+     * @brief Returns the number of items in the buffer. Only exact when
+     * called from the producer or consumer.
+     *
+     * @return size_t Number of items available for reading.
+     */
+    size_t Length()
+    {
+        return __atomic_load_n(&head, __ATOMIC_ACQUIRE) - __atomic_load_n(&tail, __ATOMIC_ACQUIRE);
+    }
+
+    /**
+     * @brief Returns the buffer capacity (in number of items).
+     *
+     * @return size_t Buffer capacity
+     */
+    size_t Capacity()
+    {
+        return S;
+    }
+
+private:
+    T data[S];
+    size_t head;    // Only written by the producer
+    size_t tail;    // Only written by the consumer
+};
@@ -0,0 +1,46 @@
+/**
+ * @file crc32.cpp
+ * @author Keeton Feavel (keeton@xyr.is)
+ * @brief CRC-32 (IEEE 802.3, as used by zlib and Ethernet)
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @copyright Copyright the Xyris Contributors (c) 2026
+ *
+ */
+#include <Library/crc32.hpp>
+
+#define CRC32_POLYNOMIAL 0xEDB88320 // Reflected 0x04C11DB7
+
+namespace {
+
+struct Table {
+    uint32_t entries[256];
+
+    constexpr Table()
+        : entries()
+    {
+        for (uint32_t idx = 0; idx < 256; idx++) {
+            uint32_t crc = idx;
+            for (int bit = 0; bit < 8; bit++) {
+                crc = (crc & 1) ? (crc >> 1) ^ CRC32_POLYNOMIAL : crc >> 1;
+            }
+            entries[idx] = crc;
+        }
+    }
+};
+
+// built by the compiler, so there's nothing to initialize at boot
+constexpr Table table;
+
+}
+
+uint32_t crc32(const void* data, size_t size, uint32_t crc)
+{
+    auto bytes = (const uint8_t*)data;
+    crc = ~crc;
+    for (size_t idx = 0; idx < size; idx++) {
+        crc = table.entries[(crc ^ bytes[idx]) & 0xFF] ^ (crc >> 8);
+    }
+    return ~crc;
+}
@@ -0,0 +1,25 @@
+/**
+ * @file crc32.hpp
+ * @author Keeton Feavel (keeton@xyr.is)
+ * @brief CRC-32 (IEEE 802.3, as used by zlib and Ethernet)
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @copyright Copyright the Xyris Contributors (c) 2026
+ *
+ */
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * @brief Compute the CRC-32 of a buffer. Large inputs can be checksummed
+ * in pieces by passing the previous result back in.
+ *
+ * @param data Data to checksum
+ * @param size Size of the data (in bytes)
+ * @param crc CRC of the data before this piece (0 to start)
+ * @return uint32_t CRC of everything so far
+ */
+uint32_t crc32(const void* data, size_t size, uint32_t crc = 0);
@@ -0,0 +1,306 @@
+/**
+ * @file lz4.cpp
+ * @author Keeton Feavel (keeton@xyr.is)
+ * @brief LZ4 block compression and a simple framed stream built on it
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @copyright Copyright the Xyris Contributors (c) 2026
+ *
+ * References:
+ *     https://github.com/lz4/lz4/blob/dev/doc/lz4_Block_format.md
+ *
+ */
+#include <Library/lz4.hpp>
+#include <Library/crc32.hpp>
+
+#define LZ4_MIN_MATCH       4
+#define LZ4_LAST_LITERALS   5   // The block always ends with at least this many literals
+#define LZ4_MATCH_LIMIT     12  // and the last match starts at least this far from the end
+#define LZ4_SKIP_SHIFT      6   // Search faster through data that isn't compressing
+
+namespace LZ4 {
+
+static inline uint32_t read32(const uint8_t* ptr)
+{
+    uint32_t value;
+    __builtin_memcpy(&value, ptr, sizeof(value));
+    return value;
+}
+
+static inline void write32(uint8_t* ptr, uint32_t value)
+{
+    ptr[0] = (uint8_t)value;
+    ptr[1] = (uint8_t)(value >> 8);
+    ptr[2] = (uint8_t)(value >> 16);
+    ptr[3] = (uint8_t)(value >> 24);
+}
+
+static inline uint32_t hash(uint32_t sequence)
+{
+    return (sequence * 2654435761U) >> (32 - LZ4_HASH_LOG);
+}
+
+// Room needed for a sequence (worst case)
+static inline size_t sequenceSize(size_t literals, size_t match)
+{
+    return 1 + literals / 255 + 1 + literals + 2 + match / 255 + 1;
+}
+
+static uint8_t* writeLength(uint8_t* dst, size_t length)
+{
+    for (; length >= 255; length -= 255) {
+        *dst++ = 255;
+    }
+    *dst++ = (uint8_t)length;
+    return dst;
+}
+
+static uint8_t* writeLiterals(uint8_t* dst, uint8_t* token, const uint8_t* literals, size_t length)
+{
+    if (length >= 15) {
+        *token = 15 << 4;
+        dst = writeLength(dst, length - 15);
+    } else {
+        *token = (uint8_t)(length << 4);
+    }
+    if (length) {
+        __builtin_memcpy(dst, literals, length);
+    }
+    return dst + length;
+}
+
+size_t compress(const void* source, size_t size, void* destination, size_t capacity, struct HashTable& table)
+{
+    const uint8_t* src = (const uint8_t*)source;
+    const uint8_t* end = src + size;
+    const uint8_t* anchor = src;
+    uint8_t* dst = (uint8_t*)destination;
+    uint8_t* dstEnd = dst + capacity;
+
+    __builtin_memset(&table, 0, sizeof(table));
+    if (size > LZ4_MATCH_LIMIT) {
+        const uint8_t* matchEnd = end - LZ4_LAST_LITERALS;
+        const uint8_t* searchEnd = end - LZ4_MATCH_LIMIT;
+        const uint8_t* ip = src;
+        while (ip < searchEnd) {
+            uint32_t sequence = read32(ip);
+            uint32_t* entry = &table.entries[hash(sequence)];
+            const uint8_t* match = src + *entry;
+            *entry = (uint32_t)(ip - src);
+            if (match >= ip || ip - match > LZ4_MAX_OFFSET || read32(match) != sequence) {
+                ip += 1 + ((ip - anchor) >> LZ4_SKIP_SHIFT);
+                continue;
+            }
+
+            // the match may have started earlier than where it was found
+            while (ip > anchor && match > src && ip[-1] == match[-1]) {
+                ip--;
+                match--;
+            }
+            const uint8_t* matchIp = ip + LZ4_MIN_MATCH;
+            const uint8_t* matchRef = match + LZ4_MIN_MATCH;
+            while (matchIp < matchEnd && *matchIp == *matchRef) {
+                matchIp++;
+                matchRef++;
+            }
+
+            size_t literals = (size_t)(ip - anchor);
+            size_t length = (size_t)(matchIp - ip) - LZ4_MIN_MATCH;
+            if (sequenceSize(literals, length) > (size_t)(dstEnd - dst)) {
+                return 0;
+            }
+
+            uint8_t* token = dst++;
+            dst = writeLiterals(dst, token, anchor, literals);
+            size_t offset = (size_t)(ip - match);
+            *dst++ = (uint8_t)offset;
+            *dst++ = (uint8_t)(offset >> 8);
+            if (length >= 15) {
+                *token |= 15;
+                dst = writeLength(dst, length - 15);
+            } else {
+                *token |= (uint8_t)length;
+            }
+
+            ip = matchIp;
+            anchor = ip;
+            // remember a position inside the match too, runs of similar lines benefit
+            table.entries[hash(read32(ip - 2))] = (uint32_t)(ip - 2 - src);
+        }
+    }
+
+    // the rest is literals
+    size_t literals = (size_t)(end - anchor);
+    if (sequenceSize(literals, 0) > (size_t)(dstEnd - dst)) {
+        return 0;
+    }
+    uint8_t* token = dst++;
+    dst = writeLiterals(dst, token, anchor, literals);
+    return (size_t)(dst - (uint8_t*)destination);
+}
+
+static bool readLength(const uint8_t** ip, const uint8_t* end, size_t* length, size_t limit)
+{
+    uint8_t byte;
+    do {
+        if (*ip >= end) {
+            return false;
+        }
+        byte = *(*ip)++;
+        *length += byte;
+        // stop runaway lengths before they can overflow
+        if (*length > limit) {
+            return false;
+        }
+    } while (byte == 255);
+
+    return true;
+}
+
+bool decompress(const void* source, size_t size, void* destination, size_t capacity, size_t* written)
+{
+    const uint8_t* ip = (const uint8_t*)source;
+    const uint8_t* end = ip + size;
+    uint8_t* dst = (uint8_t*)destination;
+    uint8_t* op = dst;
+    uint8_t* opEnd = dst + capacity;
+
+    if (size == 0) {
+        return false;
+    }
+
+    for (;;) {
+        uint8_t token = *ip++;
+        size_t literals = token >> 4;
+        if (literals == 15 && !readLength(&ip, end, &literals, capacity)) {
+            return false;
+        }
+        if (literals > (size_t)(end - ip) || literals > (size_t)(opEnd - op)) {
+            return false;
+        }
+        if (literals) {
+            __builtin_memcpy(op, ip, literals);
+        }
+        ip += literals;
+        op += literals;
+
+        // only the last sequence has no match
+        if (ip == end) {
+            break;
+        }
+        if (end - ip < 2) {
+            return false;
+        }
+        size_t offset = (size_t)ip[0] | (size_t)ip[1] << 8;
+        ip += 2;
+        if (offset == 0 || offset > (size_t)(op - dst)) {
+            return false;
+        }
+
+        size_t length = token & 15;
+        if (length == 15 && !readLength(&ip, end, &length, capacity)) {
+            return false;
+        }
+        length += LZ4_MIN_MATCH;
+        if (length > (size_t)(opEnd - op)) {
+            return false;
+        }
+
+        const uint8_t* match = op - offset;
+        if (offset >= length) {
+            __builtin_memcpy(op, match, length);
+            op += length;
+        } else {
+            // overlapping matches repeat the last `offset` bytes
+            while (length--) {
+                *op++ = *match++;
+            }
+        }
+        if (ip >= end) {
+            return false;
+        }
+    }
+
+    *written = (size_t)(op - dst);
+    return true;
+}
+
+FrameWriter::FrameWriter(uint8_t* buffer, uint8_t blockLog, struct HashTable& table, Sink sink, void* context)
+    : m_block(buffer)
+    , m_compressed(buffer + ((size_t)1 << blockLog))
+    , m_blockSize((size_t)1 << blockLog)
+    , m_used(0)
+    , m_blockLog(blockLog)
+    , m_started(false)
+    , m_table(table)
+    , m_sink(sink)
+    , m_context(context)
+    , m_consumed(0)
+    , m_produced(0)
+{
+    // Default constructor
+}
+
+void FrameWriter::emit(const void* data, size_t size)
+{
+    m_sink(data, size, m_context);
+    m_produced += size;
+}
+
+void FrameWriter::flush()
+{
+    if (!m_started) {
+        uint8_t header[LZ4_FRAME_HEADER_SIZE] = { 'X', 'L', 'Z', '4', LZ4_FRAME_VERSION, m_blockLog, 0, 0 };
+        emit(header, sizeof(header));
+        m_started = true;
+    }
+    if (m_used == 0) {
+        return;
+    }
+
+    uint8_t header[8];
+    uint8_t trailer[4];
+    size_t size = compress(m_block, m_used, m_compressed, compressBound(m_blockSize), m_table);
+    const uint8_t* data = m_compressed;
+    if (size == 0 || size >= m_used) {
+        // not worth it, send it as is
+        size = m_used;
+        data = m_block;
+        write32(header, (uint32_t)size | LZ4_FRAME_RAW_BLOCK);
+    } else {
+        write32(header, (uint32_t)size);
+    }
+    write32(header + 4, (uint32_t)m_used);
+    write32(trailer, crc32(m_block, m_used));
+
+    emit(header, sizeof(header));
+    emit(data, size);
+    emit(trailer, sizeof(trailer));
+    m_used = 0;
+}
+
+void FrameWriter::write(const void* data, size_t size)
+{
+    auto bytes = (const uint8_t*)data;
+    m_consumed += size;
+    while (size) {
+        size_t chunk = m_blockSize - m_used < size ? m_blockSize - m_used : size;
+        __builtin_memcpy(m_block + m_used, bytes, chunk);
+        m_used += chunk;
+        bytes += chunk;
+        size -= chunk;
+        if (m_used == m_blockSize) {
+            flush();
+        }
+    }
+}
+
+void FrameWriter::finish()
+{
+    flush();
+    uint8_t end[4] = { 0, 0, 0, 0 };
+    emit(end, sizeof(end));
+}
+
+} // !namespace LZ4
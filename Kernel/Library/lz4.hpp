@@ -0,0 +1,150 @@
+/**
+ * @file lz4.hpp
+ * @author Keeton Feavel (keeton@xyr.is)
+ * @brief LZ4 block compression and a simple framed stream built on it.
+ * Blocks use the standard LZ4 block format, so any LZ4 implementation can
+ * decompress them. Nothing here allocates memory, callers provide the hash
+ * table and buffers.
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @copyright Copyright the Xyris Contributors (c) 2026
+ *
+ */
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#define LZ4_HASH_LOG            12
+#define LZ4_HASH_SIZE           (1 << LZ4_HASH_LOG)
+#define LZ4_MAX_OFFSET          65535
+
+/*
+ * Frame layout (all values little endian):
+ *   header:  "XLZ4", version (1 byte), log2 of the block size (1 byte), 2 reserved bytes
+ *   block:   stored size (4 bytes, bit 31 set if stored uncompressed),
+ *            content size (4 bytes), data, CRC-32 of the content (4 bytes)
+ *   end:     stored size of 0
+ */
+#define LZ4_FRAME_MAGIC         "XLZ4"
+#define LZ4_FRAME_VERSION       1
+#define LZ4_FRAME_HEADER_SIZE   8
+#define LZ4_FRAME_RAW_BLOCK     0x80000000
+#define LZ4_FRAME_MAX_BLOCK_LOG 22
+
+namespace LZ4 {
+
+/**
+ * @brief Positions of recently seen input, indexed by a hash of the next
+ * four bytes. Only used while compressing, so one table can be shared by
+ * anything that doesn't compress at the same time.
+ *
+ */
+struct HashTable {
+    uint32_t entries[LZ4_HASH_SIZE];
+};
+
+/**
+ * @brief Largest compressed size of an input, for incompressible data.
+ *
+ */
+constexpr size_t compressBound(size_t size)
+{
+    return size + size / 255 + 16;
+}
+
+/**
+ * @brief Compress a block.
+ *
+ * @param source Data to compress
+ * @param size Size of the data
+ * @param destination Buffer for the compressed block
+ * @param capacity Size of the buffer, `compressBound(size)` always fits
+ * @param table Scratch space
+ * @return size_t Size of the compressed block, or 0 if it didn't fit
+ */
+size_t compress(const void* source, size_t size, void* destination, size_t capacity, struct HashTable& table);
+
+/**
+ * @brief Decompress a block. Malformed input is rejected, it never causes
+ * reads or writes outside the buffers.
+ *
+ * @param source Compressed block
+ * @param size Size of the compressed block
+ * @param destination Buffer for the data
+ * @param capacity Size of the buffer
+ * @param written Size of the data
+ * @return true The block was decompressed
+ * @return false The block is malformed or the data doesn't fit
+ */
+bool decompress(const void* source, size_t size, void* destination, size_t capacity, size_t* written);
+
+/**
+ * @brief Writes a stream of data as a frame, compressing it in blocks as it
+ * is written. Blocks that don't compress are stored as is.
+ *
+ */
+class FrameWriter {
+public:
+    typedef void (*Sink)(const void* data, size_t size, void* context);
+
+    /**
+     * @brief Construct a new frame writer. Nothing is written until data is.
+     *
+     * @param buffer Scratch space of at least `bufferSize(blockSize)` bytes
+     * @param blockLog Log2 of the block size, at most LZ4_FRAME_MAX_BLOCK_LOG
+     * @param table Hash table for the compressor
+     * @param sink Called with each piece of the frame
+     * @param context Passed to the sink
+     */
+    FrameWriter(uint8_t* buffer, uint8_t blockLog, struct HashTable& table, Sink sink, void* context);
+
+    static constexpr size_t bufferSize(uint8_t blockLog)
+    {
+        return ((size_t)1 << blockLog) + compressBound((size_t)1 << blockLog);
+    }
+
+    /**
+     * @brief Add data to the frame.
+     *
+     */
+    void write(const void* data, size_t size);
+
+    /**
+     * @brief Write out any buffered data and end the frame. The writer can't
+     * be used afterwards.
+     *
+     */
+    void finish();
+
+    /**
+     * @brief Bytes written to the frame so far (before compression).
+     *
+     */
+    uint64_t consumed() const { return m_consumed; }
+
+    /**
+     * @brief Bytes passed to the sink so far.
+     *
+     */
+    uint64_t produced() const { return m_produced; }
+
+private:
+    void emit(const void* data, size_t size);
+    void flush();
+
+    uint8_t* m_block;
+    uint8_t* m_compressed;
+    size_t m_blockSize;
+    size_t m_used;
+    uint8_t m_blockLog;
+    bool m_started;
+    struct HashTable& m_table;
+    Sink m_sink;
+    void* m_context;
+    uint64_t m_consumed;
+    uint64_t m_produced;
+};
+
+} // !namespace LZ4
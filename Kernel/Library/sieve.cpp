@@ -0,0 +1,105 @@
+/**
+ * @file sieve.cpp
+ * @author Keeton Feavel (keeton@xyr.is)
+ * @brief Odds-only segmented sieve of Eratosthenes
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright the Xyris Contributors (c) 2026
+ *
+ */
+#include <Library/sieve.hpp>
+
+namespace Sieve {
+
+static uint32_t squareRoot(uint64_t value)
+{
+    uint64_t root = 0;
+    while ((root + 1) * (root + 1) <= value) {
+        root++;
+    }
+    return (uint32_t)root;
+}
+
+void Segmented::init(uint64_t limit, uint32_t* bits, uint32_t segmentBits)
+{
+    m_limit = limit > SIEVE_MAX_LIMIT ? SIEVE_MAX_LIMIT : limit;
+    m_bits = bits;
+    m_segmentBits = segmentBits;
+    m_low = 0;
+    m_nextLow = 0;
+    m_size = 0;
+    m_segmentCount = 0;
+    // 2 is the only prime the segments can't see
+    m_count = m_limit > 2 ? 1 : 0;
+    m_baseCount = 0;
+    findBasePrimes(m_limit > 1 ? squareRoot(m_limit - 1) : 0);
+}
+
+void Segmented::findBasePrimes(uint32_t max)
+{
+    // small enough for a plain sieve, one byte per odd number below 2^16
+    static uint8_t composite[32768];
+    __builtin_memset(composite, 0, sizeof(composite));
+    for (uint32_t n = 3; n <= max; n += 2) {
+        if (composite[n / 2]) {
+            continue;
+        }
+        m_basePrimes[m_baseCount] = n;
+        m_baseNext[m_baseCount] = (uint64_t)n * n;
+        m_baseCount++;
+        for (uint32_t multiple = n * n; multiple <= max; multiple += 2 * n) {
+            composite[multiple / 2] = 1;
+        }
+    }
+}
+
+bool Segmented::next()
+{
+    if (m_nextLow >= m_limit) {
+        return false;
+    }
+
+    m_low = m_nextLow;
+    uint64_t remaining = (m_limit - m_low) / 2;
+    m_size = remaining < m_segmentBits ? (uint32_t)remaining : m_segmentBits;
+    m_nextLow = m_low + 2 * (uint64_t)m_segmentBits;
+    sieveSegment();
+    if (m_low == 0 && m_size) {
+        // 1 isn't prime
+        m_bits[0] &= ~1U;
+    }
+    m_segmentCount = countSegment();
+    m_count += m_segmentCount;
+    return true;
+}
+
+void Segmented::sieveSegment()
+{
+    __builtin_memset(m_bits, 0xff, (m_size + 31) / 32 * sizeof(uint32_t));
+    uint64_t high = m_low + 2 * (uint64_t)m_size;
+    for (size_t idx = 0; idx < m_baseCount && (uint64_t)m_basePrimes[idx] * m_basePrimes[idx] < high; idx++) {
+        uint32_t prime = m_basePrimes[idx];
+        uint32_t bit = (uint32_t)((m_baseNext[idx] - m_low) / 2);
+        for (; bit < m_size; bit += prime) {
+            m_bits[bit / 32] &= ~(1U << (bit % 32));
+        }
+        m_baseNext[idx] = m_low + 2 * (uint64_t)bit + 1;
+    }
+}
+
+size_t Segmented::countSegment()
+{
+    // don't count anything past the end of the segment
+    if (m_size % 32) {
+        m_bits[m_size / 32] &= (1U << (m_size % 32)) - 1;
+    }
+
+    size_t primes = 0;
+    for (uint32_t word = 0; word < (m_size + 31) / 32; word++) {
+        primes += (size_t)__builtin_popcount(m_bits[word]);
+    }
+    return primes;
+}
+
+} // !namespace Sieve
@@ -0,0 +1,99 @@
+/**
+ * @file sieve.hpp
+ * @author Keeton Feavel (keeton@xyr.is)
+ * @brief Odds-only segmented sieve of Eratosthenes. Only one segment is in
+ * memory at a time, so the caller can size it to fit a cache level. Nothing
+ * here allocates memory, callers provide the segment buffer.
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright the Xyris Contributors (c) 2026
+ *
+ */
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#define SIEVE_BASE_MAX      6542        // Primes below 2^16, enough to sieve up to 2^32
+#define SIEVE_MAX_LIMIT     (1ULL << 32)
+
+namespace Sieve {
+
+/**
+ * @brief Walks the numbers below a limit one segment at a time. Bit k of a
+ * segment stands for the odd number `low() + 2k + 1`, so even numbers take no
+ * space and crossing off never leaves the segment.
+ *
+ */
+class Segmented {
+public:
+    /**
+     * @brief Prepare to sieve every number below `limit`.
+     *
+     * @param limit Upper bound (exclusive), at most SIEVE_MAX_LIMIT
+     * @param bits Segment buffer of `segmentBits / 32` words
+     * @param segmentBits Odd numbers per segment, a multiple of 32
+     */
+    void init(uint64_t limit, uint32_t* bits, uint32_t segmentBits);
+
+    /**
+     * @brief Sieve the next segment.
+     *
+     * @return true A segment was sieved and can be inspected
+     * @return false Every number below the limit has been sieved
+     */
+    bool next();
+
+    /**
+     * @brief Even number just below the first number in the current segment.
+     *
+     */
+    uint64_t low() const { return m_low; }
+
+    /**
+     * @brief Odd numbers in the current segment. Only the last segment is
+     * smaller than the segment buffer.
+     *
+     */
+    uint32_t size() const { return m_size; }
+
+    /**
+     * @brief Primes in the current segment (2 is never in a segment).
+     *
+     */
+    size_t segmentCount() const { return m_segmentCount; }
+
+    /**
+     * @brief Primes below the end of the current segment, 2 included.
+     *
+     */
+    size_t count() const { return m_count; }
+
+    /**
+     * @brief Whether the number `low() + 2 * bit + 1` is prime.
+     *
+     * @param bit Bit in the current segment (less than `size()`)
+     */
+    bool isPrime(uint32_t bit) const { return m_bits[bit / 32] >> (bit % 32) & 1; }
+
+private:
+    void findBasePrimes(uint32_t max);
+    void sieveSegment();
+    size_t countSegment();
+
+    uint64_t m_limit;
+    uint32_t* m_bits;
+    uint32_t m_segmentBits;
+    uint64_t m_low;
+    uint64_t m_nextLow;
+    uint32_t m_size;
+    size_t m_segmentCount;
+    size_t m_count;
+    // odd primes up to the square root of the limit and the next odd multiple of each to cross off
+    uint32_t m_basePrimes[SIEVE_BASE_MAX];
+    uint64_t m_baseNext[SIEVE_BASE_MAX];
+    size_t m_baseCount;
+};
+
+} // !namespace Sieve
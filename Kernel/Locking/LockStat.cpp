@@ -0,0 +1,146 @@
+/**
+ * @file LockStat.cpp
+ * @author Keeton Feavel (keeton@xyr.is)
+ * @brief Lock contention statistics
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @copyright Copyright the Xyris Contributors (c) 2026
+ *
+ */
+#if defined(LOCKSTAT)
+
+#include <Locking/LockStat.hpp>
+#include <Arch/Arch.hpp>
+#include <Devices/Serial/dump.hpp>
+#include <Library/string.hpp>
+#include <Scheduler/tasks.hpp>
+#include <x86gprintrin.h>   // needed for __rdtsc
+
+namespace LockStat {
+
+// Classes are never removed, so locks may keep pointers to them forever
+static struct Class classes[LOCKSTAT_MAX_CLASSES];
+static size_t classCount = 0;
+
+struct Class* lookup(const char* name)
+{
+    if (name == NULL) {
+        name = "(unnamed)";
+    }
+
+    struct Class* found = NULL;
+    // locks are also constructed before there are any tasks
+    Arch::CPU::criticalRegionNestable([name, &found]() {
+        for (size_t idx = 0; idx < classCount; idx++) {
+            if (strcmp(classes[idx].name, name) == 0) {
+                found = &classes[idx];
+                return;
+            }
+        }
+        if (classCount < LOCKSTAT_MAX_CLASSES) {
+            found = &classes[classCount++];
+            found->name = name;
+        }
+    });
+
+    return found;
+}
+
+uint64_t now()
+{
+    return __rdtsc();
+}
+
+static void noteSite(struct Class* cls, uintptr_t address)
+{
+    // keep the busiest sites, replacing the quietest one when a new site shows up
+    struct CallSite* quietest = &cls->sites[0];
+    for (size_t idx = 0; idx < LOCKSTAT_CALL_SITES; idx++) {
+        struct CallSite* site = &cls->sites[idx];
+        if (site->address == address) {
+            site->count++;
+            return;
+        }
+        if (site->count < quietest->count) {
+            quietest = site;
+        }
+    }
+
+    quietest->address = address;
+    quietest->count = 1;
+}
+
+void acquired(struct Class* cls, uint64_t start, uint64_t acquired, bool contended, void* site)
+{
+    if (cls == NULL) {
+        return;
+    }
+
+    Arch::CPU::criticalRegionNestable([=]() {
+        cls->acquisitions++;
+        if (!contended) {
+            return;
+        }
+
+        uint64_t wait = acquired - start;
+        cls->contended++;
+        cls->waitTotal += wait;
+        if (wait > cls->waitMax) {
+            cls->waitMax = wait;
+        }
+        noteSite(cls, (uintptr_t)site);
+    });
+}
+
+void released(struct Class* cls, uint64_t acquired)
+{
+    if (cls == NULL) {
+        return;
+    }
+
+    uint64_t hold = now() - acquired;
+    Arch::CPU::criticalRegionNestable([=]() {
+        cls->holdTotal += hold;
+        if (hold > cls->holdMax) {
+            cls->holdMax = hold;
+        }
+    });
+}
+
+void dump(bool compressed)
+{
+    RS232::Dump out(compressed);
+    out.printf("lockstat begin %llu\n", tasks_get_time_ns());
+    out.printf("%-20s %10s %10s %12s %12s %12s %12s\n",
+        "name", "acquired", "contended", "wait ns", "wait max", "hold ns", "hold max");
+
+    for (size_t idx = 0; idx < __atomic_load_n(&classCount, __ATOMIC_ACQUIRE); idx++) {
+        // printing takes locks too, so work on a copy
+        struct Class cls;
+        Arch::CPU::criticalRegionNestable([idx, &cls]() { cls = classes[idx]; });
+        if (cls.acquisitions == 0) {
+            continue;
+        }
+
+        out.printf("%-20s %10llu %10llu %12llu %12llu %12llu %12llu\n",
+            cls.name,
+            cls.acquisitions,
+            cls.contended,
+            tasks_cycles_to_ns(cls.waitTotal),
+            tasks_cycles_to_ns(cls.waitMax),
+            tasks_cycles_to_ns(cls.holdTotal),
+            tasks_cycles_to_ns(cls.holdMax));
+        for (size_t site = 0; site < LOCKSTAT_CALL_SITES; site++) {
+            if (cls.sites[site].count) {
+                out.printf("    contended at 0x%08lx: %llu\n", (uint32_t)cls.sites[site].address, cls.sites[site].count);
+            }
+        }
+    }
+
+    out.printf("lockstat end\n");
+}
+
+} // !namespace LockStat
+
+#endif
@@ -0,0 +1,80 @@
+/**
+ * @file LockStat.hpp
+ * @author Keeton Feavel (keeton@xyr.is)
+ * @brief Lock contention statistics. Locks are grouped into classes by
+ * name, so every "user-virtual" mutex adds to the same numbers. Only built
+ * when the kernel is compiled with LOCKSTAT defined (`scons lockstat=1`),
+ * otherwise locks carry no extra state or code.
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @copyright Copyright the Xyris Contributors (c) 2026
+ *
+ */
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#define LOCKSTAT_MAX_CLASSES    64
+#define LOCKSTAT_CALL_SITES     4   // Contending call sites kept per class
+
+namespace LockStat {
+
+struct CallSite {
+    uintptr_t address;
+    uint64_t count;
+};
+
+struct Class {
+    const char* name;
+    uint64_t acquisitions;
+    uint64_t contended;         // Acquisitions that had to wait
+    uint64_t waitTotal;         // TSC cycles
+    uint64_t waitMax;
+    uint64_t holdTotal;
+    uint64_t holdMax;
+    struct CallSite sites[LOCKSTAT_CALL_SITES];
+};
+
+/**
+ * @brief Find or create the class for a lock name. Unnamed locks share one class.
+ *
+ * @return Class* Class, or NULL once LOCKSTAT_MAX_CLASSES classes exist
+ */
+struct Class* lookup(const char* name);
+
+/**
+ * @brief Timestamp taken before trying to acquire a lock.
+ *
+ */
+uint64_t now();
+
+/**
+ * @brief Record an acquisition.
+ *
+ * @param cls Lock class (may be NULL)
+ * @param start Timestamp from `now()` before the first attempt
+ * @param acquired Timestamp once the lock was held
+ * @param contended Whether the lock had to be waited for
+ * @param site Return address of the locking call
+ */
+void acquired(struct Class* cls, uint64_t start, uint64_t acquired, bool contended, void* site);
+
+/**
+ * @brief Record a release.
+ *
+ * @param cls Lock class (may be NULL)
+ * @param acquired Timestamp the lock was acquired at
+ */
+void released(struct Class* cls, uint64_t acquired);
+
+/**
+ * @brief Write every class with at least one acquisition to serial. Call
+ * sites are printed as addresses for `addr2line`.
+ *
+ * @param compressed Send the dump as an LZ4 frame (see `RS232::Dump`)
+ */
+void dump(bool compressed = false);
+
+} // !namespace LockStat
@@ -13,16 +13,32 @@
 Mutex::Mutex(const char* name)
     : m_isLocked(false)
 {
-    m_taskSync.dbg_name = name;
+    // initializing clears the name, so set it afterwards
     tasks_sync_init(&m_taskSync);
+    m_taskSync.dbg_name = name;
+#if defined(LOCKSTAT)
+    m_stat = LockStat::lookup(name);
+    m_acquiredAt = 0;
+#endif
 };
 
 bool Mutex::lock()
 {
+#if defined(LOCKSTAT)
+    uint64_t start = LockStat::now();
+    bool contended = false;
+#endif
     while (__atomic_test_and_set(&m_isLocked, __ATOMIC_RELEASE)) {
+#if defined(LOCKSTAT)
+        contended = true;
+#endif
         TASK_ONLY tasks_sync_block(&m_taskSync);
     }
 
+#if defined(LOCKSTAT)
+    m_acquiredAt = LockStat::now();
+    LockStat::acquired(m_stat, start, m_acquiredAt, contended, __builtin_return_address(0));
+#endif
     return true;
 }
 
@@ -32,11 +48,18 @@ bool Mutex::tryLock()
         return false;
     }
 
+#if defined(LOCKSTAT)
+    m_acquiredAt = LockStat::now();
+    LockStat::acquired(m_stat, m_acquiredAt, m_acquiredAt, false, __builtin_return_address(0));
+#endif
     return true;
 }
 
 bool Mutex::unlock()
 {
+#if defined(LOCKSTAT)
+    LockStat::released(m_stat, m_acquiredAt);
+#endif
     __atomic_clear(&m_isLocked, __ATOMIC_RELEASE);
     TASK_ONLY tasks_sync_unblock(&m_taskSync);
 
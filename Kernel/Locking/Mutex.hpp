@@ -11,6 +11,7 @@
 #pragma once
 
 #include <stdint.h>
+#include <Locking/LockStat.hpp>
 #include <Scheduler/tasks.hpp>
 
 class Mutex {
@@ -47,4 +48,8 @@ public:
 private:
     bool m_isLocked;
     struct task_sync m_taskSync;
+#if defined(LOCKSTAT)
+    struct LockStat::Class* m_stat;
+    uint64_t m_acquiredAt;
+#endif
 };
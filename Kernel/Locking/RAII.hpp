@@ -22,7 +22,8 @@ public:
      * @param mutex Mutex to use for RAII (un)locking
      *
      */
-    RAIIMutex(Mutex& mutex)
+    // Always inlined so the mutex sees the real caller (e.g. for lockstat)
+    [[gnu::always_inline]] RAIIMutex(Mutex& mutex)
         : m_Mutex(mutex)
     {
         m_Mutex.lock();
@@ -24,21 +24,35 @@ Semaphore::Semaphore(uint32_t val, bool share, const char* name)
     : m_isShared(share)
     , m_count(val)
 {
-    m_taskSync.dbg_name = name;
+    // initializing clears the name, so set it afterwards
     tasks_sync_init(&m_taskSync);
+    m_taskSync.dbg_name = name;
+#if defined(LOCKSTAT)
+    m_stat = LockStat::lookup(name);
+#endif
 }
 
 bool Semaphore::wait()
 {
+#if defined(LOCKSTAT)
+    uint64_t start = LockStat::now();
+    bool contended = false;
+#endif
     uint32_t curVal = count();
     do {
         while (curVal == 0) {
+#if defined(LOCKSTAT)
+            contended = true;
+#endif
             TASK_ONLY tasks_sync_block(&m_taskSync);
             curVal = count();
         }
         // Fail using atomic relaxed because it may allow us to get to the "waiting" state faster.
     } while (!COMPARE_EXCHANGE(curVal, __ATOMIC_RELAXED));
 
+#if defined(LOCKSTAT)
+    LockStat::acquired(m_stat, start, LockStat::now(), contended, __builtin_return_address(0));
+#endif
     return true;
 }
 
@@ -52,6 +66,10 @@ bool Semaphore::tryWait()
         // We need to fail on an Atomic Acquire Release because it will fail less often (i.e. fewer loop iterations)
     } while (!COMPARE_EXCHANGE(curVal, __ATOMIC_ACQUIRE));
 
+#if defined(LOCKSTAT)
+    uint64_t acquired = LockStat::now();
+    LockStat::acquired(m_stat, acquired, acquired, false, __builtin_return_address(0));
+#endif
     return true;
 }
 
@@ -74,6 +92,7 @@ bool Semaphore::post()
 {
     __atomic_fetch_add(&m_count, 1, __ATOMIC_RELEASE);
     TASK_ONLY tasks_sync_unblock(&m_taskSync);
+    notify();
 
     return true;
 }
@@ -11,9 +11,11 @@
 #pragma once
 
 #include <stdint.h>
+#include <IPC/Waitable.hpp>
+#include <Locking/LockStat.hpp>
 #include <Scheduler/tasks.hpp>
 
-class Semaphore {
+class Semaphore : public IPC::Waitable {
 public:
     /**
      * @brief Initializes a semaphore struct using the values
@@ -63,8 +65,18 @@ public:
      */
     uint32_t count();
 
+    /**
+     * @brief Ready while the semaphore can be taken without blocking.
+     *
+     */
+    bool isReady() override { return count() > 0; }
+
 private:
     bool m_isShared;
     uint32_t m_count;
     struct task_sync m_taskSync;
+#if defined(LOCKSTAT)
+    // Semaphores have no owner, so only waits are recorded
+    struct LockStat::Class* m_stat;
+#endif
 };
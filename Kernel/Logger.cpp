@@ -11,6 +11,8 @@
 #include "Logger.hpp"
 #include <Bootloader/Arguments.hpp>
 #include <Library/stdio.hpp>
+#include <Library/string.hpp>
+#include <Scheduler/rcu.hpp>
 
 const char* Logger::levelToString(LogLevel lvl)
 {
@@ -41,14 +43,18 @@ void Logger::LogHelper(const char* tag, LogLevel lvl, const char* fmt, va_list a
 
 void Logger::LogHelperPrint(const char* fmt, va_list ap)
 {
-    for (size_t i = 0; i < m_writersIdx; i++) {
-        if (the().m_writers[i] != nullptr) {
-            the().m_writers[i](fmt, ap);
+    // Writers may block, so this can't be a read-side section. Writer
+    // functions never go away though, so loading each slot once is enough.
+    size_t count = __atomic_load_n(&the().m_writersIdx, __ATOMIC_ACQUIRE);
+    for (size_t i = 0; i < count; i++) {
+        LogWriter writer = rcu_dereference(the().m_writers[i]);
+        if (writer != nullptr) {
+            writer(fmt, ap);
         }
     }
 }
 
-void Logger::Trace(const char* tag, const char* fmt, ...)
+void Logger::TraceHelper(const char* tag, const char* fmt, ...)
 {
     if (lTRACE >= getLevel()) {
         va_list ap;
@@ -118,8 +124,18 @@ void Logger::Print(const char* fmt, ...)
 
 bool Logger::addWriter(LogWriter writer)
 {
+    RAIIMutex lock(the().m_writersMutex);
+    // reuse a slot emptied by removeWriter() first
+    for (size_t idx = 0; idx < the().m_writersIdx; idx++) {
+        if (the().m_writers[idx] == nullptr) {
+            rcu_assign_pointer(the().m_writers[idx], writer);
+            return true;
+        }
+    }
+
     if (the().m_writersIdx < the().m_maxWriterCount) {
-        the().m_writers[the().m_writersIdx++] = writer;
+        rcu_assign_pointer(the().m_writers[the().m_writersIdx], writer);
+        __atomic_store_n(&the().m_writersIdx, the().m_writersIdx + 1, __ATOMIC_RELEASE);
         return true;
     }
 
@@ -128,9 +144,10 @@ bool Logger::addWriter(LogWriter writer)
 
 bool Logger::removeWriter(LogWriter writer)
 {
+    RAIIMutex lock(the().m_writersMutex);
     for (size_t idx = 0; idx < the().m_writersIdx; idx++) {
         if (the().m_writers[idx] == writer) {
-            the().m_writers[idx] = nullptr;
+            rcu_assign_pointer(the().m_writers[idx], (LogWriter)nullptr);
             return true;
         }
     }
@@ -138,6 +155,12 @@ bool Logger::removeWriter(LogWriter writer)
     return false;
 }
 
+void Logger::setLevel(LogLevel level)
+{
+    the().m_logLevel = level;
+    StaticKey::set(m_traceKey, level <= lTRACE);
+}
+
 Logger& Logger::the()
 {
     static Logger instance;
@@ -146,6 +169,7 @@ Logger& Logger::the()
 
 Logger::Logger()
     : m_logBufferMutex("Logger")
+    , m_writersMutex("LoggerWriters")
     , m_writersIdx(0)
 #if defined(RELEASE)
     , m_logLevel(lINFO)
@@ -159,8 +183,16 @@ Logger::Logger()
 // Kernel argument callback
 static void argumentCallback(const char* lvl)
 {
-    // FIXME: Update kernel argument parser to handle `=`
-    (void)lvl;
+    static const char* const names[] = {
+        "trace", "debug", "verbose", "info", "warning", "error", "none",
+    };
+    for (size_t idx = 0; idx < sizeof(names) / sizeof(names[0]); idx++) {
+        size_t len = strlen(names[idx]);
+        if (memcmp(lvl, names[idx], len) == 0 && (lvl[len] == ' ' || lvl[len] == '\0')) {
+            Logger::setLevel((Logger::LogLevel)idx);
+            return;
+        }
+    }
 }
 
 KERNEL_PARAM(logLevelArg, "--log-level=", argumentCallback);
@@ -12,6 +12,7 @@
 #include <stdarg.h>
 #include <Locking/Mutex.hpp>
 #include <Locking/RAII.hpp>
+#include <Support/static_key.hpp>
 
 class Logger
 {
@@ -32,7 +33,14 @@ typedef int (*LogWriter)(const char* fmt, va_list args);
 Logger(Logger const&) = delete;
 void operator=(Logger const&) = delete;
 
-[[gnu::format(printf, 2, 3)]] static void Trace(const char* tag, const char* fmt, ...);
+// Trace calls sit on hot paths (e.g. the scheduler tick), so unless the log
+// level is lTRACE each one is patched down to a NOP
+[[gnu::format(printf, 2, 3), gnu::always_inline]] static inline void Trace(const char* tag, const char* fmt, ...)
+{
+    if (StaticKey::unlikely<m_traceKey>()) {
+        TraceHelper(tag, fmt, __builtin_va_arg_pack());
+    }
+}
 [[gnu::format(printf, 2, 3)]] static void Verbose(const char* tag, const char* fmt, ...);
 [[gnu::format(printf, 2, 3)]] static void Debug(const char* tag, const char* fmt, ...);
 [[gnu::format(printf, 2, 3)]] static void Info(const char* tag, const char* fmt, ...);
@@ -42,13 +50,15 @@ void operator=(Logger const&) = delete;
 
 static bool addWriter(LogWriter writer);
 static bool removeWriter(LogWriter writer);
-static void setLevel(LogLevel level) { the().m_logLevel = level; }
+static void setLevel(LogLevel level);
 static LogLevel getLevel() { return the().m_logLevel; }
 
 static Logger& the();
 
 private:
     Logger();
+    // Not marked as a printf function, Trace() already checks its arguments
+    static void TraceHelper(const char* tag, const char* fmt, ...);
     const char* levelToString(LogLevel lvl);
     void LogHelper(const char* tag, LogLevel lvl, const char* fmt, va_list args);
     void LogHelperPrint(const char* fmt, va_list args);
@@ -56,8 +66,10 @@ private:
     static const uint8_t m_maxWriterCount = 2;
     static const uint32_t m_maxBufferSize = 1024;
     Mutex m_logBufferMutex;
+    Mutex m_writersMutex;       // Serializes addWriter() and removeWriter()
     size_t m_writersIdx;
     LogLevel m_logLevel;
     LogWriter m_writers[m_maxWriterCount];
     char m_logBuffer[m_maxBufferSize];
+    static inline STATIC_KEY_FALSE(m_traceKey);
 };
@@ -45,6 +45,9 @@ public:
             if (section.initialized() && section.type() == Available) {
                 setFree(section);
                 freeMegabytes += B_TO_MB(section.size());
+                if (section.end() > the().m_memoryEnd) {
+                    the().m_memoryEnd = section.end();
+                }
                 continue;
             }
 
@@ -153,13 +156,25 @@ public:
         return the().m_memory.FindFirstBit(false);
     }
 
+    /**
+     * @brief End of the highest available physical memory section.
+     *
+     * @return uintptr_t Physical address
+     */
+    [[gnu::always_inline]] static uintptr_t memoryEnd()
+    {
+        return the().m_memoryEnd;
+    }
+
     static const size_t npos = SIZE_MAX;
 
 private:
     Bitset<MEM_BITMAP_SIZE> m_memory;
+    uintptr_t m_memoryEnd;
 
     Manager()
         : m_memory(1)
+        , m_memoryEnd(0)
     {
         // Always assume memory is reserved until proven otherwise
     }
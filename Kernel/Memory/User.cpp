@@ -0,0 +1,105 @@
+/**
+ * @file User.cpp
+ * @author Keeton Feavel (keeton@xyr.is)
+ * @brief User process address spaces
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @copyright Copyright the Xyris Contributors (c) 2026
+ *
+ */
+#include <Memory/User.hpp>
+#include <Memory/paging.hpp>
+#include <Locking/RAII.hpp>
+
+#define USER_DIR_START (USER_SPACE_BASE >> ARCH_PAGE_DIR_ENTRY_SHIFT)
+#define USER_DIR_END (USER_SPACE_END >> ARCH_PAGE_DIR_ENTRY_SHIFT)
+
+namespace Memory::Virtual {
+
+User::User(Arch::Memory::Directory& dir)
+    : Manager("user-virtual", dir, USER_SPACE_BASE, USER_SPACE_END - USER_SPACE_BASE)
+{
+    // Private constructor, see create()
+}
+
+User* User::create()
+{
+    // New frames come from the physmap already zeroed
+    auto dir = (Arch::Memory::Directory*)newFrame();
+    if (dir == NULL) {
+        return NULL;
+    }
+
+    // Kernel page tables are allocated up front, so sharing the directory
+    // entries once is enough to see every later kernel mapping too
+    auto kernelDir = (Arch::Memory::Directory*)physToVirt(getPageDirPhysAddr());
+    for (size_t idx = 0; idx < ARCH_PAGE_DIR_ENTRIES; idx++) {
+        if (idx < USER_DIR_START || idx >= USER_DIR_END) {
+            dir->entries[idx] = kernelDir->entries[idx];
+        }
+    }
+
+    User* user = new User(*dir);
+    if (user == NULL) {
+        freeFrame(dir);
+    }
+
+    return user;
+}
+
+User::~User()
+{
+    for (size_t dirIdx = USER_DIR_START; dirIdx < USER_DIR_END; dirIdx++) {
+        if (!m_directory.entries[dirIdx].present) {
+            continue;
+        }
+
+        Arch::Memory::Table& table = getTable(dirIdx);
+        for (size_t tableIdx = 0; tableIdx < ARCH_PAGE_TABLE_ENTRIES; tableIdx++) {
+            Arch::Memory::TableEntry& entry = table.entries[tableIdx];
+            if (entry.present) {
+                freeFrame(physToVirt((uintptr_t)entry.pageAddr << ARCH_PAGE_TABLE_ENTRY_SHIFT));
+            }
+        }
+        freeFrame(&table);
+    }
+
+    freeFrame(&m_directory);
+}
+
+bool User::mapPage(uintptr_t vaddr, void* frame, bool writable)
+{
+    if (vaddr < m_rangeStart || vaddr >= m_rangeEnd) {
+        return false;
+    }
+
+    RAIIMutex lock(m_lock);
+    if (isMapped(vaddr)) {
+        return false;
+    }
+
+    int flags = USERMODE;
+    if (!writable) {
+        flags |= READ_ONLY;
+    }
+    mapPhysicalToVirtual(virtToPhys(frame), vaddr, (enum MapFlags)flags);
+    return true;
+}
+
+bool User::isMapped(uintptr_t vaddr)
+{
+    Arch::Memory::Address addr(vaddr);
+    if (!m_directory.entries[addr.virtualAddress().dirIndex].present) {
+        return false;
+    }
+
+    return getTable(addr.virtualAddress().dirIndex).entries[addr.virtualAddress().tableIndex].present;
+}
+
+uintptr_t User::directoryPhysical()
+{
+    return virtToPhys(&m_directory);
+}
+
+} // !namespace Memory::Virtual
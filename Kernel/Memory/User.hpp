@@ -0,0 +1,69 @@
+/**
+ * @file User.hpp
+ * @author Keeton Feavel (keeton@xyr.is)
+ * @brief User process address spaces. Each process gets its own page
+ * directory whose user range is private while every other entry is shared
+ * with the kernel.
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @copyright Copyright the Xyris Contributors (c) 2026
+ *
+ */
+#pragma once
+
+#include <Arch/Memory.hpp>
+#include <Memory/Virtual.hpp>
+#include <stddef.h>
+#include <stdint.h>
+
+namespace Memory::Virtual {
+
+class User : public Manager {
+public:
+    User(User const&) = delete;
+    void operator=(User const&) = delete;
+
+    /**
+     * @brief Create an empty address space.
+     *
+     * @return User* Address space, or NULL if out of memory
+     */
+    static User* create();
+
+    /**
+     * @brief Destroy the address space along with every page mapped into
+     * its user range. Must not be the active address space.
+     *
+     */
+    ~User();
+
+    /**
+     * @brief Map a page frame (from `Memory::newFrame()`) into the user
+     * range. The address space takes ownership of the frame.
+     *
+     * @param vaddr Page aligned user address
+     * @param frame Frame to map
+     * @param writable Whether user mode may write to the page
+     * @return true The page was mapped
+     * @return false The address is outside of the user range or already mapped
+     */
+    bool mapPage(uintptr_t vaddr, void* frame, bool writable);
+
+    /**
+     * @brief Whether an address in the user range is backed by a page.
+     *
+     */
+    bool isMapped(uintptr_t vaddr);
+
+    /**
+     * @brief Physical address of the page directory, to be loaded into CR3.
+     *
+     */
+    uintptr_t directoryPhysical();
+
+private:
+    explicit User(Arch::Memory::Directory& dir);
+};
+
+} // !namespace Memory::Virtual
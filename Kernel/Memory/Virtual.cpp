@@ -1,5 +1,6 @@
 #include "Virtual.hpp"
 #include <Locking/RAII.hpp>
+#include <Memory/paging.hpp>
 #include <Panic.hpp>
 
 namespace Memory::Virtual {
@@ -41,11 +42,13 @@ void Manager::mapPhysicalToVirtual(uintptr_t paddr, uintptr_t vaddr, enum MapFla
 
     // Assume page directory is mapped in
     Arch::Memory::DirectoryEntry& dirEntry = m_directory.entries[vAddress.virtualAddress().dirIndex];
-    // Table and table entry are not valid until we're sure they exist (see check below)
-    Arch::Memory::Table& table = getTable(vAddress.virtualAddress().dirIndex);
-    Arch::Memory::TableEntry& tableEntry = table.entries[vAddress.virtualAddress().tableIndex];
-
     if (!dirEntry.present) {
+        // New tables come from the physmap already zeroed
+        void* newTable = newFrame();
+        if (!newTable) {
+            panic("Out of memory for page tables!");
+        }
+
         dirEntry = {
             .present = 1,
             .readWrite = 1,
@@ -56,11 +59,16 @@ void Manager::mapPhysicalToVirtual(uintptr_t paddr, uintptr_t vaddr, enum MapFla
             .ignoredA = 0,
             .size = 0,
             .ignoredB = 0,
-            .tableAddr = Arch::Memory::Address(Physical::Manager::getPage()).page().pageAddr
+            .tableAddr = Arch::Memory::Address(virtToPhys(newTable)).page().pageAddr
         };
-
-        memset(&table, 0, sizeof(table));
     }
+    // The directory entry must allow user access for any user page in its table
+    if (flags & USERMODE) {
+        dirEntry.usermode = 1;
+    }
+
+    Arch::Memory::Table& table = getTable(vAddress.virtualAddress().dirIndex);
+    Arch::Memory::TableEntry& tableEntry = table.entries[vAddress.virtualAddress().tableIndex];
 
     if (tableEntry.present) {
         panic("Attempted to map address that is already in use!");
@@ -119,11 +127,10 @@ void Manager::initDirectory()
 
 Arch::Memory::Table& Manager::getTable(size_t directoryIndex)
 {
-    // 0xFFC00000 represents the end of the virtual address space
-    // minus the size of ARCH_TABLE_ENTRIES (1024) * ARCH_TABLE_SIZE
-    uint32_t tablesBase = 0xFFC00000;
-    uint32_t tableAddr = tablesBase + directoryIndex * ARCH_PAGE_SIZE;
-    return *((Arch::Memory::Table*)tableAddr);
+    // Page tables are reached through the physmap rather than the recursive
+    // mapping, so tables of any directory can be edited without a TLB flush
+    uintptr_t tableAddr = (uintptr_t)m_directory.entries[directoryIndex].tableAddr << ARCH_PAGE_TABLE_ENTRY_SHIFT;
+    return *((Arch::Memory::Table*)physToVirt(tableAddr));
 }
 
 uintptr_t Manager::findFirstFreePageRange(size_t range)
@@ -41,6 +41,7 @@ public:
         , m_directory(dir)
         , m_rangeStart(rangeStart)
         , m_rangeSize(rangeSize)
+        , m_rangeEnd(rangeStart + rangeSize)
         , m_searchStart(rangeStart)
     {
         // Named lock constructor
@@ -12,10 +12,28 @@
 #include <Locking/Mutex.hpp>
 #include <Memory/heap.hpp>
 #include <Memory/paging.hpp>
+#include <Scheduler/tasks.hpp>
+#include <Metrics.hpp>
 #include <stddef.h>
 
+// C++ allocations are prefixed with a header recording their size and the
+// task that made them, so deleting them credits that task even when another
+// task frees the memory. Sixteen bytes keeps the alignment malloc gives.
+// Only new and delete are accounted. Memory from malloc can be released
+// with free without a header, so it isn't charged to anyone.
+#define HEAP_HEADER_SIZE 16
+
+struct AllocationHeader {
+    size_t size;
+    uint32_t owner;     // Task ID, TASK_ID_NONE if allocated before scheduling
+};
+static_assert(sizeof(struct AllocationHeader) <= HEAP_HEADER_SIZE);
+
 static Mutex lock("alloc");
 
+METRIC_GAUGE(heapPages, "heap.pages", "pages");
+METRIC_COUNTER(heapGrows, "heap.grows", "calls");
+
 extern "C" {
 
 int liballoc_lock()
@@ -30,43 +48,72 @@ int liballoc_unlock()
 
 void* liballoc_alloc(unsigned int count)
 {
+    Metrics::inc(heapGrows);
+    Metrics::adjust(heapPages, count);
+    tasks_account_pages(count);
     return Memory::newPageMustSucceed(count * ARCH_PAGE_SIZE - 1);
 }
 
 int liballoc_free(void* page, unsigned int count)
 {
     Memory::freePage(page, count * ARCH_PAGE_SIZE - 1);
+    Metrics::adjust(heapPages, -(int64_t)count);
+    tasks_account_pages(-(int64_t)count);
     return 0;
 }
 
 }
 
+static void* accountedAlloc(size_t size)
+{
+    auto header = (struct AllocationHeader*)malloc(size + HEAP_HEADER_SIZE);
+    if (header == NULL) {
+        return NULL;
+    }
+
+    header->size = size;
+    header->owner = tasks_current_id();
+    tasks_account_heap(size);
+    return (uint8_t*)header + HEAP_HEADER_SIZE;
+}
+
+static void accountedFree(void* p)
+{
+    if (p == NULL) {
+        return;
+    }
+
+    auto header = (struct AllocationHeader*)((uint8_t*)p - HEAP_HEADER_SIZE);
+    tasks_account_heap_to(header->owner, -(int64_t)header->size);
+    free(header);
+}
+
 void* operator new(size_t size)
 {
-    return malloc(size);
+    return accountedAlloc(size);
 }
 
 void* operator new[](size_t size)
 {
-    return malloc(size);
+    return accountedAlloc(size);
 }
 
 void operator delete(void* p)
 {
-    free(p);
+    accountedFree(p);
 }
 
 void operator delete[](void* p)
 {
-    free(p);
+    accountedFree(p);
 }
 
 void operator delete(void* p, long unsigned int)
 {
-    free(p);
+    accountedFree(p);
 }
 
 void operator delete[](void* p, long unsigned int)
 {
-    free(p);
+    accountedFree(p);
 }
@@ -11,10 +11,14 @@
  */
 #include <Arch/Memory.hpp>
 #include <Library/Bitset.hpp>
+#include <Library/string.hpp>
 #include <Memory/Physical.hpp>
 #include <Memory/paging.hpp>
 #include <Memory/Virtual.hpp>
+#include <Scheduler/tasks.hpp>
 #include <Support/sections.hpp>
+#include <Userspace/Process.hpp>
+#include <Metrics.hpp>
 #include <Panic.hpp>
 #include <Logger.hpp>
 #include <stddef.h>
@@ -24,6 +28,10 @@ namespace Memory {
 static Mutex pagingLock("paging");
 
 static Bitset<MEM_BITMAP_SIZE> virtualMemoryBitset;
+static uintptr_t physmapEnd = 0; // Physical end of the linear map
+static bool userSpaceClobbered = false;
+
+METRIC_GAUGE(framesUsed, "mem.frames_used", "frames");
 
 // both of these must be page aligned for anything to work right at all
 [[gnu::section(".page_tables,\"aw\", @nobits#")]] static struct Arch::Memory::Directory pageDirectory;
@@ -34,6 +42,8 @@ static void pageFaultCallback(struct registers* regs);
 static void initDirectory();
 static void mapEarlyMem();
 static void mapKernel();
+static void mapPhysmap();
+static void reserveUserSpace();
 static uintptr_t findNextFreeVirtualAddress(size_t seq);
 static void mapKernelPageTable(size_t idx, struct Arch::Memory::Table* table);
 static Virtual::Manager virtualManager("virtual", pageDirectory, ARCH_DIR_ALIGN(KERNEL_START), ARCH_DIR_ALIGN_UP(KERNEL_END - KERNEL_START));
@@ -43,16 +53,39 @@ void init()
     // DONE: Move logic from this point until next TODO into Kernel.hpp/.cpp
     Interrupts::registerHandler(Interrupts::EXCEPTION_PAGE_FAULT, pageFaultCallback);
     initDirectory();
+    reserveUserSpace();
     // TODO: Move logic from this point on into Kernel.hpp/.cpp
     mapEarlyMem();  // Map early memory into kernel page tables in a 1:1 manner
     mapKernel();    // Map kernel into kernel page tables
+    mapPhysmap();   // Map physical memory linearly at PHYSMAP_BASE
     Arch::Memory::setPageDirectory(Arch::Memory::pageAlign(KADDR_TO_PHYS((uintptr_t)&pageDirectory)));
     Arch::Memory::pagingEnable();
 }
 
 static void pageFaultCallback(struct registers* regs)
 {
-    panic(regs);
+    tasks_account_page_fault();
+    // user processes are paged in on demand
+    if (!Userspace::handlePageFault(regs)) {
+        panic(regs);
+    }
+}
+
+static void reserveUserSpace()
+{
+    for (uintptr_t addr = USER_SPACE_BASE; addr < USER_SPACE_END; addr += ARCH_PAGE_SIZE) {
+        virtualMemoryBitset.Set(ADDRESS_TO_PAGE_IDX(addr));
+    }
+}
+
+static inline bool inUserSpace(uintptr_t vaddr)
+{
+    return vaddr >= USER_SPACE_BASE && vaddr < USER_SPACE_END;
+}
+
+bool isUserSpaceAvailable()
+{
+    return !userSpaceClobbered;
 }
 
 static inline void mapKernelPageTable(size_t idx, struct Arch::Memory::Table* table)
@@ -84,6 +117,28 @@ static void initDirectory()
     }
 }
 
+static inline struct Arch::Memory::TableEntry kernelTableEntry(Arch::Memory::Address paddr)
+{
+    return {
+        .present = 1,                       // The page is present
+        .readWrite = 1,                     // The page has r/w permissions
+        .usermode = 0,                      // These are kernel pages
+        .writeThrough = 0,                  // Disable write through
+        .cacheDisable = 0,                  // The page is cached
+        .accessed = 0,                      // The page is unaccessed
+        .dirty = 0,                         // The page is clean
+        .pageAttrTable = 0,                 // The page has no attribute table
+        .global = 0,                        // The page is local
+        .unused = 0,                        // Ignored
+        .pageAddr = paddr.page().pageAddr,  // Page physical address
+    };
+}
+
+static inline struct Arch::Memory::TableEntry* kernelPageEntry(Arch::Memory::Address vaddr)
+{
+    return &pageTables[vaddr.virtualAddress().dirIndex].entries[vaddr.virtualAddress().tableIndex];
+}
+
 void mapKernelPage(Arch::Memory::Address vaddr, Arch::Memory::Address paddr)
 {
     // Set the page directory entry (pde) and page table entry (pte)
@@ -108,20 +163,14 @@ void mapKernelPage(Arch::Memory::Address vaddr, Arch::Memory::Address paddr)
 
         panic("Attempted to map already mapped page.\n");
     }
+    // Identity mapped device and firmware memory may land in the user
+    // range, which then can't be handed to processes anymore
+    if (inUserSpace(vaddr.val()) && !userSpaceClobbered) {
+        Logger::Warning(__func__, "0x%08lx mapped into user space, user processes are disabled", (uint32_t)vaddr.val());
+        userSpaceClobbered = true;
+    }
     // Set the page information
-    pageTables[pde].entries[pte] = {
-        .present = 1,                       // The page is present
-        .readWrite = 1,                     // The page has r/w permissions
-        .usermode = 0,                      // These are kernel pages
-        .writeThrough = 0,                  // Disable write through
-        .cacheDisable = 0,                  // The page is cached
-        .accessed = 0,                      // The page is unaccessed
-        .dirty = 0,                         // The page is clean
-        .pageAttrTable = 0,                 // The page has no attribute table
-        .global = 0,                        // The page is local
-        .unused = 0,                        // Ignored
-        .pageAddr = paddr.page().pageAddr,  // Page physical address
-    };
+    *entry = kernelTableEntry(paddr);
     // Set the associated bit in the bitmaps
     Physical::Manager::the().setUsed(paddr);
     virtualMemoryBitset.Set(vaddr.page().pageAddr);
@@ -155,8 +204,32 @@ static void mapKernel()
     mapKernelRangePhysical(Section(Arch::Memory::pageAlign(KERNEL_START), Arch::Memory::pageAlignUp(KERNEL_SIZE)));
 }
 
+static void mapPhysmap()
+{
+    Logger::Debug(__func__, "==== MAP PHYSMAP ====");
+    uintptr_t end = Arch::Memory::pageAlign(Physical::Manager::memoryEnd());
+    if (end > PHYSMAP_SIZE) {
+        Logger::Info(__func__, "%zu MB of highmem is outside the physmap", (size_t)B_TO_MB(end - PHYSMAP_SIZE));
+        end = PHYSMAP_SIZE;
+    }
+
+    // Frames are not marked as used here. The physmap is only a window onto
+    // them and owning a frame is still up to the physical memory manager.
+    for (uintptr_t paddr = 0; paddr < end; paddr += ARCH_PAGE_SIZE) {
+        Arch::Memory::Address vaddr(PHYSMAP_BASE + paddr);
+        *kernelPageEntry(vaddr) = kernelTableEntry(Arch::Memory::Address(paddr));
+        virtualMemoryBitset.Set(vaddr.page().pageAddr);
+    }
+
+    physmapEnd = end;
+}
+
+static inline bool inPhysmap(uintptr_t vaddr)
+{
+    return vaddr >= PHYSMAP_BASE && vaddr < PHYSMAP_BASE + physmapEnd;
+}
+
 /**
- * note: this can't find more than 32 sequential pages
  * @param seq the number of sequential pages to get
  */
 static uintptr_t findNextFreeVirtualAddress(size_t seq)
@@ -203,8 +276,9 @@ void freePage(void* page, size_t size)
 {
     RAIIMutex lock(pagingLock);
     size_t page_count = PAGE_COUNT(size);
-    Arch::Memory::Address addr((uintptr_t)page);
-    for (size_t i = addr.virtualAddress().tableIndex; i < addr.virtualAddress().tableIndex + page_count; i++) {
+    // Index of the page across the whole address space, not within its table
+    size_t first = (uintptr_t)page >> ARCH_PAGE_TABLE_ENTRY_SHIFT;
+    for (size_t i = first; i < first + page_count; i++) {
         virtualMemoryBitset.Clear(i);
         // this is the same as the line above
         struct Arch::Memory::TableEntry* pte = &(pageTables[i / ARCH_PAGE_TABLE_ENTRIES].entries[i % ARCH_PAGE_TABLE_ENTRIES]);
@@ -213,7 +287,7 @@ void freePage(void* page, size_t size)
         // zero it out to unmap it
         memset(pte, 0, sizeof(struct Arch::Memory::TableEntry));
         // clear that tlb
-        Arch::Memory::pageInvalidate(page);
+        Arch::Memory::pageInvalidate((void*)(i * ARCH_PAGE_SIZE));
     }
 }
 
@@ -223,6 +297,98 @@ bool isPresent(uintptr_t addr)
     return virtualMemoryBitset[addr >> ARCH_PAGE_TABLE_ENTRY_SHIFT];
 }
 
+uintptr_t getPhysicalAddress(uintptr_t addr)
+{
+    Arch::Memory::Address vaddr(addr);
+    struct Arch::Memory::TableEntry* entry = &(pageTables[vaddr.virtualAddress().dirIndex].entries[vaddr.virtualAddress().tableIndex]);
+    if (!entry->present) {
+        return 0;
+    }
+
+    return entry->getPhysicalAddress() + vaddr.virtualAddress().offset;
+}
+
+void* physToVirt(uintptr_t paddr)
+{
+    if (paddr >= physmapEnd) {
+        return NULL;
+    }
+
+    return (void*)(PHYSMAP_BASE + paddr);
+}
+
+uintptr_t virtToPhys(const void* vaddr)
+{
+    uintptr_t addr = (uintptr_t)vaddr;
+    if (inPhysmap(addr)) {
+        return addr - PHYSMAP_BASE;
+    }
+
+    return getPhysicalAddress(addr);
+}
+
+void* mapPhysical(uintptr_t paddr)
+{
+    void* vaddr = physToVirt(paddr);
+    if (vaddr) {
+        return vaddr;
+    }
+
+    // Highmem needs a temporary mapping
+    RAIIMutex lock(pagingLock);
+    size_t free_idx = findNextFreeVirtualAddress(1);
+    if (free_idx == SIZE_MAX) {
+        return NULL;
+    }
+
+    Arch::Memory::Address page(free_idx * ARCH_PAGE_SIZE);
+    *kernelPageEntry(page) = kernelTableEntry(Arch::Memory::Address(Arch::Memory::pageAlign(paddr)));
+    virtualMemoryBitset.Set(free_idx);
+    return (void*)(page.val() + (paddr & (ARCH_PAGE_SIZE - 1)));
+}
+
+void unmapPhysical(void* vaddr)
+{
+    uintptr_t addr = Arch::Memory::pageAlign((uintptr_t)vaddr);
+    if (inPhysmap(addr)) {
+        return;
+    }
+
+    RAIIMutex lock(pagingLock);
+    Arch::Memory::Address page(addr);
+    memset(kernelPageEntry(page), 0, sizeof(struct Arch::Memory::TableEntry));
+    virtualMemoryBitset.Clear(page.page().pageAddr);
+    Arch::Memory::pageInvalidate((void*)addr);
+}
+
+void* newFrame()
+{
+    uintptr_t paddr;
+    {
+        RAIIMutex lock(pagingLock);
+        size_t phys_page_idx = Physical::Manager::the().findNextFreePhysicalAddress();
+        if (phys_page_idx == Physical::Manager::npos || PAGE_IDX_TO_ADDRESS(phys_page_idx) >= physmapEnd) {
+            return NULL;
+        }
+
+        paddr = PAGE_IDX_TO_ADDRESS(phys_page_idx);
+        Physical::Manager::the().setUsed(paddr);
+    }
+
+    Metrics::adjust(framesUsed, 1);
+    // Zeroing through the physmap needs no mapping and no TLB shootdown
+    void* frame = physToVirt(paddr);
+    memset(frame, 0, ARCH_PAGE_SIZE);
+    return frame;
+}
+
+void freeFrame(void* frame)
+{
+    RAIIMutex lock(pagingLock);
+    Physical::Manager::the().setFree(virtToPhys(frame));
+    Metrics::adjust(framesUsed, -1);
+}
+
 // TODO: maybe enforce access control here in the future
 uintptr_t getPageDirPhysAddr()
 {
@@ -15,6 +15,17 @@
 #include <stddef.h>
 #include <stdint.h>
 
+// Physical memory is linearly mapped at PHYSMAP_BASE. The window ends where
+// firmware and device memory (identity mapped on demand) begin, so any RAM
+// beyond PHYSMAP_SIZE ("highmem") is only reachable through mapPhysical().
+#define PHYSMAP_BASE 0xC8000000
+#define PHYSMAP_SIZE 0x18000000 // 384 MiB
+
+// User processes own this range, every other page directory entry is shared
+// with the kernel. The kernel never allocates from it.
+#define USER_SPACE_BASE 0x40000000
+#define USER_SPACE_END  0x80000000
+
 namespace Memory {
 
 /**
@@ -54,6 +65,73 @@ void freePage(void* page, size_t size);
  */
 bool isPresent(uintptr_t addr);
 
+/**
+ * @brief Translates a mapped kernel virtual address into its physical
+ * address. Needed when handing buffers to bus mastering (DMA) devices.
+ *
+ * @param addr Virtual address
+ * @return uintptr_t Physical address (0 if the address is not mapped)
+ */
+uintptr_t getPhysicalAddress(uintptr_t addr);
+
+/**
+ * @brief Translate a physical address into its address in the physmap.
+ *
+ * @param paddr Physical address
+ * @return void* Virtual address or NULL if the address is beyond the physmap
+ */
+void* physToVirt(uintptr_t paddr);
+
+/**
+ * @brief Translate a kernel virtual address into its physical address.
+ * Physmap addresses are translated arithmetically, anything else by
+ * walking the page tables.
+ *
+ * @param vaddr Virtual address
+ * @return uintptr_t Physical address (0 if the address is not mapped)
+ */
+uintptr_t virtToPhys(const void* vaddr);
+
+/**
+ * @brief Get a kernel pointer to a physical page. Pages in the physmap are
+ * returned directly, highmem pages get a temporary mapping.
+ *
+ * @param paddr Physical address
+ * @return void* Virtual address or NULL if no virtual address space is left
+ */
+void* mapPhysical(uintptr_t paddr);
+
+/**
+ * @brief Release a pointer returned by `mapPhysical()`. Only highmem
+ * mappings are actually torn down.
+ *
+ * @param vaddr Virtual address returned by `mapPhysical()`
+ */
+void unmapPhysical(void* vaddr);
+
+/**
+ * @brief Allocate a single zeroed page frame and return its physmap address.
+ * No page tables are touched, so this is the cheapest way to get a page,
+ * e.g. for DMA buffers or page tables.
+ *
+ * @return void* Physmap address of the frame or NULL if lowmem is exhausted
+ */
+void* newFrame();
+
+/**
+ * @brief Free a page frame returned by `newFrame()`.
+ *
+ * @param frame Physmap address of the frame
+ */
+void freeFrame(void* frame);
+
+/**
+ * @brief Whether user processes can be given the user range. Fails if
+ * something had to be identity mapped into it (e.g. ACPI tables in high RAM).
+ *
+ */
+bool isUserSpaceAvailable();
+
 /**
  * @brief Gets the physical address of the current page directory.
  *
@@ -0,0 +1,234 @@
+/**
+ * @file Metrics.cpp
+ * @author Keeton Feavel (keeton@xyr.is)
+ * @brief Kernel metrics registry and serial export
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @copyright Copyright the Xyris Contributors (c) 2026
+ *
+ */
+#include <Metrics.hpp>
+#include <Bootloader/Arguments.hpp>
+#include <Devices/Serial/dump.hpp>
+#include <Devices/Serial/rs232.hpp>
+#include <IPC/Waitable.hpp>
+#include <Library/string.hpp>
+#include <Locking/LockStat.hpp>
+#include <Locking/Mutex.hpp>
+#include <Locking/RAII.hpp>
+#include <Scheduler/tasks.hpp>
+#include <Support/gcov.hpp>
+#include <Logger.hpp>
+
+#define METRICS_EXPORT_INTERVAL_NS 1000000000ULL
+
+namespace Metrics {
+
+[[gnu::aligned(4096)]] uint64_t counters[PERCPU_MAX_CPUS][METRICS_MAX];
+
+static Mutex dumpLock("metrics");
+static bool periodic = false;
+static enum Format periodicFormat = TEXT;
+static bool periodicCompressed = false;
+
+static const char* typeName(enum Type type)
+{
+    switch (type) {
+        case COUNTER:
+            return "counter";
+        case GAUGE:
+            return "gauge";
+        case HISTOGRAM:
+            return "histogram";
+        default:
+            return "unknown";
+    }
+}
+
+static uint64_t readCounter(const struct Metric& metric)
+{
+    if (metric.sampler) {
+        return metric.sampler();
+    }
+
+    size_t idx = &metric - _METRICS_START;
+    uint64_t value = 0;
+    for (size_t cpu = 0; cpu < PERCPU_MAX_CPUS; cpu++) {
+        value += __atomic_load_n(&counters[cpu][idx], __ATOMIC_RELAXED);
+    }
+
+    return value;
+}
+
+int64_t read(const struct Metric& metric)
+{
+    switch (metric.type) {
+        case COUNTER:
+            return (int64_t)readCounter(metric);
+        case GAUGE:
+            return __atomic_load_n((int64_t*)metric.data, __ATOMIC_RELAXED);
+        case HISTOGRAM:
+            return (int64_t)__atomic_load_n(&((struct Histogram*)metric.data)->count, __ATOMIC_RELAXED);
+        default:
+            return 0;
+    }
+}
+
+const struct Metric* find(const char* name)
+{
+    for (const struct Metric* metric = _METRICS_START; metric < _METRICS_END; metric++) {
+        if (strcmp(metric->name, name) == 0) {
+            return metric;
+        }
+    }
+
+    return NULL;
+}
+
+static void dumpText(RS232::Dump& out, const struct Metric& metric)
+{
+    if (metric.type != HISTOGRAM) {
+        out.printf("metric %s %s %lld %s\n", typeName(metric.type), metric.name, read(metric), metric.unit);
+        return;
+    }
+
+    auto histogram = (struct Histogram*)metric.data;
+    out.printf("metric histogram %s %llu %s sum=%llu",
+        metric.name,
+        __atomic_load_n(&histogram->count, __ATOMIC_RELAXED),
+        metric.unit,
+        __atomic_load_n(&histogram->sum, __ATOMIC_RELAXED));
+    for (size_t bucket = 0; bucket < METRICS_HISTOGRAM_BUCKETS; bucket++) {
+        uint32_t count = __atomic_load_n(&histogram->buckets[bucket], __ATOMIC_RELAXED);
+        if (count) {
+            out.printf(" b%zu=%lu", bucket, count);
+        }
+    }
+    out.printf("\n");
+}
+
+static void dumpJSON(RS232::Dump& out, const struct Metric& metric)
+{
+    out.printf("{\"name\":\"%s\",\"type\":\"%s\",\"unit\":\"%s\",", metric.name, typeName(metric.type), metric.unit);
+    if (metric.type != HISTOGRAM) {
+        out.printf("\"value\":%lld}", read(metric));
+        return;
+    }
+
+    auto histogram = (struct Histogram*)metric.data;
+    out.printf("\"value\":%llu,\"sum\":%llu,\"buckets\":[",
+        __atomic_load_n(&histogram->count, __ATOMIC_RELAXED),
+        __atomic_load_n(&histogram->sum, __ATOMIC_RELAXED));
+    for (size_t bucket = 0; bucket < METRICS_HISTOGRAM_BUCKETS; bucket++) {
+        out.printf(bucket ? ",%lu" : "%lu", __atomic_load_n(&histogram->buckets[bucket], __ATOMIC_RELAXED));
+    }
+    out.printf("]}");
+}
+
+void dump(enum Format format, bool compressed)
+{
+    // dumps are written piecemeal, so keep concurrent ones from interleaving
+    RAIIMutex lock(dumpLock);
+    RS232::Dump out(compressed);
+    uint64_t now = tasks_get_time_ns();
+    if (format == JSON) {
+        out.printf("{\"time_ns\":%llu,\"metrics\":[", now);
+        for (const struct Metric* metric = _METRICS_START; metric < _METRICS_END; metric++) {
+            if (metric != _METRICS_START) {
+                out.printf(",");
+            }
+            dumpJSON(out, *metric);
+        }
+        out.printf("]}\n");
+    } else {
+        out.printf("metrics begin %llu\n", now);
+        for (const struct Metric* metric = _METRICS_START; metric < _METRICS_END; metric++) {
+            dumpText(out, *metric);
+        }
+        out.printf("metrics end\n");
+    }
+}
+
+static void runCommand(char command)
+{
+    char lower = (command >= 'A' && command <= 'Z') ? (char)(command - 'A' + 'a') : command;
+    for (const struct Command* entry = _SERIAL_COMMANDS_START; entry < _SERIAL_COMMANDS_END; entry++) {
+        if (entry->command == lower) {
+            entry->handler(command);
+            return;
+        }
+    }
+}
+
+void exporter(void)
+{
+    if (_METRICS_END - _METRICS_START > METRICS_MAX) {
+        Logger::Error(__func__, "%zu metrics declared, only %d supported", (size_t)(_METRICS_END - _METRICS_START), METRICS_MAX);
+        return;
+    }
+
+    RS232::Port* serial = RS232::port(RS_232_COM1);
+    IPC::Timer timer;
+    IPC::Waitable* sources[] = { serial, &timer };
+    if (periodic) {
+        timer.arm(METRICS_EXPORT_INTERVAL_NS);
+    }
+
+    for (;;) {
+        bool ready[2];
+        IPC::waitAny(sources, 2, ready, WAIT_FOREVER);
+
+        if (ready[0]) {
+            char command;
+            while (serial->read(&command, 1)) {
+                // upper case commands send the dump compressed
+                if (command == 'm' || command == 'M') {
+                    dump(TEXT, command == 'M');
+                } else if (command == 'j' || command == 'J') {
+                    dump(JSON, command == 'J');
+#if defined(LOCKSTAT)
+                } else if (command == 'l' || command == 'L') {
+                    LockStat::dump(command == 'L');
+#endif
+#if defined(GCOV)
+                } else if (command == 'g') {
+                    Gcov::dump();
+#endif
+                } else {
+                    runCommand(command);
+                }
+            }
+        }
+        if (ready[1]) {
+            dump(periodicFormat, periodicCompressed);
+            timer.armAt(timer.deadline() + METRICS_EXPORT_INTERVAL_NS);
+        }
+    }
+}
+
+// Kernel argument callbacks
+static void argumentCallback(const char* arg)
+{
+    (void)arg;
+    periodic = true;
+}
+
+static void jsonArgumentCallback(const char* arg)
+{
+    (void)arg;
+    periodic = true;
+    periodicFormat = JSON;
+}
+
+static void compressedArgumentCallback(const char* arg)
+{
+    (void)arg;
+    periodicCompressed = true;
+}
+
+KERNEL_PARAM(metricsArg, "--metrics", argumentCallback);
+KERNEL_PARAM(metricsJSONArg, "--metrics-json", jsonArgumentCallback);
+KERNEL_PARAM(metricsLZ4Arg, "--metrics-lz4", compressedArgumentCallback);
+
+} // !namespace Metrics
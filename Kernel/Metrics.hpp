@@ -0,0 +1,207 @@
+/**
+ * @file Metrics.hpp
+ * @author Keeton Feavel (keeton@xyr.is)
+ * @brief Kernel metrics registry. Metrics are declared statically with the
+ * METRIC_* macros, which place them in the `.metrics` linker section so they
+ * can all be enumerated without registering anything at runtime. Counters
+ * are kept per CPU and only summed when read, so updating them never
+ * bounces a cache line between CPUs.
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @copyright Copyright the Xyris Contributors (c) 2026
+ *
+ */
+#pragma once
+
+#include <Arch/Arch.hpp>
+#include <stddef.h>
+#include <stdint.h>
+
+#define METRICS_MAX                 128
+#define METRICS_HISTOGRAM_BUCKETS   32  // Bucket n counts values below 2^n (and at least 2^(n - 1))
+
+/**
+ * @brief Declare a counter, a monotonically increasing value.
+ *
+ * @param var Variable name used with `Metrics::add()`
+ * @param name Dotted metric name, e.g. "sched.context_switches"
+ * @param unit Unit of the value, e.g. "bytes"
+ */
+#define METRIC_COUNTER(var, name, unit) \
+    [[gnu::section(".metrics"), gnu::used]] static struct Metrics::Metric var = \
+    { name, unit, Metrics::COUNTER, NULL, NULL }
+
+/**
+ * @brief Declare a counter whose value is kept elsewhere and read through a
+ * function, for statistics that already exist (e.g. in the per-CPU data).
+ *
+ */
+#define METRIC_COUNTER_SAMPLED(var, name, unit, sampler) \
+    [[gnu::section(".metrics"), gnu::used]] static struct Metrics::Metric var = \
+    { name, unit, Metrics::COUNTER, NULL, sampler }
+
+/**
+ * @brief Declare a gauge, a value that can go up and down.
+ *
+ */
+#define METRIC_GAUGE(var, name, unit) \
+    static int64_t var##Value; \
+    [[gnu::section(".metrics"), gnu::used]] static struct Metrics::Metric var = \
+    { name, unit, Metrics::GAUGE, &var##Value, NULL }
+
+/**
+ * @brief Declare a histogram of values in power of two buckets.
+ *
+ */
+#define METRIC_HISTOGRAM(var, name, unit) \
+    static struct Metrics::Histogram var##Data; \
+    [[gnu::section(".metrics"), gnu::used]] static struct Metrics::Metric var = \
+    { name, unit, Metrics::HISTOGRAM, &var##Data, NULL }
+
+/**
+ * @brief Handle a command received by the exporter task over serial. The
+ * command is given in lower case and matches either case, and the handler
+ * receives the character as it was sent.
+ *
+ * @param var Variable name
+ * @param command Command character (lower case)
+ * @param handler Function taking the received character
+ */
+#define SERIAL_COMMAND(var, command, handler) \
+    [[gnu::section(".serial_commands"), gnu::used]] static const struct Metrics::Command var = \
+    { command, handler }
+
+namespace Metrics {
+
+enum Type {
+    COUNTER,
+    GAUGE,
+    HISTOGRAM,
+};
+
+enum Format {
+    TEXT,
+    JSON,
+};
+
+struct Histogram {
+    uint64_t count;
+    uint64_t sum;
+    uint32_t buckets[METRICS_HISTOGRAM_BUCKETS];
+};
+
+struct alignas(32) Metric {
+    const char* name;
+    const char* unit;
+    enum Type type;
+    void* data;                 // Gauge value or histogram, NULL for counters
+    uint64_t (*sampler)(void);  // Reads a counter kept elsewhere, may be NULL
+};
+static_assert(sizeof(struct Metric) == 32, "Metric index computation relies on the size");
+
+struct Command {
+    char command;
+    void (*handler)(char command);
+};
+
+} // !namespace Metrics
+
+/* Moved outside of sections.hpp since this is only desired if using metrics */
+extern struct Metrics::Metric _METRICS_START[0];
+extern struct Metrics::Metric _METRICS_END[0];
+extern const struct Metrics::Command _SERIAL_COMMANDS_START[0];
+extern const struct Metrics::Command _SERIAL_COMMANDS_END[0];
+
+namespace Metrics {
+
+// Counter values, one row per CPU. Rows are page aligned so CPUs never share cache lines.
+extern uint64_t counters[PERCPU_MAX_CPUS][METRICS_MAX];
+
+/**
+ * @brief Add to a counter.
+ *
+ */
+[[gnu::always_inline]] inline void add(struct Metric& metric, uint64_t value)
+{
+    // the slot normally belongs to this CPU alone, the atomic only guards
+    // against the task migrating between reading the CPU index and the add
+    __atomic_fetch_add(&counters[this_cpu_read(id)][&metric - _METRICS_START], value, __ATOMIC_RELAXED);
+}
+
+[[gnu::always_inline]] inline void inc(struct Metric& metric)
+{
+    add(metric, 1);
+}
+
+/**
+ * @brief Set a gauge.
+ *
+ */
+[[gnu::always_inline]] inline void set(struct Metric& metric, int64_t value)
+{
+    __atomic_store_n((int64_t*)metric.data, value, __ATOMIC_RELAXED);
+}
+
+/**
+ * @brief Adjust a gauge.
+ *
+ */
+[[gnu::always_inline]] inline void adjust(struct Metric& metric, int64_t delta)
+{
+    __atomic_fetch_add((int64_t*)metric.data, delta, __ATOMIC_RELAXED);
+}
+
+/**
+ * @brief Record a value in a histogram.
+ *
+ */
+[[gnu::always_inline]] inline void record(struct Metric& metric, uint64_t value)
+{
+    auto histogram = (struct Histogram*)metric.data;
+    size_t bucket = value ? 64 - __builtin_clzll(value) : 0;
+    if (bucket >= METRICS_HISTOGRAM_BUCKETS) {
+        bucket = METRICS_HISTOGRAM_BUCKETS - 1;
+    }
+
+    __atomic_fetch_add(&histogram->buckets[bucket], 1, __ATOMIC_RELAXED);
+    __atomic_fetch_add(&histogram->count, 1, __ATOMIC_RELAXED);
+    __atomic_fetch_add(&histogram->sum, value, __ATOMIC_RELAXED);
+}
+
+/**
+ * @brief Read the value of a counter or gauge. For histograms this is the
+ * number of recorded values.
+ *
+ */
+int64_t read(const struct Metric& metric);
+
+/**
+ * @brief Look up a metric by name.
+ *
+ * @return const Metric* The metric, or NULL if there is none by that name
+ */
+const struct Metric* find(const char* name);
+
+/**
+ * @brief Write every metric to the serial console. `Meta/metrics-diff.py`
+ * compares two dumps taken from a serial log.
+ *
+ * @param format Plain text (one metric per line) or a single JSON line
+ * @param compressed Send the dump as an LZ4 frame (see `RS232::Dump`)
+ */
+void dump(enum Format format, bool compressed = false);
+
+/**
+ * @brief Metrics export task. Dumps the metrics whenever 'm' (text) or 'j'
+ * (JSON) is received over serial, and once a second when the kernel is
+ * booted with `--metrics` (or `--metrics-json`). Kernels built with LOCKSTAT
+ * dump lock statistics on 'l'. Upper case commands, and `--metrics-lz4` for
+ * the periodic dumps, send the dump compressed. 'g' sends the profile
+ * counters of kernels built with `scons pgo=generate` (see `Gcov::dump`).
+ * Any other command is passed to its `SERIAL_COMMAND` handler.
+ *
+ */
+void exporter(void);
+
+} // !namespace Metrics
@@ -0,0 +1,222 @@
+/**
+ * @file ARP.cpp
+ * @author Keeton Feavel (keeton@xyr.is)
+ * @brief Address Resolution Protocol. Resolves IPv4 next hops to hardware
+ * addresses, holding outgoing packets until the reply arrives.
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @copyright Copyright the Xyris Contributors (c) 2026
+ *
+ */
+#include <Arch/Arch.hpp>
+#include <Arch/i686/timer.hpp> // TODO: Remove ASAP
+#include <Library/string.hpp>
+#include <Network/ARP.hpp>
+#include <Network/Ethernet.hpp>
+#include <Network/IPv4.hpp>
+
+#define ARP_HARDWARE_ETHERNET   1
+#define ARP_OPERATION_REQUEST   1
+#define ARP_OPERATION_REPLY     2
+
+namespace Network::ARP {
+
+struct [[gnu::packed]] Packet {
+    uint16_t hardwareType;
+    uint16_t protocolType;
+    uint8_t hardwareLength;
+    uint8_t protocolLength;
+    uint16_t operation;
+    uint8_t senderHardware[NET_MAC_LENGTH];
+    IPv4Address senderProtocol;
+    uint8_t targetHardware[NET_MAC_LENGTH];
+    IPv4Address targetProtocol;
+};
+static_assert(sizeof(struct Packet) == 28);
+
+enum EntryState {
+    Free,
+    Pending,
+    Resolved,
+};
+
+struct Entry {
+    enum EntryState state;
+    IPv4Address address;
+    uint8_t hardware[NET_MAC_LENGTH];
+    uint32_t lastRequest;
+    PacketBuffer* pending;
+    size_t pendingCount;
+};
+
+// Accessed from the network poll task and from any sending task
+static struct Entry cache[ARP_CACHE_SIZE];
+static size_t nextVictim = 0;
+
+static struct Entry* lookup(IPv4Address address)
+{
+    for (size_t i = 0; i < ARP_CACHE_SIZE; i++) {
+        if (cache[i].state != Free && cache[i].address == address) {
+            return &cache[i];
+        }
+    }
+
+    return NULL;
+}
+
+static struct Entry* allocate(IPv4Address address)
+{
+    struct Entry* entry = NULL;
+    for (size_t i = 0; i < ARP_CACHE_SIZE; i++) {
+        if (cache[i].state == Free) {
+            entry = &cache[i];
+            break;
+        }
+    }
+
+    if (!entry) {
+        // Evict round robin. Packets waiting on the victim are dropped.
+        entry = &cache[nextVictim];
+        nextVictim = (nextVictim + 1) % ARP_CACHE_SIZE;
+        while (entry->pending) {
+            PacketBuffer* packet = entry->pending;
+            entry->pending = packet->next;
+            releasePacket(packet);
+        }
+    }
+
+    entry->state = Pending;
+    entry->address = address;
+    entry->lastRequest = 0;
+    entry->pending = NULL;
+    entry->pendingCount = 0;
+    return entry;
+}
+
+static void send(uint16_t operation, const uint8_t* hardware, IPv4Address address)
+{
+    PacketBuffer* packet = allocPacket();
+    if (!packet) {
+        return;
+    }
+
+    struct Packet* arp = (struct Packet*)packet->put(sizeof(struct Packet));
+    arp->hardwareType = hostToNetwork16(ARP_HARDWARE_ETHERNET);
+    arp->protocolType = hostToNetwork16(ETHERNET_TYPE_IPV4);
+    arp->hardwareLength = NET_MAC_LENGTH;
+    arp->protocolLength = sizeof(IPv4Address);
+    arp->operation = hostToNetwork16(operation);
+    memcpy(arp->senderHardware, Ethernet::address(), NET_MAC_LENGTH);
+    arp->senderProtocol = IPv4::address();
+    memcpy(arp->targetHardware, operation == ARP_OPERATION_REQUEST ? Ethernet::broadcast : hardware, NET_MAC_LENGTH);
+    arp->targetProtocol = address;
+
+    Ethernet::send(packet, operation == ARP_OPERATION_REQUEST ? Ethernet::broadcast : hardware, ETHERNET_TYPE_ARP);
+}
+
+static void input(PacketBuffer* packet)
+{
+    struct Packet* arp = (struct Packet*)packet->data();
+    if (packet->length < sizeof(struct Packet)
+        || networkToHost16(arp->hardwareType) != ARP_HARDWARE_ETHERNET
+        || networkToHost16(arp->protocolType) != ETHERNET_TYPE_IPV4) {
+        releasePacket(packet);
+        return;
+    }
+
+    bool forUs = arp->targetProtocol == IPv4::address();
+    PacketBuffer* pending = NULL;
+    Arch::CPU::criticalRegionNestable([&]() {
+        // Learn the sender if it is already known or if it is talking to us
+        struct Entry* entry = lookup(arp->senderProtocol);
+        if (!entry && forUs) {
+            entry = allocate(arp->senderProtocol);
+        }
+
+        if (entry) {
+            memcpy(entry->hardware, arp->senderHardware, NET_MAC_LENGTH);
+            entry->state = Resolved;
+            pending = entry->pending;
+            entry->pending = NULL;
+            entry->pendingCount = 0;
+        }
+    });
+
+    // Release packets that were waiting for this address
+    while (pending) {
+        PacketBuffer* next = pending->next;
+        pending->next = NULL;
+        Ethernet::send(pending, arp->senderHardware, ETHERNET_TYPE_IPV4);
+        pending = next;
+    }
+
+    if (forUs && networkToHost16(arp->operation) == ARP_OPERATION_REQUEST) {
+        send(ARP_OPERATION_REPLY, arp->senderHardware, arp->senderProtocol);
+    }
+
+    releasePacket(packet);
+}
+
+void init()
+{
+    Ethernet::registerProtocol(ETHERNET_TYPE_ARP, input);
+}
+
+bool output(PacketBuffer* packet, IPv4Address nextHop)
+{
+    if (nextHop == NET_IPV4(255, 255, 255, 255)) {
+        return Ethernet::send(packet, Ethernet::broadcast, ETHERNET_TYPE_IPV4);
+    }
+
+    uint8_t hardware[NET_MAC_LENGTH];
+    bool resolved = false;
+    bool queued = false;
+    bool request = false;
+    Arch::CPU::criticalRegionNestable([&]() {
+        struct Entry* entry = lookup(nextHop);
+        if (!entry) {
+            entry = allocate(nextHop);
+        }
+
+        if (entry->state == Resolved) {
+            memcpy(hardware, entry->hardware, NET_MAC_LENGTH);
+            resolved = true;
+            return;
+        }
+
+        if (entry->pendingCount < ARP_MAX_PENDING) {
+            // Keep packets in order by appending to the pending list
+            PacketBuffer** tail = &entry->pending;
+            while (*tail) {
+                tail = &(*tail)->next;
+            }
+            packet->next = NULL;
+            *tail = packet;
+            entry->pendingCount++;
+            queued = true;
+        }
+
+        if (!entry->lastRequest || timer_tick - entry->lastRequest >= ARP_RETRY_TICKS) {
+            entry->lastRequest = timer_tick ? timer_tick : 1;
+            request = true;
+        }
+    });
+
+    if (request) {
+        send(ARP_OPERATION_REQUEST, NULL, nextHop);
+        Ethernet::flush();
+    }
+
+    if (resolved) {
+        return Ethernet::send(packet, hardware, ETHERNET_TYPE_IPV4);
+    }
+
+    if (!queued) {
+        releasePacket(packet);
+    }
+
+    return queued;
+}
+
+} // !namespace Network::ARP
@@ -0,0 +1,41 @@
+/**
+ * @file ARP.hpp
+ * @author Keeton Feavel (keeton@xyr.is)
+ * @brief Address Resolution Protocol. Resolves IPv4 next hops to hardware
+ * addresses, holding outgoing packets until the reply arrives.
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @copyright Copyright the Xyris Contributors (c) 2026
+ *
+ * References:
+ *         https://datatracker.ietf.org/doc/html/rfc826
+ */
+#pragma once
+#include <Network/Network.hpp>
+#include <Network/PacketBuffer.hpp>
+
+#define ARP_CACHE_SIZE      16
+#define ARP_MAX_PENDING     8       // Packets held per unresolved address
+#define ARP_RETRY_TICKS     1000    // Minimum time between requests for an address
+
+namespace Network::ARP {
+
+/**
+ * @brief Register the ARP handler with the link layer.
+ *
+ */
+void init();
+
+/**
+ * @brief Transmit an IPv4 packet to a next hop on the local network,
+ * resolving its hardware address first if necessary. Takes ownership of
+ * the packet.
+ *
+ * @param packet IPv4 packet
+ * @param nextHop Next hop address
+ * @return true Packet was sent or queued until the address resolves
+ */
+bool output(PacketBuffer* packet, IPv4Address nextHop);
+
+} // !namespace Network::ARP
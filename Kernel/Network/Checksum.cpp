@@ -0,0 +1,96 @@
+/**
+ * @file Checksum.cpp
+ * @author Keeton Feavel (keeton@xyr.is)
+ * @brief Internet (ones' complement) checksum helpers. Sums are accumulated
+ * incrementally as data is added so that no layer has to walk the payload
+ * a second time.
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @copyright Copyright the Xyris Contributors (c) 2026
+ *
+ */
+#include <Network/Checksum.hpp>
+
+namespace Network {
+
+// Fold the carries back in often enough that a 32-bit sum cannot overflow
+[[gnu::always_inline]] static inline uint32_t reduce(uint32_t sum)
+{
+    return (sum & 0xFFFF) + (sum >> 16);
+}
+
+uint32_t checksumPartial(const void* data, size_t length, uint32_t sum)
+{
+    const uint8_t* bytes = (const uint8_t*)data;
+    while (length > 1) {
+        sum += (uint32_t)((bytes[0] << 8) | bytes[1]);
+        bytes += 2;
+        length -= 2;
+        if (sum & 0x80000000) {
+            sum = reduce(sum);
+        }
+    }
+
+    if (length) {
+        sum += (uint32_t)(bytes[0] << 8);
+    }
+
+    return reduce(sum);
+}
+
+uint32_t checksumCopy(void* destination, const void* source, size_t length, uint32_t sum)
+{
+    const uint8_t* src = (const uint8_t*)source;
+    uint8_t* dst = (uint8_t*)destination;
+    while (length > 1) {
+        dst[0] = src[0];
+        dst[1] = src[1];
+        sum += (uint32_t)((src[0] << 8) | src[1]);
+        src += 2;
+        dst += 2;
+        length -= 2;
+        if (sum & 0x80000000) {
+            sum = reduce(sum);
+        }
+    }
+
+    if (length) {
+        dst[0] = src[0];
+        sum += (uint32_t)(src[0] << 8);
+    }
+
+    return reduce(sum);
+}
+
+uint32_t checksumCombine(uint32_t sum, uint32_t block, size_t offset)
+{
+    // A block starting on an odd offset has its bytes swapped relative to
+    // the word boundaries. Byte swapping the folded sum corrects for it.
+    if (offset & 1) {
+        block = reduce(reduce(block));
+        block = ((block & 0xFF) << 8) | (block >> 8);
+    }
+
+    return reduce(sum + block);
+}
+
+uint16_t checksumFold(uint32_t sum)
+{
+    while (sum >> 16) {
+        sum = reduce(sum);
+    }
+
+    return (uint16_t)~sum;
+}
+
+uint16_t checksumUpdate(uint16_t checksum, uint16_t previous, uint16_t value)
+{
+    // HC' = ~(~HC + ~m + m')
+    uint32_t sum = (uint16_t)~checksum;
+    sum += (uint16_t)~previous;
+    sum += value;
+    return checksumFold(sum);
+}
+
+} // !namespace Network
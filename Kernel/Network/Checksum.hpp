@@ -0,0 +1,74 @@
+/**
+ * @file Checksum.hpp
+ * @author Keeton Feavel (keeton@xyr.is)
+ * @brief Internet (ones' complement) checksum helpers. Sums are accumulated
+ * incrementally as data is added so that no layer has to walk the payload
+ * a second time.
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @copyright Copyright the Xyris Contributors (c) 2026
+ *
+ * References:
+ *         https://datatracker.ietf.org/doc/html/rfc1071
+ *         https://datatracker.ietf.org/doc/html/rfc1624
+ */
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+
+namespace Network {
+
+/**
+ * @brief Add a block of data to a partial checksum. Data is summed as big
+ * endian 16-bit words. Blocks must start on an even offset of the checksummed
+ * region; use `checksumCombine` to join blocks that do not.
+ *
+ * @param data Data to sum
+ * @param length Length of the data in bytes
+ * @param sum Partial checksum to add to
+ * @return uint32_t Updated partial checksum
+ */
+uint32_t checksumPartial(const void* data, size_t length, uint32_t sum);
+
+/**
+ * @brief Copy data and add it to a partial checksum in a single pass.
+ *
+ * @param destination Copy destination
+ * @param source Copy source
+ * @param length Length of the data in bytes
+ * @param sum Partial checksum to add to
+ * @return uint32_t Updated partial checksum
+ */
+uint32_t checksumCopy(void* destination, const void* source, size_t length, uint32_t sum);
+
+/**
+ * @brief Combine two partial checksums where the second block starts at
+ * `offset` bytes into the checksummed region.
+ *
+ * @param sum Partial checksum of the preceding data
+ * @param block Partial checksum of the new block
+ * @param offset Offset of the new block
+ * @return uint32_t Combined partial checksum
+ */
+uint32_t checksumCombine(uint32_t sum, uint32_t block, size_t offset);
+
+/**
+ * @brief Fold a partial checksum into the final 16-bit checksum (host byte order).
+ *
+ * @param sum Partial checksum
+ * @return uint16_t Ones' complement checksum
+ */
+uint16_t checksumFold(uint32_t sum);
+
+/**
+ * @brief Incrementally update a checksum after a 16-bit field changed (RFC 1624).
+ *
+ * @param checksum Existing checksum (host byte order)
+ * @param previous Previous field value (host byte order)
+ * @param value New field value (host byte order)
+ * @return uint16_t Updated checksum
+ */
+uint16_t checksumUpdate(uint16_t checksum, uint16_t previous, uint16_t value);
+
+} // !namespace Network
@@ -0,0 +1,85 @@
+/**
+ * @file Ethernet.cpp
+ * @author Keeton Feavel (keeton@xyr.is)
+ * @brief Ethernet (link) layer. Dispatches received frames to protocol
+ * handlers by EtherType and prepends link headers on transmit.
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @copyright Copyright the Xyris Contributors (c) 2026
+ *
+ */
+#include <Devices/Virtio/net.hpp>
+#include <Library/string.hpp>
+#include <Network/Ethernet.hpp>
+
+namespace Network::Ethernet {
+
+struct Protocol {
+    uint16_t type;
+    ProtocolHandler handler;
+};
+
+const uint8_t broadcast[NET_MAC_LENGTH] = { 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF };
+static struct Protocol protocols[ETHERNET_MAX_PROTOCOLS];
+static size_t protocolCount = 0;
+
+static void input(PacketBuffer* packet)
+{
+    struct Header* header = (struct Header*)packet->data();
+    if (!packet->pull(sizeof(struct Header))) {
+        releasePacket(packet);
+        return;
+    }
+
+    uint16_t type = networkToHost16(header->type);
+    for (size_t i = 0; i < protocolCount; i++) {
+        if (protocols[i].type == type) {
+            protocols[i].handler(packet);
+            return;
+        }
+    }
+
+    releasePacket(packet);
+}
+
+void init()
+{
+    VirtioNet::setReceiveHandler(input);
+}
+
+bool registerProtocol(uint16_t type, ProtocolHandler handler)
+{
+    if (protocolCount == ETHERNET_MAX_PROTOCOLS) {
+        return false;
+    }
+
+    protocols[protocolCount++] = { type, handler };
+    return true;
+}
+
+const uint8_t* address()
+{
+    return VirtioNet::macAddress();
+}
+
+bool send(PacketBuffer* packet, const uint8_t* destination, uint16_t type)
+{
+    struct Header* header = (struct Header*)packet->push(sizeof(struct Header));
+    if (!header) {
+        releasePacket(packet);
+        return false;
+    }
+
+    memcpy(header->destination, destination, NET_MAC_LENGTH);
+    memcpy(header->source, address(), NET_MAC_LENGTH);
+    header->type = hostToNetwork16(type);
+    return VirtioNet::transmit(packet);
+}
+
+void flush()
+{
+    VirtioNet::transmitFlush();
+}
+
+} // !namespace Network::Ethernet
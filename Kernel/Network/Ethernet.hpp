@@ -0,0 +1,79 @@
+/**
+ * @file Ethernet.hpp
+ * @author Keeton Feavel (keeton@xyr.is)
+ * @brief Ethernet (link) layer. Dispatches received frames to protocol
+ * handlers by EtherType and prepends link headers on transmit.
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @copyright Copyright the Xyris Contributors (c) 2026
+ *
+ */
+#pragma once
+#include <Network/Network.hpp>
+#include <Network/PacketBuffer.hpp>
+#include <stddef.h>
+#include <stdint.h>
+
+#define ETHERNET_TYPE_IPV4      0x0800
+#define ETHERNET_TYPE_ARP       0x0806
+#define ETHERNET_MTU            1500
+#define ETHERNET_MAX_PROTOCOLS  4
+
+namespace Network::Ethernet {
+
+struct [[gnu::packed]] Header {
+    uint8_t destination[NET_MAC_LENGTH];
+    uint8_t source[NET_MAC_LENGTH];
+    uint16_t type;  // Network byte order
+};
+static_assert(sizeof(struct Header) == 14);
+
+/**
+ * @brief Receives a frame with the link header already removed. The handler
+ * takes ownership of the packet.
+ *
+ */
+typedef void (*ProtocolHandler)(PacketBuffer* packet);
+
+extern const uint8_t broadcast[NET_MAC_LENGTH];
+
+/**
+ * @brief Attach the link layer to the network device.
+ *
+ */
+void init();
+
+/**
+ * @brief Register a handler for an EtherType.
+ *
+ * @param type EtherType (host byte order)
+ * @param handler Protocol handler
+ * @return true Handler was registered
+ */
+bool registerProtocol(uint16_t type, ProtocolHandler handler);
+
+/**
+ * @brief Hardware address of the interface.
+ *
+ */
+const uint8_t* address();
+
+/**
+ * @brief Prepend a link header and transmit the frame. Takes ownership of the packet.
+ *
+ * @param packet Packet (payload only)
+ * @param destination Destination hardware address
+ * @param type EtherType (host byte order)
+ * @return true Frame was queued for transmission
+ */
+bool send(PacketBuffer* packet, const uint8_t* destination, uint16_t type);
+
+/**
+ * @brief Notify the device of any frames queued by `send()`. Frames are
+ * otherwise sent in batches.
+ *
+ */
+void flush();
+
+} // !namespace Network::Ethernet
@@ -0,0 +1,131 @@
+/**
+ * @file IPv4.cpp
+ * @author Keeton Feavel (keeton@xyr.is)
+ * @brief Internet Protocol version 4. Single interface, no fragmentation.
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @copyright Copyright the Xyris Contributors (c) 2026
+ *
+ */
+#include <Network/ARP.hpp>
+#include <Network/Checksum.hpp>
+#include <Network/Ethernet.hpp>
+#include <Network/IPv4.hpp>
+#include <Network/UDP.hpp>
+
+#define IPV4_VERSION            4
+#define IPV4_FRAGMENT_MORE      0x2000
+#define IPV4_FRAGMENT_OFFSET    0x1FFF
+#define IPV4_BROADCAST          NET_IPV4(255, 255, 255, 255)
+
+namespace Network::IPv4 {
+
+static IPv4Address localAddress;
+static IPv4Address localNetmask;
+static IPv4Address localGateway;
+static uint16_t identification = 0;
+
+static void input(PacketBuffer* packet)
+{
+    struct Header* header = (struct Header*)packet->data();
+    if (packet->length < sizeof(struct Header) || (header->versionLength >> 4) != IPV4_VERSION) {
+        releasePacket(packet);
+        return;
+    }
+
+    size_t headerLength = (header->versionLength & 0xF) * 4;
+    size_t totalLength = networkToHost16(header->totalLength);
+    if (headerLength < sizeof(struct Header)
+        || totalLength < headerLength
+        || totalLength > packet->totalLength()
+        || checksumFold(checksumPartial(header, headerLength, 0)) != 0) {
+        releasePacket(packet);
+        return;
+    }
+
+    // Fragment reassembly is not supported
+    if (networkToHost16(header->fragment) & (IPV4_FRAGMENT_MORE | IPV4_FRAGMENT_OFFSET)) {
+        releasePacket(packet);
+        return;
+    }
+
+    if (header->destination != localAddress && header->destination != IPV4_BROADCAST) {
+        releasePacket(packet);
+        return;
+    }
+
+    // Drop link layer padding
+    if (!packet->fragment) {
+        packet->length = (uint16_t)totalLength;
+    }
+
+    IPv4Address source = header->source;
+    IPv4Address destination = header->destination;
+    uint8_t protocol = header->protocol;
+    packet->pull((uint16_t)headerLength);
+
+    switch (protocol) {
+        case IPV4_PROTOCOL_UDP:
+            UDP::input(packet, source, destination);
+            break;
+        default:
+            releasePacket(packet);
+            break;
+    }
+}
+
+void init()
+{
+    configure(IPV4_DEFAULT_ADDRESS, IPV4_DEFAULT_NETMASK, IPV4_DEFAULT_GATEWAY);
+    ARP::init();
+    Ethernet::registerProtocol(ETHERNET_TYPE_IPV4, input);
+}
+
+void configure(IPv4Address address, IPv4Address netmask, IPv4Address gateway)
+{
+    localAddress = address;
+    localNetmask = netmask;
+    localGateway = gateway;
+}
+
+IPv4Address address()
+{
+    return localAddress;
+}
+
+bool send(PacketBuffer* packet, IPv4Address destination, uint8_t protocol)
+{
+    size_t length = packet->totalLength() + sizeof(struct Header);
+    if (length > ETHERNET_MTU) {
+        releasePacket(packet);
+        return false;
+    }
+
+    struct Header* header = (struct Header*)packet->push(sizeof(struct Header));
+    if (!header) {
+        releasePacket(packet);
+        return false;
+    }
+
+    header->versionLength = (IPV4_VERSION << 4) | (sizeof(struct Header) / 4);
+    header->serviceType = 0;
+    header->totalLength = hostToNetwork16((uint16_t)length);
+    header->identification = hostToNetwork16(__atomic_fetch_add(&identification, 1, __ATOMIC_RELAXED));
+    header->fragment = 0;
+    header->ttl = IPV4_DEFAULT_TTL;
+    header->protocol = protocol;
+    header->checksum = 0;
+    header->source = localAddress;
+    header->destination = destination;
+    header->checksum = hostToNetwork16(checksumFold(checksumPartial(header, sizeof(struct Header), 0)));
+
+    IPv4Address nextHop = destination;
+    if (destination != IPV4_BROADCAST && (destination & localNetmask) != (localAddress & localNetmask)) {
+        nextHop = localGateway;
+    }
+
+    return ARP::output(packet, nextHop);
+}
+
+} // !namespace Network::IPv4
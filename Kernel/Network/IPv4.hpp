@@ -0,0 +1,73 @@
+/**
+ * @file IPv4.hpp
+ * @author Keeton Feavel (keeton@xyr.is)
+ * @brief Internet Protocol version 4. Single interface, no fragmentation.
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @copyright Copyright the Xyris Contributors (c) 2026
+ *
+ * References:
+ *         https://datatracker.ietf.org/doc/html/rfc791
+ */
+#pragma once
+#include <Network/Network.hpp>
+#include <Network/PacketBuffer.hpp>
+
+#define IPV4_PROTOCOL_UDP   17
+#define IPV4_DEFAULT_TTL    64
+
+// Defaults match the QEMU user mode (slirp) network
+#define IPV4_DEFAULT_ADDRESS    NET_IPV4(10, 0, 2, 15)
+#define IPV4_DEFAULT_NETMASK    NET_IPV4(255, 255, 255, 0)
+#define IPV4_DEFAULT_GATEWAY    NET_IPV4(10, 0, 2, 2)
+
+namespace Network::IPv4 {
+
+struct [[gnu::packed]] Header {
+    uint8_t versionLength;  // Version (4) and header length in 32-bit words
+    uint8_t serviceType;
+    uint16_t totalLength;
+    uint16_t identification;
+    uint16_t fragment;
+    uint8_t ttl;
+    uint8_t protocol;
+    uint16_t checksum;
+    IPv4Address source;
+    IPv4Address destination;
+};
+static_assert(sizeof(struct Header) == 20);
+
+/**
+ * @brief Register the IPv4 handler with the link layer and apply the
+ * default interface configuration.
+ *
+ */
+void init();
+
+/**
+ * @brief Configure the interface.
+ *
+ * @param address Interface address
+ * @param netmask Network mask
+ * @param gateway Default gateway
+ */
+void configure(IPv4Address address, IPv4Address netmask, IPv4Address gateway);
+
+/**
+ * @brief Address of the interface.
+ *
+ */
+IPv4Address address();
+
+/**
+ * @brief Prepend an IPv4 header and route the packet. Takes ownership of the packet.
+ *
+ * @param packet Transport layer packet
+ * @param destination Destination address
+ * @param protocol Transport protocol number
+ * @return true Packet was sent (or queued awaiting address resolution)
+ */
+bool send(PacketBuffer* packet, IPv4Address destination, uint8_t protocol);
+
+} // !namespace Network::IPv4
@@ -0,0 +1,31 @@
+/**
+ * @file Network.cpp
+ * @author Keeton Feavel (keeton@xyr.is)
+ * @brief Network stack initialization and common definitions
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @copyright Copyright the Xyris Contributors (c) 2026
+ *
+ */
+#include <Devices/Virtio/net.hpp>
+#include <Network/Ethernet.hpp>
+#include <Network/IPv4.hpp>
+#include <Network/Network.hpp>
+#include <Network/PacketBuffer.hpp>
+
+namespace Network {
+
+void init()
+{
+    initPacketPool();
+    VirtioNet::init();
+    if (!VirtioNet::isPresent()) {
+        return;
+    }
+
+    Ethernet::init();
+    IPv4::init();
+}
+
+} // !namespace Network
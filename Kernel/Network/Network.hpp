@@ -0,0 +1,56 @@
+/**
+ * @file Network.hpp
+ * @author Keeton Feavel (keeton@xyr.is)
+ * @brief Network stack initialization and common definitions
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @copyright Copyright the Xyris Contributors (c) 2026
+ *
+ */
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+
+#define NET_MAC_LENGTH 6
+
+// Build an IPv4 address (in network byte order) from its dotted quad form
+#define NET_IPV4(a, b, c, d) \
+    ((uint32_t)(a) | ((uint32_t)(b) << 8) | ((uint32_t)(c) << 16) | ((uint32_t)(d) << 24))
+
+namespace Network {
+
+/**
+ * @brief IPv4 address stored in network byte order.
+ *
+ */
+typedef uint32_t IPv4Address;
+
+[[gnu::always_inline]] inline uint16_t hostToNetwork16(uint16_t val)
+{
+    return __builtin_bswap16(val);
+}
+
+[[gnu::always_inline]] inline uint32_t hostToNetwork32(uint32_t val)
+{
+    return __builtin_bswap32(val);
+}
+
+[[gnu::always_inline]] inline uint16_t networkToHost16(uint16_t val)
+{
+    return __builtin_bswap16(val);
+}
+
+[[gnu::always_inline]] inline uint32_t networkToHost32(uint32_t val)
+{
+    return __builtin_bswap32(val);
+}
+
+/**
+ * @brief Initialize the packet pool, network devices, and protocol layers.
+ * Must be called after the scheduler is initialized.
+ *
+ */
+void init();
+
+} // !namespace Network
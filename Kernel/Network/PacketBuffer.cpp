@@ -0,0 +1,142 @@
+/**
+ * @file PacketBuffer.cpp
+ * @author Keeton Feavel (keeton@xyr.is)
+ * @brief Reference counted, page backed network packet buffers. Buffers are
+ * handed directly to devices for DMA and passed up (or down) the network
+ * stack without copying.
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @copyright Copyright the Xyris Contributors (c) 2026
+ *
+ */
+#include <Arch/Arch.hpp>
+#include <Memory/paging.hpp>
+#include <Network/PacketBuffer.hpp>
+#include <Logger.hpp>
+
+namespace Network {
+
+static struct PacketBuffer packets[NET_PACKET_POOL_SIZE];
+static struct PacketBuffer* freeList = NULL;
+static size_t freeCount = 0;
+
+void PacketBuffer::reserve(uint16_t len)
+{
+    offset = (uint16_t)(offset + len);
+}
+
+uint8_t* PacketBuffer::push(uint16_t len)
+{
+    if (len > offset) {
+        return NULL;
+    }
+
+    offset = (uint16_t)(offset - len);
+    length = (uint16_t)(length + len);
+    return data();
+}
+
+uint8_t* PacketBuffer::pull(uint16_t len)
+{
+    if (len > length) {
+        return NULL;
+    }
+
+    offset = (uint16_t)(offset + len);
+    length = (uint16_t)(length - len);
+    return data();
+}
+
+uint8_t* PacketBuffer::put(uint16_t len)
+{
+    if (len > tailroom()) {
+        return NULL;
+    }
+
+    uint8_t* tail = data() + length;
+    length = (uint16_t)(length + len);
+    return tail;
+}
+
+size_t PacketBuffer::totalLength()
+{
+    size_t total = 0;
+    for (struct PacketBuffer* frag = this; frag; frag = frag->fragment) {
+        total += frag->length;
+    }
+
+    return total;
+}
+
+void initPacketPool()
+{
+    for (size_t i = 0; i < NET_PACKET_POOL_SIZE; i++) {
+        struct PacketBuffer* packet = &packets[i];
+        packet->page = (uint8_t*)Memory::newFrame();
+        if (!packet->page) {
+            Logger::Warning(__func__, "Packet pool limited to %zu buffers", i);
+            break;
+        }
+
+        packet->physical = Memory::virtToPhys(packet->page);
+        packet->refs = 0;
+        packet->fragment = NULL;
+        packet->next = freeList;
+        freeList = packet;
+        freeCount++;
+    }
+}
+
+PacketBuffer* allocPacket()
+{
+    struct PacketBuffer* packet = NULL;
+    Arch::CPU::criticalRegionNestable([&packet]() {
+        if ((packet = freeList)) {
+            freeList = packet->next;
+            freeCount--;
+        }
+    });
+
+    if (packet) {
+        packet->offset = NET_PACKET_HEADROOM;
+        packet->length = 0;
+        packet->refs = 1;
+        packet->next = NULL;
+        packet->fragment = NULL;
+        packet->checksum = 0;
+        packet->checksumValid = false;
+    }
+
+    return packet;
+}
+
+void retainPacket(PacketBuffer* packet)
+{
+    for (; packet; packet = packet->fragment) {
+        __atomic_add_fetch(&packet->refs, 1, __ATOMIC_RELAXED);
+    }
+}
+
+void releasePacket(PacketBuffer* packet)
+{
+    while (packet) {
+        struct PacketBuffer* fragment = packet->fragment;
+        if (__atomic_sub_fetch(&packet->refs, 1, __ATOMIC_ACQ_REL) == 0) {
+            packet->fragment = NULL;
+            Arch::CPU::criticalRegionNestable([packet]() {
+                packet->next = freeList;
+                freeList = packet;
+                freeCount++;
+            });
+        }
+        packet = fragment;
+    }
+}
+
+size_t packetsAvailable()
+{
+    return freeCount;
+}
+
+} // !namespace Network
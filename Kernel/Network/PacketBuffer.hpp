@@ -0,0 +1,122 @@
+/**
+ * @file PacketBuffer.hpp
+ * @author Keeton Feavel (keeton@xyr.is)
+ * @brief Reference counted, page backed network packet buffers. Buffers are
+ * handed directly to devices for DMA and passed up (or down) the network
+ * stack without copying.
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @copyright Copyright the Xyris Contributors (c) 2026
+ *
+ */
+#pragma once
+#include <Arch/Memory.hpp>
+#include <stddef.h>
+#include <stdint.h>
+
+#define NET_PACKET_SIZE         ARCH_PAGE_SIZE  // Each buffer owns exactly one page
+#define NET_PACKET_HEADROOM     128             // Space reserved for headers prepended on transmit
+#define NET_PACKET_POOL_SIZE    256             // Number of buffers in the pool (1 MiB)
+#define NET_PACKET_CONTROL_SIZE 16              // Per-layer scratch space
+
+namespace Network {
+
+/**
+ * @brief A single packet (or fragment of a packet) backed by one physical page.
+ * Valid data lives in [offset, offset + length) within the page.
+ *
+ */
+struct PacketBuffer {
+    uint8_t* page;                  // Start of the backing page
+    uintptr_t physical;             // Physical address of the backing page
+    uint16_t offset;                // Start of valid data within the page
+    uint16_t length;                // Length of valid data
+    uint32_t refs;                  // Reference count (atomic)
+    struct PacketBuffer* next;      // Queue and free list link
+    struct PacketBuffer* fragment;  // Next buffer of a multi-buffer packet
+    uint32_t checksum;              // Partial checksum of the payload (if checksumValid)
+    bool checksumValid;             // Payload checksum was accumulated as data was added
+    uint8_t control[NET_PACKET_CONTROL_SIZE]; // Scratch space owned by the current layer
+
+    uint8_t* data() { return page + offset; }
+    uintptr_t dataPhysical() { return physical + offset; }
+    uint16_t headroom() { return offset; }
+    uint16_t tailroom() { return (uint16_t)(NET_PACKET_SIZE - offset - length); }
+
+    /**
+     * @brief Reserve space at the front of an empty buffer for headers.
+     *
+     * @param len Bytes to reserve
+     */
+    void reserve(uint16_t len);
+
+    /**
+     * @brief Prepend space to the packet (e.g. to add a header).
+     *
+     * @param len Bytes to prepend
+     * @return uint8_t* Start of the new data or NULL if there is not enough headroom
+     */
+    uint8_t* push(uint16_t len);
+
+    /**
+     * @brief Remove bytes from the front of the packet (e.g. to strip a header).
+     *
+     * @param len Bytes to remove
+     * @return uint8_t* Start of the remaining data or NULL if the packet is too short
+     */
+    uint8_t* pull(uint16_t len);
+
+    /**
+     * @brief Append space to the end of the packet.
+     *
+     * @param len Bytes to append
+     * @return uint8_t* Start of the appended space or NULL if there is not enough tailroom
+     */
+    uint8_t* put(uint16_t len);
+
+    /**
+     * @brief Total length of the packet including all fragments.
+     *
+     */
+    size_t totalLength();
+};
+
+/**
+ * @brief Allocate the packet buffer pool. Must be called after paging is enabled.
+ *
+ */
+void initPacketPool();
+
+/**
+ * @brief Take a buffer from the pool. The buffer has a reference count of
+ * one and `NET_PACKET_HEADROOM` bytes of headroom reserved. Safe to call
+ * from interrupt context.
+ *
+ * @return PacketBuffer* Buffer or NULL if the pool is exhausted
+ */
+PacketBuffer* allocPacket();
+
+/**
+ * @brief Take an additional reference to a packet (and its fragments).
+ *
+ * @param packet Packet buffer
+ */
+void retainPacket(PacketBuffer* packet);
+
+/**
+ * @brief Drop a reference to a packet. Buffers (including fragments) are
+ * returned to the pool once the last reference is dropped. Safe to call
+ * from interrupt context.
+ *
+ * @param packet Packet buffer
+ */
+void releasePacket(PacketBuffer* packet);
+
+/**
+ * @brief Number of buffers currently available in the pool.
+ *
+ */
+size_t packetsAvailable();
+
+} // !namespace Network
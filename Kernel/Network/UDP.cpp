@@ -0,0 +1,276 @@
+/**
+ * @file UDP.cpp
+ * @author Keeton Feavel (keeton@xyr.is)
+ * @brief User Datagram Protocol sockets. Received datagrams are handed to
+ * sockets through lock-free rings, without copying.
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @copyright Copyright the Xyris Contributors (c) 2026
+ *
+ */
+#include <Arch/Arch.hpp>
+#include <Library/string.hpp>
+#include <Network/Checksum.hpp>
+#include <Network/IPv4.hpp>
+#include <Network/UDP.hpp>
+
+namespace Network::UDP {
+
+struct Source {
+    IPv4Address address;
+    uint16_t port;
+};
+static_assert(sizeof(struct Source) <= NET_PACKET_CONTROL_SIZE);
+
+static Socket* sockets[UDP_MAX_SOCKETS];
+static uint16_t nextEphemeral = UDP_EPHEMERAL_START;
+
+/**
+ * @brief Partial checksum of the parts of the pseudo and UDP headers that
+ * stay constant for a flow (addresses, protocol, and ports).
+ *
+ */
+static uint32_t flowChecksum(IPv4Address source, IPv4Address destination, uint16_t sourcePort, uint16_t destinationPort)
+{
+    uint32_t sum = checksumPartial(&source, sizeof(source), 0);
+    sum = checksumPartial(&destination, sizeof(destination), sum);
+    return sum + IPV4_PROTOCOL_UDP + sourcePort + destinationPort;
+}
+
+static uint32_t payloadChecksum(PacketBuffer* packet)
+{
+    uint32_t sum = 0;
+    size_t offset = 0;
+    for (PacketBuffer* frag = packet; frag; frag = frag->fragment) {
+        sum = checksumCombine(sum, checksumPartial(frag->data(), frag->length, 0), offset);
+        offset += frag->length;
+    }
+
+    return sum;
+}
+
+static Socket* lookup(uint16_t port)
+{
+    for (size_t i = 0; i < UDP_MAX_SOCKETS; i++) {
+        Socket* socket = __atomic_load_n(&sockets[i], __ATOMIC_ACQUIRE);
+        if (socket && socket->localPort() == port) {
+            return socket;
+        }
+    }
+
+    return NULL;
+}
+
+void input(PacketBuffer* packet, IPv4Address source, IPv4Address destination)
+{
+    struct Header* header = (struct Header*)packet->data();
+    size_t length = packet->totalLength();
+    if (length < sizeof(struct Header) || networkToHost16(header->length) > length || networkToHost16(header->length) < sizeof(struct Header)) {
+        releasePacket(packet);
+        return;
+    }
+
+    // Drop anything past the datagram
+    length = networkToHost16(header->length);
+    if (!packet->fragment) {
+        packet->length = (uint16_t)length;
+    }
+
+    // A zero checksum means the sender did not compute one
+    if (header->checksum) {
+        uint32_t sum = checksumPartial(&source, sizeof(source), 0);
+        sum = checksumPartial(&destination, sizeof(destination), sum);
+        sum += IPV4_PROTOCOL_UDP + length;
+        if (checksumFold(sum + payloadChecksum(packet)) != 0) {
+            releasePacket(packet);
+            return;
+        }
+    }
+
+    Socket* socket = lookup(networkToHost16(header->destinationPort));
+    if (!socket) {
+        releasePacket(packet);
+        return;
+    }
+
+    struct Source* from = (struct Source*)packet->control;
+    from->address = source;
+    from->port = networkToHost16(header->sourcePort);
+    packet->pull(sizeof(struct Header));
+
+    if (!socket->m_ring.Enqueue(packet)) {
+        socket->m_dropped++;
+        releasePacket(packet);
+    }
+}
+
+Socket::Socket()
+    : m_localPort(0)
+    , m_remoteAddress(0)
+    , m_remotePort(0)
+    , m_flowChecksum(0)
+    , m_dropped(0)
+{
+}
+
+Socket::~Socket()
+{
+    close();
+}
+
+bool Socket::bind(uint16_t port)
+{
+    bool bound = false;
+    Arch::CPU::criticalRegionNestable([&]() {
+        if (m_localPort) {
+            return;
+        }
+
+        if (!port) {
+            // Pick the next ephemeral port that is not in use
+            for (size_t tries = 0; tries < UDP_MAX_SOCKETS + 1; tries++) {
+                uint16_t candidate = nextEphemeral;
+                nextEphemeral = (uint16_t)(nextEphemeral == 0xFFFF ? UDP_EPHEMERAL_START : nextEphemeral + 1);
+                if (!lookup(candidate)) {
+                    port = candidate;
+                    break;
+                }
+            }
+        }
+
+        if (!port || lookup(port)) {
+            return;
+        }
+
+        for (size_t i = 0; i < UDP_MAX_SOCKETS; i++) {
+            if (!sockets[i]) {
+                m_localPort = port;
+                __atomic_store_n(&sockets[i], this, __ATOMIC_RELEASE);
+                bound = true;
+                return;
+            }
+        }
+    });
+
+    return bound;
+}
+
+bool Socket::connect(IPv4Address address, uint16_t port)
+{
+    if (!m_localPort && !bind(0)) {
+        return false;
+    }
+
+    m_remoteAddress = address;
+    m_remotePort = port;
+    m_flowChecksum = flowChecksum(IPv4::address(), address, m_localPort, port);
+    return true;
+}
+
+void Socket::close()
+{
+    Arch::CPU::criticalRegionNestable([this]() {
+        for (size_t i = 0; i < UDP_MAX_SOCKETS; i++) {
+            if (sockets[i] == this) {
+                __atomic_store_n(&sockets[i], NULL, __ATOMIC_RELEASE);
+            }
+        }
+    });
+
+    PacketBuffer* packet;
+    while (m_ring.Dequeue(&packet)) {
+        releasePacket(packet);
+    }
+    m_localPort = 0;
+}
+
+PacketBuffer* Socket::allocate()
+{
+    PacketBuffer* packet = allocPacket();
+    if (packet) {
+        // An empty payload has a valid (zero) checksum
+        packet->checksumValid = true;
+    }
+
+    return packet;
+}
+
+bool Socket::append(PacketBuffer* packet, const void* data, size_t length)
+{
+    if (packet->length + length > UDP_MAX_PAYLOAD) {
+        return false;
+    }
+
+    size_t offset = packet->length;
+    uint8_t* destination = packet->put((uint16_t)length);
+    if (packet->checksumValid) {
+        packet->checksum = checksumCombine(packet->checksum, checksumCopy(destination, data, length, 0), offset);
+    } else {
+        memcpy(destination, data, length);
+    }
+
+    return true;
+}
+
+bool Socket::send(PacketBuffer* packet)
+{
+    if (!m_remotePort) {
+        releasePacket(packet);
+        return false;
+    }
+
+    return transmit(packet, m_remoteAddress, m_remotePort, m_flowChecksum);
+}
+
+bool Socket::sendTo(PacketBuffer* packet, IPv4Address address, uint16_t port)
+{
+    if (!m_localPort && !bind(0)) {
+        releasePacket(packet);
+        return false;
+    }
+
+    return transmit(packet, address, port, flowChecksum(IPv4::address(), address, m_localPort, port));
+}
+
+bool Socket::transmit(PacketBuffer* packet, IPv4Address address, uint16_t port, uint32_t flow)
+{
+    // Use the checksum accumulated while the payload was written, if any
+    uint32_t sum = packet->checksumValid ? packet->checksum : payloadChecksum(packet);
+    uint16_t length = (uint16_t)(packet->totalLength() + sizeof(struct Header));
+
+    struct Header* header = (struct Header*)packet->push(sizeof(struct Header));
+    if (!header) {
+        releasePacket(packet);
+        return false;
+    }
+
+    header->sourcePort = hostToNetwork16(m_localPort);
+    header->destinationPort = hostToNetwork16(port);
+    header->length = hostToNetwork16(length);
+    // Length appears in both the pseudo header and the UDP header
+    uint16_t checksum = checksumFold(flow + sum + length + length);
+    header->checksum = hostToNetwork16(checksum ? checksum : 0xFFFF);
+
+    return IPv4::send(packet, address, IPV4_PROTOCOL_UDP);
+}
+
+PacketBuffer* Socket::receive(IPv4Address* address, uint16_t* port)
+{
+    PacketBuffer* packet;
+    if (!m_ring.Dequeue(&packet)) {
+        return NULL;
+    }
+
+    struct Source* from = (struct Source*)packet->control;
+    if (address) {
+        *address = from->address;
+    }
+    if (port) {
+        *port = from->port;
+    }
+
+    return packet;
+}
+
+} // !namespace Network::UDP
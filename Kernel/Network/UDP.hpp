@@ -0,0 +1,144 @@
+/**
+ * @file UDP.hpp
+ * @author Keeton Feavel (keeton@xyr.is)
+ * @brief User Datagram Protocol sockets. Received datagrams are handed to
+ * sockets through lock-free rings, without copying.
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @copyright Copyright the Xyris Contributors (c) 2026
+ *
+ * References:
+ *         https://datatracker.ietf.org/doc/html/rfc768
+ */
+#pragma once
+#include <Library/SPSCRingBuffer.hpp>
+#include <Network/Network.hpp>
+#include <Network/PacketBuffer.hpp>
+
+#define UDP_MAX_SOCKETS         16
+#define UDP_RING_SIZE           64      // Datagrams buffered per socket
+#define UDP_EPHEMERAL_START     49152
+#define UDP_MAX_PAYLOAD         1472    // Ethernet MTU less IPv4 and UDP headers
+
+namespace Network::UDP {
+
+struct [[gnu::packed]] Header {
+    uint16_t sourcePort;
+    uint16_t destinationPort;
+    uint16_t length;
+    uint16_t checksum;
+};
+static_assert(sizeof(struct Header) == 8);
+
+/**
+ * @brief A UDP endpoint. Datagrams are received by one consumer task (the
+ * network poll task is the only producer), so the receive ring needs no locks.
+ *
+ */
+class Socket {
+public:
+    Socket();
+    ~Socket();
+
+    /**
+     * @brief Bind the socket to a local port.
+     *
+     * @param port Local port (0 for an ephemeral port)
+     * @return true Socket was bound
+     * @return false Port is in use or no sockets are available
+     */
+    bool bind(uint16_t port);
+
+    /**
+     * @brief Set the default destination. The pseudo header checksum of the
+     * flow is computed once here instead of for every datagram.
+     *
+     * @param address Remote address
+     * @param port Remote port
+     * @return true Socket is connected
+     */
+    bool connect(IPv4Address address, uint16_t port);
+
+    /**
+     * @brief Unbind the socket and drop any datagrams waiting to be received.
+     *
+     */
+    void close();
+
+    /**
+     * @brief Allocate a buffer for an outgoing datagram with headroom for
+     * all protocol headers.
+     *
+     * @return PacketBuffer* Empty datagram or NULL if no buffers are available
+     */
+    PacketBuffer* allocate();
+
+    /**
+     * @brief Copy data into a datagram, accumulating its checksum in the same pass.
+     *
+     * @param packet Datagram from `allocate()`
+     * @param data Data to append
+     * @param length Length of the data
+     * @return true Data was appended
+     * @return false Datagram would exceed UDP_MAX_PAYLOAD
+     */
+    bool append(PacketBuffer* packet, const void* data, size_t length);
+
+    /**
+     * @brief Send a datagram to the connected destination. Takes ownership of the packet.
+     *
+     */
+    bool send(PacketBuffer* packet);
+
+    /**
+     * @brief Send a datagram. Takes ownership of the packet.
+     *
+     * @param packet Datagram payload
+     * @param address Destination address
+     * @param port Destination port
+     * @return true Datagram was sent (or queued awaiting address resolution)
+     */
+    bool sendTo(PacketBuffer* packet, IPv4Address address, uint16_t port);
+
+    /**
+     * @brief Take the next received datagram without blocking. The caller
+     * owns the returned packet and must release it.
+     *
+     * @param address Source address of the datagram (may be NULL)
+     * @param port Source port of the datagram (may be NULL)
+     * @return PacketBuffer* Datagram payload or NULL if none are waiting
+     */
+    PacketBuffer* receive(IPv4Address* address = NULL, uint16_t* port = NULL);
+
+    /**
+     * @brief Number of datagrams dropped because the receive ring was full.
+     *
+     */
+    uint64_t dropped() { return m_dropped; }
+
+    uint16_t localPort() { return m_localPort; }
+
+private:
+    friend void input(PacketBuffer* packet, IPv4Address source, IPv4Address destination);
+
+    bool transmit(PacketBuffer* packet, IPv4Address address, uint16_t port, uint32_t flowChecksum);
+
+    uint16_t m_localPort;
+    IPv4Address m_remoteAddress;
+    uint16_t m_remotePort;
+    uint32_t m_flowChecksum;
+    SPSCRingBuffer<PacketBuffer*, UDP_RING_SIZE> m_ring;
+    uint64_t m_dropped;
+};
+
+/**
+ * @brief Deliver a received datagram to its socket. Called by the IPv4 layer.
+ *
+ * @param packet Datagram (UDP header included)
+ * @param source Source address
+ * @param destination Destination address
+ */
+void input(PacketBuffer* packet, IPv4Address source, IPv4Address destination);
+
+} // !namespace Network::UDP
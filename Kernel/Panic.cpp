@@ -12,6 +12,7 @@
 #include <Devices/Graphics/framebuffer.hpp>
 #include <Devices/Graphics/graphics.hpp>
 #include <Devices/Serial/rs232.hpp>
+#include <Devices/Virtio/console.hpp>
 #include <Library/stdio.hpp>
 #include <Panic.hpp>
 #include <Stacktrace.hpp>
@@ -65,6 +66,8 @@ static void printMoo()
 
 [[noreturn]] static void panicInternal(const char* msg, struct registers *registers)
 {
+    // Get any buffered log output out before the panic message
+    VirtioConsole::flush();
     printMoo();
     if (msg) {
         log_all("%s\n\n", msg);
@@ -76,6 +79,7 @@ static void printMoo()
         log_all("%s", buf);
     }
     Stack::printTrace(PANIC_MAX_TRACE);
+    VirtioConsole::flush();
     Arch::haltAndCatchFire();
 }
 
@@ -0,0 +1,158 @@
+/**
+ * @file cpuidle.cpp
+ * @author Keeton Feavel (keeton@xyr.is)
+ * @brief CPU idle state selection. The scheduler's idle loop asks for the
+ * deepest state whose target residency fits the predicted idle period and
+ * per-state entry counts and residency are recorded.
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @copyright Copyright the Xyris Contributors (c) 2026
+ *
+ * References:
+ *         Intel SDM Vol. 2B, MONITOR/MWAIT
+ *         Intel SDM Vol. 3A, 14.6 "MONITOR/MWAIT Extensions for Power Management"
+ */
+#include <Scheduler/cpuidle.hpp>
+#include <Devices/ACPI/acpi.hpp>
+#include <Logger.hpp>
+#include <cpuid.h>
+
+#define CPUID_FEAT_ECX_MONITOR      (1 << 3)
+#define CPUID_MWAIT_LEAF            0x05
+#define CPUID_MWAIT_ECX_EXTENSIONS  (1 << 0)
+
+#define CPUIDLE_C1_LATENCY_NS       1000        // Used when nothing better is known
+#define CPUIDLE_C2_LATENCY_NS       20000
+#define CPUIDLE_C3_LATENCY_NS       100000
+#define CPUIDLE_RESIDENCY_FACTOR    3           // Target residency as a multiple of exit latency
+
+static struct cpuidle_state _states[CPUIDLE_MAX_STATES];
+static size_t _state_count = 0;
+static uint64_t (*_clock)(void) = NULL;
+
+static void _add_state(const char *name, bool mwait, uint32_t hint, uint64_t latency_ns)
+{
+    if (_state_count == CPUIDLE_MAX_STATES) {
+        return;
+    }
+
+    _states[_state_count++] = {
+        .name = name,
+        .mwait = mwait,
+        .hint = hint,
+        .exit_latency_ns = latency_ns,
+        .target_residency_ns = latency_ns * CPUIDLE_RESIDENCY_FACTOR,
+        .entries = 0,
+        .residency_ns = 0,
+    };
+}
+
+static void _discover_mwait_states()
+{
+    uint32_t eax, ebx, ecx, edx;
+    __cpuid(0, eax, ebx, ecx, edx);
+    if (eax < CPUID_MWAIT_LEAF) {
+        return;
+    }
+
+    __cpuid(1, eax, ebx, ecx, edx);
+    if (!(ecx & CPUID_FEAT_ECX_MONITOR)) {
+        return;
+    }
+
+    // MWAIT C1 is always available once MONITOR/MWAIT is supported
+    _add_state("MWAIT-C1", true, 0x00, CPUIDLE_C1_LATENCY_NS);
+
+    __cpuid(CPUID_MWAIT_LEAF, eax, ebx, ecx, edx);
+    if (!(ecx & CPUID_MWAIT_ECX_EXTENSIONS)) {
+        return;
+    }
+
+    // Prefer the platform's worst case latencies (in microseconds) when ACPI reports them
+    uint64_t c2_latency = CPUIDLE_C2_LATENCY_NS;
+    uint64_t c3_latency = CPUIDLE_C3_LATENCY_NS;
+    const struct ACPI::FADT* fadt = ACPI::fadt();
+    if (fadt) {
+        if (fadt->c2Latency && fadt->c2Latency <= 100) {
+            c2_latency = fadt->c2Latency * 1000ULL;
+        }
+        if (fadt->c3Latency && fadt->c3Latency <= 1000) {
+            c3_latency = fadt->c3Latency * 1000ULL;
+        }
+    }
+
+    // EDX holds the number of MWAIT sub-states for C0 through C3 in 4-bit fields
+    if ((edx >> 8) & 0xF) {
+        _add_state("MWAIT-C2", true, 0x10, c2_latency);
+    }
+    if ((edx >> 12) & 0xF) {
+        _add_state("MWAIT-C3", true, 0x20, c3_latency);
+    }
+}
+
+void cpuidle_init(uint64_t (*clock)(void))
+{
+    _clock = clock;
+    _state_count = 0;
+    _add_state("HLT", false, 0, CPUIDLE_C1_LATENCY_NS);
+    _discover_mwait_states();
+
+    for (size_t i = 0; i < _state_count; i++) {
+        Logger::Info(__func__, "State %zu: %s (exit %llu ns, target residency %llu ns)",
+            i, _states[i].name, _states[i].exit_latency_ns, _states[i].target_residency_ns);
+    }
+}
+
+size_t cpuidle_select(uint64_t predicted_ns)
+{
+    // States are ordered shallowest first, so the last one that fits is the deepest
+    size_t selected = 0;
+    for (size_t i = 1; i < _state_count; i++) {
+        if (_states[i].target_residency_ns <= predicted_ns) {
+            selected = i;
+        }
+    }
+
+    return selected;
+}
+
+void cpuidle_enter(uint64_t predicted_ns, struct task *const volatile *wake)
+{
+    if (*wake != NULL) {
+        return;
+    }
+
+    struct cpuidle_state *state = &_states[cpuidle_select(predicted_ns)];
+    uint64_t start = _clock();
+
+    if (state->mwait) {
+        // Arm the monitor first, then check again so that a write landing
+        // between the first check and the MONITOR can't be missed
+        asm volatile("monitor" : : "a"(wake), "c"(0), "d"(0));
+        if (*wake == NULL) {
+            // STI only takes effect after the next instruction, so an
+            // interrupt can't sneak in before MWAIT is waiting
+            asm volatile("sti; mwait; cli" : : "a"(state->hint), "c"(0) : "memory");
+        }
+    } else {
+        asm volatile("sti; hlt; cli" : : : "memory");
+    }
+
+    state->entries++;
+    state->residency_ns += _clock() - start;
+}
+
+size_t cpuidle_state_count(void)
+{
+    return _state_count;
+}
+
+const struct cpuidle_state *cpuidle_get_state(size_t index)
+{
+    if (index >= _state_count) {
+        return NULL;
+    }
+
+    return &_states[index];
+}
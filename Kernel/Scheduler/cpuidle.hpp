@@ -0,0 +1,73 @@
+/**
+ * @file cpuidle.hpp
+ * @author Keeton Feavel (keeton@xyr.is)
+ * @brief CPU idle state selection. The scheduler's idle loop asks for the
+ * deepest state whose target residency fits the predicted idle period and
+ * per-state entry counts and residency are recorded (exported by the
+ * scheduler as the `sched.cpuidle.<index>.*` metrics).
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @copyright Copyright the Xyris Contributors (c) 2026
+ *
+ * References:
+ *         Intel SDM Vol. 2B, MONITOR/MWAIT
+ *         Intel SDM Vol. 3A, 14.6 "MONITOR/MWAIT Extensions for Power Management"
+ */
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#define CPUIDLE_MAX_STATES 4
+
+struct task;
+
+struct cpuidle_state
+{
+    const char *name;
+    bool mwait;                     // Entered with MONITOR/MWAIT instead of HLT
+    uint32_t hint;                  // MWAIT hint (EAX) for this state
+    uint64_t exit_latency_ns;       // Worst case time to leave the state
+    uint64_t target_residency_ns;   // Minimum idle period that makes the state worthwhile
+    uint64_t entries;               // Number of times the state was entered
+    uint64_t residency_ns;          // Total time spent in the state
+};
+
+/**
+ * @brief Discover the available idle states. Must be called after the
+ * clock passed in is usable (i.e. after TSC calibration).
+ *
+ * @param clock Monotonic clock (in nanoseconds) used for residency accounting
+ */
+void cpuidle_init(uint64_t (*clock)(void));
+/**
+ * @brief Pick the deepest idle state whose target residency fits within
+ * the predicted idle period.
+ *
+ * @param predicted_ns Expected time until the next wakeup (in nanoseconds)
+ * @return size_t Index of the selected state
+ */
+size_t cpuidle_select(uint64_t predicted_ns);
+/**
+ * @brief Idle the CPU until the next interrupt or, for MWAIT states, until
+ * `*wake` is written. Must be called with interrupts disabled and returns
+ * with interrupts disabled.
+ *
+ * @param predicted_ns Expected time until the next wakeup (in nanoseconds)
+ * @param wake Run queue head that is monitored for writes. The CPU does
+ * not idle at all if it is already non-NULL.
+ */
+void cpuidle_enter(uint64_t predicted_ns, struct task *const volatile *wake);
+/**
+ * @brief Number of idle states available on this CPU.
+ *
+ */
+size_t cpuidle_state_count(void);
+/**
+ * @brief Get an idle state and its statistics.
+ *
+ * @param index State index (0 is always HLT)
+ * @return const struct cpuidle_state* State or NULL if the index is out of range
+ */
+const struct cpuidle_state *cpuidle_get_state(size_t index);
@@ -0,0 +1,140 @@
+/**
+ * @file rcu.cpp
+ * @author Keeton Feavel (keeton@xyr.is)
+ * @brief Quiescent-state based RCU. Each CPU counts the quiescent states it
+ * passes through and a grace period has elapsed once every online CPU's
+ * count has moved past a snapshot taken when it began.
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @copyright Copyright the Xyris Contributors (c) 2026
+ *
+ */
+#include <Scheduler/rcu.hpp>
+#include <Arch/Arch.hpp>
+#include <Panic.hpp>
+
+struct rcu_cblist
+{
+    struct rcu_head *head;
+    struct rcu_head **tail;
+};
+
+// Callbacks move from pending (grace period not started) to waiting (grace
+// period in progress) to done (ready to run). All three are only touched
+// with interrupts disabled.
+static struct rcu_cblist _pending = { NULL, &_pending.head };
+static struct rcu_cblist _waiting = { NULL, &_waiting.head };
+static struct rcu_cblist _done = { NULL, &_done.head };
+static uint32_t _waiting_snapshot[PERCPU_MAX_CPUS];
+
+static void _cblist_splice(struct rcu_cblist *dst, struct rcu_cblist *src)
+{
+    if (src->head == NULL) {
+        return;
+    }
+
+    *dst->tail = src->head;
+    dst->tail = src->tail;
+    src->head = NULL;
+    src->tail = &src->head;
+}
+
+static inline bool _cpu_online(const struct percpu *cpu)
+{
+    return cpu->self != NULL;
+}
+
+static void _snapshot(uint32_t *snapshot)
+{
+    for (uint32_t i = 0; i < PERCPU_MAX_CPUS; i++) {
+        const struct percpu *cpu = PerCPU::block(i);
+        snapshot[i] = __atomic_load_n(&cpu->rcu_qs, __ATOMIC_ACQUIRE);
+    }
+}
+
+static bool _grace_period_elapsed(const uint32_t *snapshot)
+{
+    for (uint32_t i = 0; i < PERCPU_MAX_CPUS; i++) {
+        const struct percpu *cpu = PerCPU::block(i);
+        if (_cpu_online(cpu) && __atomic_load_n(&cpu->rcu_qs, __ATOMIC_ACQUIRE) == snapshot[i]) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+bool rcu_note_quiescent_state()
+{
+    // release so that a CPU seeing the new count also sees this CPU's
+    // accesses from before the quiescent state as finished
+    __atomic_store_n(&this_cpu_ptr()->rcu_qs, this_cpu_read(rcu_qs) + 1, __ATOMIC_RELEASE);
+
+    if (_waiting.head != NULL && _grace_period_elapsed(_waiting_snapshot)) {
+        _cblist_splice(&_done, &_waiting);
+    }
+    if (_waiting.head == NULL && _pending.head != NULL) {
+        // start a grace period for everything queued so far
+        _cblist_splice(&_waiting, &_pending);
+        _snapshot(_waiting_snapshot);
+    }
+
+    return _done.head != NULL;
+}
+
+void call_rcu(struct rcu_head *head, void (*func)(struct rcu_head *head))
+{
+    head->next = NULL;
+    head->func = func;
+    Arch::CPU::criticalRegionNestable([head]() {
+        *_pending.tail = head;
+        _pending.tail = &head->next;
+    });
+}
+
+size_t rcu_invoke_callbacks()
+{
+    struct rcu_cblist ready = { NULL, &ready.head };
+    Arch::CPU::criticalRegionNestable([&ready]() {
+        _cblist_splice(&ready, &_done);
+    });
+
+    size_t count = 0;
+    struct rcu_head *head = ready.head;
+    while (head != NULL) {
+        // the callback usually frees the object holding head
+        struct rcu_head *next = head->next;
+        head->func(head);
+        head = next;
+        count++;
+    }
+
+    return count;
+}
+
+void synchronize_rcu()
+{
+    if (this_cpu_read(preempt_count) != 0) {
+        panic("synchronize_rcu() called with preemption disabled");
+    }
+
+    // the caller isn't in a read-side section, so this CPU is already
+    // quiescent and only the others need to be waited on
+    uint32_t snapshot[PERCPU_MAX_CPUS];
+    Arch::CPU::criticalRegionNestable([&snapshot]() {
+        _snapshot(snapshot);
+    });
+
+    uint32_t self = this_cpu_read(id);
+    for (uint32_t i = 0; i < PERCPU_MAX_CPUS; i++) {
+        const struct percpu *cpu = PerCPU::block(i);
+        if (i == self || !_cpu_online(cpu)) {
+            continue;
+        }
+
+        while (__atomic_load_n(&cpu->rcu_qs, __ATOMIC_ACQUIRE) == snapshot[i]) {
+            tasks_schedule();
+        }
+    }
+}
@@ -0,0 +1,147 @@
+/**
+ * @file rcu.hpp
+ * @author Keeton Feavel (keeton@xyr.is)
+ * @brief Read-copy-update. Readers of read-mostly data take no locks and
+ * writers publish new versions with `rcu_assign_pointer()`, then wait for a
+ * grace period before reclaiming the old version. A grace period ends once
+ * every CPU has passed through a quiescent state, which is any point where
+ * the scheduler runs with preemption enabled (read-side sections disable
+ * preemption, so no reader can still hold a reference at that point).
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @copyright Copyright the Xyris Contributors (c) 2026
+ *
+ * References:
+ *         https://www.kernel.org/doc/html/latest/RCU/whatisRCU.html
+ */
+#pragma once
+#include <Scheduler/tasks.hpp>
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * @brief Publish a pointer. Everything written to the pointed-to object
+ * beforehand is visible to readers that load the pointer with `rcu_dereference()`.
+ *
+ */
+#define rcu_assign_pointer(p, v) __atomic_store_n(&(p), (v), __ATOMIC_RELEASE)
+
+/**
+ * @brief Load an RCU protected pointer exactly once. Only a compiler
+ * barrier on x86.
+ *
+ */
+#define rcu_dereference(p) __atomic_load_n(&(p), __ATOMIC_CONSUME)
+
+/**
+ * @brief Begin a read-side critical section. Only needed by tasks; interrupt
+ * handlers and anything else running with interrupts disabled can't be
+ * preempted and are already read-side sections. Readers must not block.
+ *
+ */
+static inline void rcu_read_lock(void)
+{
+    preempt_disable();
+}
+
+/**
+ * @brief End a read-side critical section.
+ *
+ */
+static inline void rcu_read_unlock(void)
+{
+    preempt_enable();
+}
+
+/**
+ * @brief Wait until every read-side critical section that was running when
+ * this was called has finished. May only be called from task context and
+ * never from inside a read-side critical section.
+ *
+ */
+void synchronize_rcu(void);
+
+struct rcu_head
+{
+    struct rcu_head *next;
+    void (*func)(struct rcu_head *head);
+};
+
+/**
+ * @brief Invoke `func` after a grace period without waiting for it. Usually
+ * embedded in the object being retired so that `func` can free it. Callbacks
+ * run from the scheduler's cleaner task and may block. Safe to call from
+ * interrupt handlers.
+ *
+ * @param head Callback to queue
+ * @param func Function to call with `head`
+ */
+void call_rcu(struct rcu_head *head, void (*func)(struct rcu_head *head));
+
+/**
+ * @brief Report a quiescent state for the calling CPU and advance grace
+ * periods. Called by the scheduler with interrupts disabled.
+ *
+ * @return true Callbacks are ready to run, see `rcu_invoke_callbacks()`
+ */
+bool rcu_note_quiescent_state(void);
+
+/**
+ * @brief Run all callbacks whose grace period has elapsed.
+ *
+ * @return size_t Number of callbacks run
+ */
+size_t rcu_invoke_callbacks(void);
+
+/**
+ * @brief Singly linked list that readers may walk while a writer inserts or
+ * removes entries. Writers must be serialized against each other by the
+ * caller and a removed node may only be reused or freed after a grace period.
+ *
+ */
+struct rcu_list_node
+{
+    struct rcu_list_node *next;
+};
+
+struct rcu_list
+{
+    struct rcu_list_node *head;
+};
+
+static inline void rcu_list_add(struct rcu_list *list, struct rcu_list_node *node)
+{
+    node->next = list->head;
+    rcu_assign_pointer(list->head, node);
+}
+
+static inline void rcu_list_add_tail(struct rcu_list *list, struct rcu_list_node *node)
+{
+    struct rcu_list_node **link = &list->head;
+    while (*link != NULL) {
+        link = &(*link)->next;
+    }
+
+    node->next = NULL;
+    rcu_assign_pointer(*link, node);
+}
+
+static inline bool rcu_list_remove(struct rcu_list *list, struct rcu_list_node *node)
+{
+    for (struct rcu_list_node **link = &list->head; *link != NULL; link = &(*link)->next) {
+        if (*link == node) {
+            // leave node->next alone so that readers standing on the node can move on
+            rcu_assign_pointer(*link, node->next);
+            return true;
+        }
+    }
+
+    return false;
+}
+
+#define rcu_list_entry(ptr, type, member) \
+    ((type *)((uintptr_t)(ptr) - offsetof(type, member)))
+
+#define rcu_list_for_each(pos, list) \
+    for ((pos) = rcu_dereference((list)->head); (pos) != NULL; (pos) = rcu_dereference((pos)->next))
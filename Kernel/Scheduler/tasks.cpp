@@ -11,14 +11,19 @@
 #include <Arch/Arch.hpp>
 #include <Arch/Memory.hpp>
 #include <Scheduler/tasks.hpp>
+#include <Scheduler/cpuidle.hpp>
+#include <Scheduler/rcu.hpp>
 #include <Panic.hpp>
 #include <Memory/heap.hpp>
 #include <Library/stdio.hpp>
+#include <Library/string.hpp>
+#include <Devices/Clock/hpet.hpp>
 #include <Devices/Serial/rs232.hpp>
 #include <stdint.h>
 #include <x86gprintrin.h>   // needed for __rdtsc
 #include <Arch/i686/timer.hpp> // TODO: Remove ASAP
 #include <Logger.hpp>
+#include <Metrics.hpp>
 
 /* forward declarations */
 static void _enqueue_task(struct tasklist *, task *);
@@ -37,10 +42,16 @@ void _wakeup(struct task *task);
     static inline struct task *_dequeue_##name() { \
         return _dequeue_task(&tasks_##name); }
 
-struct task *current_task = NULL;
 static struct task _cleaner_task;
 static struct task _first_task;
 
+// every task that hasn't been cleaned up, only shared between tasks
+static struct task *_all_tasks = NULL;
+static uint32_t _next_task_id = 0;
+
+// stacks are filled with this so the deepest point they reached can be found
+#define STACK_PAINT 0x5354434BUL
+
 struct tasklist tasks_ready = { /* Zero */ };
 NAMED_TASKLIST(sleeping);
 NAMED_TASKLIST(stopped);
@@ -65,52 +76,201 @@ static const char *_state_names[TASK_STATE_COUNT] = {
     [TASK_PAUSED] = "PAUSED",
 };
 
-static uint64_t _idle_time = 0;
-static uint64_t _idle_start = 0;
-static uint64_t _last_time = 0;
-static uint64_t _time_slice_remaining = 0;
-static uint64_t _last_timer_time = 0;
-static size_t _scheduler_lock = 0;
-static size_t _scheduler_postpone_count = 0;
-static bool _scheduler_postponed = false;
-static uint64_t _instr_per_ns;
+// scheduler state (current task, time slice, lock depth, ...) is per-CPU, see percpu.hpp
+static uint64_t _tsc_khz;
+
+#define TIMER_PERIOD_NS 1000000    // The PIT is programmed for 1 ms ticks
+#define TSC_CALIBRATION_NS 10000000 // Calibrate against 10 ms of the HPET counter
+
+// The scheduler lock disables interrupts and only protects what interrupt
+// handlers also touch (the ready and sleeping queues) and the context switch
+// itself. Anything only shared between tasks just disables preemption.
+static void _irq_off_end()
+{
+    uint64_t start = this_cpu_read(irq_off_start);
+    if (start == 0) {
+        return;
+    }
+
+    uint64_t cycles = __rdtsc() - start;
+    if (cycles > this_cpu_read(irq_off_max)) {
+        this_cpu_write(irq_off_max, cycles);
+    }
+    this_cpu_write(irq_off_start, 0);
+}
 
 static void _aquire_scheduler_lock()
 {
+    bool enabled = Arch::CPU::interruptsEnabled();
     asm volatile("cli");
-    _scheduler_postpone_count++;
-    _scheduler_lock++;
+    // only time sections that actually turned interrupts off
+    if (enabled && this_cpu_read(scheduler_lock) == 0) {
+        this_cpu_write(irq_off_start, __rdtsc());
+    }
+    this_cpu_inc(scheduler_lock);
 }
 
 static void _release_scheduler_lock()
 {
-    _scheduler_postpone_count--;
-    if (_scheduler_postpone_count == 0) {
-        if (_scheduler_postponed) {
-            _scheduler_postponed = false;
-            _schedule();
-        }
-    }
-    _scheduler_lock--;
-    if (_scheduler_lock == 0) {
+    this_cpu_dec(scheduler_lock);
+    if (this_cpu_read(scheduler_lock) == 0) {
+        _irq_off_end();
         asm volatile("sti");
     }
 }
 
+void preempt_disable()
+{
+    if (this_cpu_read(preempt_count) == 0) {
+        this_cpu_write(preempt_off_start, __rdtsc());
+    }
+    this_cpu_inc(preempt_count);
+}
+
+void preempt_enable()
+{
+    this_cpu_dec(preempt_count);
+    if (this_cpu_read(preempt_count) != 0) {
+        return;
+    }
+
+    uint64_t cycles = __rdtsc() - this_cpu_read(preempt_off_start);
+    if (cycles > this_cpu_read(preempt_off_max)) {
+        this_cpu_write(preempt_off_max, cycles);
+    }
+    // run any reschedule that was deferred while preemption was disabled
+    if (this_cpu_read(need_resched)) {
+        tasks_schedule();
+    }
+}
+
+static inline uint64_t _cycles_to_ns(uint64_t cycles)
+{
+    return cycles * 1000000 / _tsc_khz;
+}
+
+uint64_t tasks_get_irq_off_max_ns()
+{
+    return _cycles_to_ns(this_cpu_read(irq_off_max));
+}
+
+uint64_t tasks_get_preempt_off_max_ns()
+{
+    return _cycles_to_ns(this_cpu_read(preempt_off_max));
+}
+
+uint64_t tasks_cycles_to_ns(uint64_t cycles)
+{
+    return _cycles_to_ns(cycles);
+}
+
+// the scheduler keeps these in the per-CPU data, so the metrics just sum them up
+static uint64_t _sample_context_switches()
+{
+    uint64_t total = 0;
+    for (uint32_t i = 0; i < PERCPU_MAX_CPUS; i++) {
+        const struct percpu *cpu = PerCPU::block(i);
+        if (cpu->self != NULL) total += cpu->context_switches;
+    }
+    return total;
+}
+
+static uint64_t _sample_idle_time()
+{
+    uint64_t total = 0;
+    for (uint32_t i = 0; i < PERCPU_MAX_CPUS; i++) {
+        const struct percpu *cpu = PerCPU::block(i);
+        if (cpu->self != NULL) total += cpu->idle_time;
+    }
+    return total;
+}
+
+// the longest sections only ever grow, so they are exported as counters
+static uint64_t _sample_irq_off_max()
+{
+    uint64_t longest = 0;
+    for (uint32_t i = 0; i < PERCPU_MAX_CPUS; i++) {
+        const struct percpu *cpu = PerCPU::block(i);
+        if (cpu->self != NULL && cpu->irq_off_max > longest) longest = cpu->irq_off_max;
+    }
+    return _tsc_khz ? _cycles_to_ns(longest) : 0;
+}
+
+static uint64_t _sample_preempt_off_max()
+{
+    uint64_t longest = 0;
+    for (uint32_t i = 0; i < PERCPU_MAX_CPUS; i++) {
+        const struct percpu *cpu = PerCPU::block(i);
+        if (cpu->self != NULL && cpu->preempt_off_max > longest) longest = cpu->preempt_off_max;
+    }
+    return _tsc_khz ? _cycles_to_ns(longest) : 0;
+}
+
+METRIC_COUNTER_SAMPLED(_metric_context_switches, "sched.context_switches", "switches", _sample_context_switches);
+METRIC_COUNTER_SAMPLED(_metric_idle_time, "sched.idle_time", "ns", _sample_idle_time);
+METRIC_COUNTER_SAMPLED(_metric_irq_off_max, "sched.irq_off_max", "ns", _sample_irq_off_max);
+METRIC_COUNTER_SAMPLED(_metric_preempt_off_max, "sched.preempt_off_max", "ns", _sample_preempt_off_max);
+METRIC_COUNTER(_metric_tasks_created, "sched.tasks_created", "tasks");
+
+// idle state statistics by index, cpuidle_init() logs which state each one is
+static uint64_t _sample_cpuidle_entries(size_t index)
+{
+    const struct cpuidle_state *state = cpuidle_get_state(index);
+    return state ? state->entries : 0;
+}
+
+static uint64_t _sample_cpuidle_residency(size_t index)
+{
+    const struct cpuidle_state *state = cpuidle_get_state(index);
+    return state ? state->residency_ns : 0;
+}
+
+#define CPUIDLE_STATE_METRICS(index) \
+    static uint64_t _sample_cpuidle##index##_entries() { return _sample_cpuidle_entries(index); } \
+    static uint64_t _sample_cpuidle##index##_residency() { return _sample_cpuidle_residency(index); } \
+    METRIC_COUNTER_SAMPLED(_metric_cpuidle##index##_entries, "sched.cpuidle." #index ".entries", "entries", \
+        _sample_cpuidle##index##_entries); \
+    METRIC_COUNTER_SAMPLED(_metric_cpuidle##index##_residency, "sched.cpuidle." #index ".residency", "ns", \
+        _sample_cpuidle##index##_residency)
+
+static_assert(CPUIDLE_MAX_STATES == 4, "Export metrics for every idle state");
+CPUIDLE_STATE_METRICS(0);
+CPUIDLE_STATE_METRICS(1);
+CPUIDLE_STATE_METRICS(2);
+CPUIDLE_STATE_METRICS(3);
+
 static void _discover_cpu_speed()
 {
-    uint32_t curr_tick = timer_tick;
-    uint64_t curr_rtsc = __rdtsc();
-    while (timer_tick != curr_tick + 1) { }
-    curr_rtsc = __rdtsc() - curr_rtsc;
-    _instr_per_ns = curr_rtsc / 1000000;
+    if (HPET::isPresent()) {
+        // count TSC cycles across a fixed span of the HPET main counter
+        uint64_t start_ns = HPET::nanoseconds();
+        uint64_t start_tsc = __rdtsc();
+        uint64_t elapsed_ns;
+        while ((elapsed_ns = HPET::nanoseconds() - start_ns) < TSC_CALIBRATION_NS) { }
+        _tsc_khz = (__rdtsc() - start_tsc) * 1000000 / elapsed_ns;
+    } else {
+        // line up with the start of a tick, then count the cycles in one (1 ms) tick
+        uint32_t curr_tick = timer_tick;
+        while (timer_tick == curr_tick) { }
+        curr_tick = timer_tick;
+        uint64_t curr_rtsc = __rdtsc();
+        while (timer_tick == curr_tick) { }
+        _tsc_khz = __rdtsc() - curr_rtsc;
+    }
     // will be inaccurate, but it's the best we can do in these circumstances
-    if (_instr_per_ns == 0) _instr_per_ns = 1;
+    if (_tsc_khz == 0) _tsc_khz = 1;
+
+    Logger::Info(__func__, "TSC %llu kHz (calibrated against the %s)", _tsc_khz, HPET::isPresent() ? "HPET" : "PIT");
+    if (HPET::isPresent()) {
+        Logger::Info(__func__, "HPET %llu Hz, %lu fs resolution, %llu ns per read",
+            HPET::frequency(), HPET::period(), HPET::readCost() * 1000000 / _tsc_khz);
+    }
 }
 
 static inline uint64_t _get_cpu_time_ns()
 {
-    return (__rdtsc()) / _instr_per_ns;
+    uint64_t tsc = __rdtsc();
+    return (tsc / _tsc_khz) * 1000000 + (tsc % _tsc_khz) * 1000000 / _tsc_khz;
 }
 
 static void _print_task(const char* tag, const struct task *task)
@@ -154,6 +314,8 @@ void tasks_init()
     struct task *this_task = &_first_task;
     // discover the CPU speed for accurate scheduling
     _discover_cpu_speed();
+    // pick idle states now that the clock is usable
+    cpuidle_init(_get_cpu_time_ns);
     *this_task = {
         // this will be filled in when we switch to another task for the first time
         .stack_top = 0,
@@ -171,18 +333,35 @@ void tasks_init()
         .name = "[main]",
         // this is not backed by dynamic memory
         .alloc = ALLOC_STATIC,
+        // the boot stack is never used for user mode
+        .kernel_stack = 0,
+        // kernel task
+        .process = NULL,
+        .cleanup = NULL,
+        .id = _next_task_id++,
+        .irq_start = 0,
+        .irq_cycles = 0,
+        .context_switches = 0,
+        .heap_bytes = 0,
+        // the boot stack isn't ours to count
+        .pages = 0,
+        .page_faults = 0,
+        .all_next = NULL,
     };
+    _all_tasks = this_task;
     TASK_ACTION(__func__, this_task);
     // create a task for the cleaner and set it's state to "paused"
     (void) tasks_new(_cleaner_task_impl, &_cleaner_task, TASK_PAUSED, "[cleaner]");
     _cleaner_task.state = TASK_PAUSED;
     // update the timer variables
-    _last_time = _get_cpu_time_ns();
-    _last_timer_time = _last_time;
+    uint64_t now = _get_cpu_time_ns();
+    this_cpu_write(last_time, now);
+    this_cpu_write(last_timer_time, now);
+    this_cpu_write(last_tick_time, now);
     // enable time slices
-    _time_slice_remaining = TIME_SLICE_SIZE;
+    this_cpu_write(time_slice_remaining, TIME_SLICE_SIZE);
     // this is the current task
-    current_task = this_task;
+    this_cpu_write(current_task, this_task);
     timer_register_callback(_on_timer);
 }
 
@@ -193,10 +372,7 @@ static void _task_starting()
 
     // the task before this caused the scheduler to lock
     // so we must unlock here
-    _scheduler_lock--;
-    if (_scheduler_lock == 0) {
-        asm volatile("sti");
-    }
+    _release_scheduler_lock();
 }
 
 static void _task_stopping()
@@ -281,6 +457,38 @@ extern "C" void _tasks_enqueue_ready(struct task *task)
     _enqueue_task(&tasks_ready, task);
 }
 
+static void _tasks_enqueue_ready_chain(struct task *first, struct task *last)
+{
+    // append an already linked chain of tasks in one go
+    if (tasks_ready.tail != NULL) {
+        tasks_ready.tail->next = first;
+    } else {
+        tasks_ready.head = first;
+    }
+    last->next = NULL;
+    tasks_ready.tail = last;
+}
+
+static void _enqueue_sleeping_sorted(struct task *task)
+{
+    // keep the list ordered by wakeup time so the timer only needs to look at its head
+    struct task *previous = NULL;
+    struct task *next = tasks_sleeping.head;
+    while (next != NULL && next->wakeup_time <= task->wakeup_time) {
+        previous = next;
+        next = next->next;
+    }
+    task->next = next;
+    if (previous != NULL) {
+        previous->next = task;
+    } else {
+        tasks_sleeping.head = task;
+    }
+    if (next == NULL) {
+        tasks_sleeping.tail = task;
+    }
+}
+
 static struct task *_tasks_dequeue_ready()
 {
     return _dequeue_task(&tasks_ready);
@@ -303,6 +511,10 @@ struct task *tasks_new(void (*entry)(void), struct task *storage, task_state sta
     if (stack == NULL) {
         panic("Unable to allocate memory for new task stack.");
     }
+    // paint the stack to find its high water mark later
+    for (uint32_t *word = (uint32_t *)stack; word < (uint32_t *)(stack + ARCH_PAGE_SIZE); word++) {
+        *word = STACK_PAINT;
+    }
     // remember, the stack grows up
     void *stack_pointer = stack + ARCH_PAGE_SIZE;
     // a null stack frame to make the panic screen happy
@@ -326,6 +538,21 @@ struct task *tasks_new(void (*entry)(void), struct task *storage, task_state sta
     new_task->time_used = 0;
     new_task->name = name;
     new_task->alloc = storage == NULL ? ALLOC_DYNAMIC : ALLOC_STATIC;
+    new_task->kernel_stack = (uintptr_t)(stack + ARCH_PAGE_SIZE);
+    new_task->process = NULL;
+    new_task->cleanup = NULL;
+    new_task->irq_start = 0;
+    new_task->irq_cycles = 0;
+    new_task->context_switches = 0;
+    new_task->heap_bytes = 0;
+    new_task->pages = 1;
+    new_task->page_faults = 0;
+    preempt_disable();
+    new_task->id = _next_task_id++;
+    new_task->all_next = _all_tasks;
+    _all_tasks = new_task;
+    preempt_enable();
+    Metrics::inc(_metric_tasks_created);
     if (state == TASK_READY) {
         _tasks_enqueue_ready(new_task);
     }
@@ -336,23 +563,92 @@ struct task *tasks_new(void (*entry)(void), struct task *storage, task_state sta
 void tasks_update_time()
 {
     uint64_t current_time = _get_cpu_time_ns();
-    uint64_t delta = current_time - _last_time;
-    if (current_task == NULL) {
-        _idle_time += delta;
+    uint64_t delta = current_time - this_cpu_read(last_time);
+    struct task *task = this_cpu_read(current_task);
+    if (task == NULL) {
+        this_cpu_add(idle_time, delta);
+    } else {
+        task->time_used += delta;
+    }
+    this_cpu_write(last_time, current_time);
+}
+
+static uint64_t _predict_idle_ns()
+{
+    // nothing can become ready before the next timer tick or the earliest sleeper's deadline
+    uint64_t deadline = this_cpu_read(last_tick_time) + TIMER_PERIOD_NS;
+    struct task *sleeper = tasks_sleeping.head;
+    if (sleeper != NULL && sleeper->wakeup_time < deadline) {
+        deadline = sleeper->wakeup_time;
+    }
+
+    uint64_t now = _get_cpu_time_ns();
+    return deadline > now ? deadline - now : 0;
+}
+
+struct task *tasks_irq_enter()
+{
+    struct task *task = this_cpu_read(current_task);
+    // handlers don't nest, but be safe and only time the outermost one
+    if (task == NULL || task->irq_start != 0) {
+        return NULL;
+    }
+    task->irq_start = __rdtsc();
+    return task;
+}
+
+void tasks_irq_exit(struct task *task)
+{
+    if (task == NULL) {
+        return;
+    }
+    task->irq_cycles += __rdtsc() - task->irq_start;
+    task->irq_start = 0;
+}
+
+// a handler may switch tasks (e.g. the timer), so its task stops being
+// charged while it is switched out and picks up again once it's back
+static inline void _irq_time_pause(struct task *task)
+{
+    if (task->irq_start != 0) {
+        task->irq_cycles += __rdtsc() - task->irq_start;
+    }
+}
+
+static inline void _irq_time_resume(struct task *task)
+{
+    if (task->irq_start != 0) {
+        task->irq_start = __rdtsc();
+    }
+}
+
+static void _rcu_quiescent_state(struct task *running)
+{
+    if (!rcu_note_quiescent_state() || _cleaner_task.state != TASK_PAUSED) {
+        return;
+    }
+    // the cleaner runs the RCU callbacks that are now ready
+    if (running == &_cleaner_task) {
+        // it's on its way to pausing, so cancel that instead
+        running->state = TASK_RUNNING;
     } else {
-        current_task->time_used += delta;
+        _cleaner_task.state = TASK_READY;
+        _tasks_enqueue_ready(&_cleaner_task);
     }
-    _last_time = current_time;
 }
 
 static void _schedule()
 {
-    if (_scheduler_postpone_count != 0) {
-        // don't schedule if there's more work to be done
-        _scheduler_postponed = true;
+    if (this_cpu_read(preempt_count) != 0) {
+        // don't schedule while preemption is disabled, preempt_enable() will
+        this_cpu_write(need_resched, true);
         return;
     }
-    if (current_task == NULL) {
+    this_cpu_write(need_resched, false);
+    struct task *running = this_cpu_read(current_task);
+    // read-side sections disable preemption, so none can be running here
+    _rcu_quiescent_state(running);
+    if (running == NULL) {
         // we are currently idling and will schedule at a later time
         return;
     }
@@ -360,47 +656,73 @@ static void _schedule()
     struct task *task = _tasks_dequeue_ready();
     // don't need to do anything if there's nothing ready to run
     if (task == NULL) {
-        if (current_task->state == TASK_RUNNING) {
+        if (running->state == TASK_RUNNING) {
             // still running the same task
             // but also reset the time slice counter
-            _time_slice_remaining = TIME_SLICE_SIZE;
+            this_cpu_write(time_slice_remaining, TIME_SLICE_SIZE);
             return;
         }
         // disable time slices because there are no tasks available to run
-        _time_slice_remaining = 0;
+        this_cpu_write(time_slice_remaining, 0);
         // count the time that this task ran for
         tasks_update_time();
+        _irq_time_pause(running);
         /*** idle ***/
         // borrow this task to return to once we're not idle anymore
-        struct task *borrowed = current_task;
+        struct task *borrowed = running;
         // set the current task to null to indicate an idle state
-        current_task = NULL;
-        _idle_start = _get_cpu_time_ns();
+        this_cpu_write(current_task, NULL);
+        // idling with interrupts enabled doesn't count as an interrupts-off section
+        bool measuring = this_cpu_read(irq_off_start) != 0;
+        _irq_off_end();
         do {
-            // enable interrupts to process timer and other events
-            asm ("sti");
-            // immediately halt the CPU
-            asm ("hlt");
-            // disable interrupts to restore our lock
-            asm ("cli");
+            // idle until an interrupt (or a write to the ready queue) wakes us
+            cpuidle_enter(_predict_idle_ns(), &tasks_ready.head);
+            // whatever woke us has finished, so this is a quiescent state too
+            _rcu_quiescent_state(NULL);
             // check if there's a task ready to be run
         } while (task = _tasks_dequeue_ready(), task == NULL);
+        if (measuring) {
+            this_cpu_write(irq_off_start, __rdtsc());
+        }
         // count the time we spent idling
         tasks_update_time();
         // reset the current task
-        current_task = borrowed;
-        _idle_start = _idle_start - _get_cpu_time_ns();
-        _idle_time += _idle_start;
+        this_cpu_write(current_task, borrowed);
     } else {
         // just do time accounting once
         tasks_update_time();
+        _irq_time_pause(running);
     }
     // reset the time slice because a new task is being scheduled
-    _time_slice_remaining = TIME_SLICE_SIZE;
+    this_cpu_write(time_slice_remaining, TIME_SLICE_SIZE);
     // reset the last "timer time" since the time slice was reset
-    _last_timer_time = _get_cpu_time_ns();
+    this_cpu_write(last_timer_time, _get_cpu_time_ns());
+    this_cpu_inc(context_switches);
+    task->context_switches++;
+    // interrupts from user mode must land on the new task's kernel stack
+    Arch::CPU::setKernelStack(task->kernel_stack);
     // switch to the task
     tasks_switch_to(task);
+    // this runs once the task that called us is switched back to
+    _irq_time_resume(running);
+}
+
+// Used by calls that put the current task on a wait or sleep list. Those
+// can't defer the switch while preemption is disabled, since the task would
+// keep running while an interrupt handler could already wake it. The
+// caller's preemption count belongs to it, so it is set aside across the
+// switch and restored once the task runs again.
+static void _schedule_blocked()
+{
+    size_t count = this_cpu_read(preempt_count);
+    this_cpu_write(preempt_count, 0);
+    _schedule();
+    this_cpu_write(preempt_count, count);
+    if (count != 0) {
+        // time spent blocked doesn't count towards the preemption-off section
+        this_cpu_write(preempt_off_start, __rdtsc());
+    }
 }
 
 void tasks_schedule()
@@ -416,15 +738,16 @@ void tasks_schedule()
 uint64_t tasks_get_self_time()
 {
     tasks_update_time();
-    return current_task->time_used;
+    return this_cpu_read(current_task)->time_used;
 }
 
 void tasks_block_current(task_state reason)
 {
     _aquire_scheduler_lock();
-    current_task->state = reason;
-    TASK_ACTION(__func__, current_task);
-    _schedule();
+    struct task *task = this_cpu_read(current_task);
+    task->state = reason;
+    TASK_ACTION(__func__, task);
+    _schedule_blocked();
     _release_scheduler_lock();
 }
 
@@ -449,38 +772,32 @@ static void _on_timer()
 {
     _aquire_scheduler_lock();
 
-    struct task *pre = NULL;
-    struct task *task = tasks_sleeping.head;
-    struct task *next;
+    struct task *task;
     bool need_schedule = false;
     uint64_t time = _get_cpu_time_ns();
     uint64_t time_delta;
+    this_cpu_write(last_tick_time, time);
 
-    while (task != NULL) {
-        next = task->next;
-        if (time >= task->wakeup_time) {
-            Logger::Verbose(__func__, "timer: waking sleeping task");
-            _remove_task(&tasks_sleeping, task, pre);
-            _wakeup(task);
-            task->next = NULL;
-            need_schedule = true;
-        } else {
-            pre = task;
-        }
-        task = next;
+    // the sleeping list is sorted, so stop at the first task that isn't due
+    while ((task = tasks_sleeping.head) != NULL && time >= task->wakeup_time) {
+        Logger::Verbose(__func__, "timer: waking sleeping task");
+        _dequeue_sleeping();
+        _wakeup(task);
+        need_schedule = true;
     }
 
-    if (_time_slice_remaining != 0) {
-        time_delta = time - _last_timer_time;
-        _last_timer_time = time;
-        if (time_delta >= _time_slice_remaining) {
+    uint64_t time_slice_remaining = this_cpu_read(time_slice_remaining);
+    if (time_slice_remaining != 0) {
+        time_delta = time - this_cpu_read(last_timer_time);
+        this_cpu_write(last_timer_time, time);
+        if (time_delta >= time_slice_remaining) {
             // schedule (and maybe pre-empt)
             // the schedule function will reset the time slice
             Logger::Trace(__func__, "timer: time slice expired");
             need_schedule = true;
         } else {
             // decrement the time slice counter
-            _time_slice_remaining -= time_delta;
+            this_cpu_write(time_slice_remaining, time_slice_remaining - time_delta);
         }
     }
 
@@ -495,11 +812,12 @@ void tasks_nano_sleep_until(uint64_t time)
 {
     // TODO: maybe validate that this time is in the future?
     _aquire_scheduler_lock();
-    current_task->state = TASK_SLEEPING;
-    current_task->wakeup_time = time;
-    _enqueue_sleeping(current_task);
-    TASK_ACTION(__func__, current_task);
-    _schedule();
+    struct task *task = this_cpu_read(current_task);
+    task->state = TASK_SLEEPING;
+    task->wakeup_time = time;
+    _enqueue_sleeping_sorted(task);
+    TASK_ACTION(__func__, task);
+    _schedule_blocked();
     _release_scheduler_lock();
 }
 
@@ -508,95 +826,247 @@ void tasks_nano_sleep(uint64_t time)
     tasks_nano_sleep_until(_get_cpu_time_ns() + time);
 }
 
+uint64_t tasks_get_time_ns()
+{
+    return _get_cpu_time_ns();
+}
+
+static void _remove_sleeping(struct task *task)
+{
+    struct task *previous = NULL;
+    for (struct task *next = tasks_sleeping.head; next != NULL; previous = next, next = next->next) {
+        if (next == task) {
+            _remove_task(&tasks_sleeping, task, previous);
+            return;
+        }
+    }
+}
+
+bool tasks_wait_block(struct task_wait *wait, uint64_t deadline)
+{
+    // signals can come from interrupt handlers, so check and block with them disabled
+    _aquire_scheduler_lock();
+    if (!wait->signaled) {
+        struct task *task = this_cpu_read(current_task);
+        wait->blocked = true;
+        if (deadline != 0) {
+            task->state = TASK_SLEEPING;
+            task->wakeup_time = deadline;
+            _enqueue_sleeping_sorted(task);
+        } else {
+            task->state = TASK_BLOCKED;
+        }
+        TASK_ACTION(__func__, task);
+        _schedule_blocked();
+        wait->blocked = false;
+    }
+    bool signaled = wait->signaled;
+    _release_scheduler_lock();
+    return signaled;
+}
+
+void tasks_wait_signal(struct task_wait *wait)
+{
+    _aquire_scheduler_lock();
+    wait->signaled = true;
+    struct task *task = wait->task;
+    // the timer may have already woken it up
+    if (wait->blocked && (task->state == TASK_SLEEPING || task->state == TASK_BLOCKED)) {
+        if (task->state == TASK_SLEEPING) {
+            _remove_sleeping(task);
+        }
+        _wakeup(task);
+    }
+    _release_scheduler_lock();
+}
+
 void tasks_exit()
 {
     // userspace cleanup can happen here
-    Logger::Debug(__func__, "task \"%s\" (0x%08lx) exiting", current_task->name, (uint32_t)current_task);
+    struct task *task = this_cpu_read(current_task);
+    Logger::Debug(__func__, "task \"%s\" (0x%08lx) exiting", task->name, (uint32_t)task);
 
-    _aquire_scheduler_lock();
-    // all scheduling-specific operations must happen here
-    _enqueue_stopped(current_task);
+    // the stopped list is only shared between tasks, so no interrupts need to be disabled
+    preempt_disable();
+    _enqueue_stopped(task);
 
-    // the ordering of these two should really be reversed
-    // but the scheduler currently isn't very smart
+    // the cleaner can't run until this task has switched away for good. If
+    // it's already awake it checks the stopped list again before pausing.
+    _aquire_scheduler_lock();
+    if (_cleaner_task.state == TASK_PAUSED) {
+        _cleaner_task.state = TASK_READY;
+        TASK_ACTION(__func__, &_cleaner_task);
+        _tasks_enqueue_ready(&_cleaner_task);
+    }
+    _release_scheduler_lock();
     tasks_block_current(TASK_STOPPED);
 
-    tasks_unblock(&_cleaner_task);
+    preempt_enable();
+}
+
+void tasks_account_heap_to(uint32_t id, int64_t bytes)
+{
+    struct task *current = this_cpu_read(current_task);
+    if (current != NULL && current->id == id) {
+        current->heap_bytes += bytes;
+        return;
+    }
+    if (id == TASK_ID_NONE) {
+        return;
+    }
+
+    // the task list is only shared between tasks
+    preempt_disable();
+    for (struct task *task = _all_tasks; task != NULL; task = task->all_next) {
+        if (task->id == id) {
+            task->heap_bytes += bytes;
+            break;
+        }
+    }
+    preempt_enable();
+}
 
+static void _unlink_task(struct task *task)
+{
+    preempt_disable();
+    for (struct task **link = &_all_tasks; *link != NULL; link = &(*link)->all_next) {
+        if (*link == task) {
+            *link = task->all_next;
+            break;
+        }
+    }
+    preempt_enable();
+}
+
+static size_t _stack_used(const struct task *task)
+{
+    if (task->kernel_stack == 0) {
+        return 0;
+    }
+    // the stack grows down, so the first word that was written is the deepest
+    const uint32_t *word = (const uint32_t *)(task->kernel_stack - ARCH_PAGE_SIZE);
+    const uint32_t *top = (const uint32_t *)task->kernel_stack;
+    while (word < top && *word == STACK_PAINT) {
+        word++;
+    }
+    return (uintptr_t)top - (uintptr_t)word;
+}
+
+size_t tasks_snapshot(struct task_stats *stats, size_t max)
+{
+    // make the running task's time current
+    _aquire_scheduler_lock();
+    tasks_update_time();
     _release_scheduler_lock();
+
+    size_t count = 0;
+    preempt_disable();
+    for (struct task *task = _all_tasks; task != NULL && count < max; task = task->all_next) {
+        struct task_stats *entry = &stats[count++];
+        uint64_t irq_ns = _cycles_to_ns(task->irq_cycles);
+        entry->id = task->id;
+        strncpy(entry->name, task->name ? task->name : "N/A", TASK_STATS_NAME_LEN - 1);
+        entry->state = task->state;
+        entry->run_ns = task->time_used > irq_ns ? task->time_used - irq_ns : 0;
+        entry->irq_ns = irq_ns;
+        entry->context_switches = task->context_switches;
+        entry->heap_bytes = task->heap_bytes;
+        entry->pages = task->pages;
+        entry->page_faults = task->page_faults;
+        entry->stack_used = _stack_used(task);
+    }
+    preempt_enable();
+    return count;
 }
 
 static void _clean_stopped_task(struct task *task)
 {
+    _unlink_task(task);
     // free the stack page
     uintptr_t page = Arch::Memory::pageAlign(task->stack_top);
     // TODO: Should more than one page be allocated / freed?
     Memory::freePage((void *)page, 1);
+    // let the owner release anything else tied to the task (it may free the task itself)
+    bool dynamic = task->alloc == ALLOC_DYNAMIC;
+    if (task->cleanup) {
+        task->cleanup(task);
+    }
     // somehow determine if the task was dynamically allocated or not
     // just assume statically allocated tasks will never exit (bad idea)
-    if (task->alloc == ALLOC_DYNAMIC) free(task);
+    if (dynamic) free(task);
 }
 
 static void _cleaner_task_impl()
 {
     for (;;) {
         struct task *task;
-        _aquire_scheduler_lock();
+        preempt_disable();
 
-        while (tasks_stopped.head != NULL) {
-            task = _dequeue_stopped();
+        while ((task = _dequeue_stopped()) != NULL) {
+            // freeing memory may block, so don't hold off preemption while doing it
+            preempt_enable();
             Logger::Debug(__func__, "cleaning up task %s (0x%08lx)", task->name ? task->name : "N/A", (uint32_t)task);
             _clean_stopped_task(task);
+            preempt_disable();
         }
 
-        // a schedule occuring at this point would be okay
-        // it just needs to occur before the loop repeats
-        tasks_block_current(TASK_PAUSED);
+        // callbacks may block as well
+        preempt_enable();
+        rcu_invoke_callbacks();
+        preempt_disable();
 
-        _release_scheduler_lock();
+        // tasks that stopped while preemption was enabled didn't wake us up,
+        // and none can stop between this check and blocking
+        if (tasks_stopped.head == NULL) {
+            tasks_block_current(TASK_PAUSED);
+        }
+
+        preempt_enable();
     }
 }
 
 void tasks_sync_block(struct task_sync *ts)
 {
-    _aquire_scheduler_lock();
+    // wait lists are only shared between tasks
+    preempt_disable();
 #ifdef DEBUG
     if (ts->dbg_name != NULL) {
         Logger::Debug(__func__, "blocking %s", ts->dbg_name);
     }
 #endif
     // push the current task to the waiting queue
-    _enqueue_task(&ts->waiting, current_task);
+    _enqueue_task(&ts->waiting, this_cpu_read(current_task));
     // now block until the mutex is freed
     tasks_block_current(TASK_BLOCKED);
-    _release_scheduler_lock();
+    preempt_enable();
 }
 
 void tasks_sync_unblock(struct task_sync *ts)
 {
-    _aquire_scheduler_lock();
+    preempt_disable();
 #ifdef DEBUG
     if (ts->dbg_name != NULL) {
         Logger::Debug(__func__, "unblocking %s", ts->dbg_name);
     }
 #endif
-    // iterate all tasks that were blocked and unblock them
-    struct task *task = ts->waiting.head;
-    struct task *next = NULL;
-    if (task == NULL) {
-        // no other tasks were blocked
-        goto exit;
-    }
-    do {
-        next = task->next;
-        _wakeup(task);
-        task->next = NULL;
-        task = next;
-    } while (task != NULL);
+    // take the whole wait list and mark every task ready
+    struct task *first = ts->waiting.head;
+    struct task *last = ts->waiting.tail;
     ts->waiting.head = NULL;
     ts->waiting.tail = NULL;
-    // we woke up some tasks
-    _schedule();
-exit:
-    _release_scheduler_lock();
+    if (first != NULL) {
+        for (struct task *task = first; task != NULL; task = task->next) {
+            task->state = TASK_READY;
+            task->wakeup_time = (0ULL - 1);
+            TASK_ACTION(__func__, task);
+        }
+        // the ready queue is shared with interrupt handlers, but splicing
+        // the chain onto it only keeps interrupts disabled for a moment
+        _aquire_scheduler_lock();
+        _tasks_enqueue_ready_chain(first, last);
+        _release_scheduler_lock();
+        // we woke up some tasks, let them run once preemption is back on
+        this_cpu_write(need_resched, true);
+    }
+    preempt_enable();
 }
@@ -29,6 +29,10 @@ enum task_state
 
 enum task_alloc { ALLOC_STATIC, ALLOC_DYNAMIC };
 
+namespace Userspace {
+class Process;
+}
+
 struct task
 {
     uintptr_t stack_top;
@@ -39,11 +43,39 @@ struct task
     uint64_t wakeup_time;
     const char *name;
     task_alloc alloc;
+    uintptr_t kernel_stack;             // Top of the kernel stack, used when user mode is interrupted
+    Userspace::Process *process;        // Owning user process (NULL for kernel tasks)
+    void (*cleanup)(struct task *task); // Called by the cleaner after the task has stopped
+    // resource accounting, see tasks_snapshot()
+    uint32_t id;                        // Unique for the lifetime of the kernel
+    uint64_t irq_start;                 // TSC when the interrupt being handled began, 0 if none
+    uint64_t irq_cycles;                // Spent in interrupt handlers while this task was running
+    uint64_t context_switches;          // Times this task was switched to
+    int64_t heap_bytes;                 // Allocated with new and not yet deleted (malloc isn't counted)
+    int64_t pages;                      // Stack, heap and user pages allocated for this task
+    uint64_t page_faults;
+    struct task *all_next;              // Every task that hasn't been cleaned up yet
 };
 
-extern struct task *current_task;
+#define TASK_STATS_NAME_LEN 16
 
-#define TASK_ONLY if (current_task != NULL)
+// A copy of a task's accounting, taken by tasks_snapshot()
+struct task_stats
+{
+    uint32_t id;
+    char name[TASK_STATS_NAME_LEN];
+    task_state state;
+    uint64_t run_ns;                    // Running, not counting interrupt handlers
+    uint64_t irq_ns;                    // In interrupt handlers while this task was running
+    uint64_t context_switches;
+    int64_t heap_bytes;
+    int64_t pages;
+    uint64_t page_faults;
+    size_t stack_used;                  // High water mark of the kernel stack (in bytes), 0 if unknown
+};
+
+// The running task is kept in the per-CPU data block
+#define TASK_ONLY if (this_cpu_read(current_task) != NULL)
 
 struct tasklist
 {
@@ -59,6 +91,71 @@ struct task_sync
     struct tasklist waiting;
 };
 
+// A single task waiting to be signaled, possibly from an interrupt handler
+struct task_wait
+{
+    struct task *task;
+    bool signaled;
+    bool blocked;
+};
+
+static inline void tasks_wait_init(struct task_wait *wait) {
+    *wait = {
+        .task = this_cpu_read(current_task),
+        .signaled = false,
+        .blocked = false,
+    };
+}
+
+#define TASK_ID_NONE UINT32_MAX
+
+/**
+ * @brief ID of the running task.
+ *
+ * @return uint32_t Task ID, or TASK_ID_NONE before the scheduler has started
+ */
+static inline uint32_t tasks_current_id(void) {
+    struct task *task = this_cpu_read(current_task);
+    return task != NULL ? task->id : TASK_ID_NONE;
+}
+
+/**
+ * @brief Charge heap bytes (or pages) to the running task. Negative values
+ * are frees. Heap frees are credited to the allocating task instead, see
+ * `tasks_account_heap_to()`. Page frees are charged to whoever frees.
+ *
+ */
+static inline void tasks_account_heap(int64_t bytes) {
+    struct task *task = this_cpu_read(current_task);
+    if (task != NULL) {
+        task->heap_bytes += bytes;
+    }
+}
+
+/**
+ * @brief Charge heap bytes to a task by ID, so that freeing memory on behalf
+ * of another task credits the task that allocated it. Nothing is charged if
+ * that task has already been cleaned up.
+ *
+ * @param id Task ID (TASK_ID_NONE is ignored)
+ * @param bytes Bytes allocated, negative for frees
+ */
+void tasks_account_heap_to(uint32_t id, int64_t bytes);
+
+static inline void tasks_account_pages(int64_t pages) {
+    struct task *task = this_cpu_read(current_task);
+    if (task != NULL) {
+        task->pages += pages;
+    }
+}
+
+static inline void tasks_account_page_fault(void) {
+    struct task *task = this_cpu_read(current_task);
+    if (task != NULL) {
+        task->page_faults++;
+    }
+}
+
 static inline void tasks_sync_init(struct task_sync *ts) {
     *ts = {
         .possessor = NULL,
@@ -103,7 +200,8 @@ void tasks_schedule();
  */
 uint64_t tasks_get_self_time();
 /**
- * @brief Blocks the current task.
+ * @brief Blocks the current task. The switch happens immediately even
+ * if preemption is disabled, and the task returns with it still disabled.
  *
  * @param reason
  */
@@ -126,12 +224,85 @@ void tasks_nano_sleep_until(uint64_t time);
  * @param time Nanoseconds to sleep
  */
 void tasks_nano_sleep(uint64_t time);
+/**
+ * @brief Returns the scheduler's clock (in nanoseconds since boot).
+ *
+ * @return uint64_t Current time (in nanoseconds)
+ */
+uint64_t tasks_get_time_ns(void);
+/**
+ * @brief Block the current task until the wait is signaled or the deadline
+ * passes. Returns immediately if it was already signaled. Must be called by
+ * the task that initialized the wait, with preemption enabled.
+ *
+ * @param wait Wait to block on
+ * @param deadline Absolute time to give up at (in nanoseconds), 0 for none
+ * @return true The wait was signaled
+ * @return false The deadline passed
+ */
+bool tasks_wait_block(struct task_wait *wait, uint64_t deadline);
+/**
+ * @brief Signal a wait, waking its task if it is blocked on it. Safe to
+ * call from interrupt handlers.
+ *
+ * @param wait Wait to signal
+ */
+void tasks_wait_signal(struct task_wait *wait);
 /**
  * @brief Exits the current task.
  *
  */
 void tasks_exit(void);
 
+/**
+ * @brief Disable preemption of the current task. Interrupts stay enabled, but
+ * any reschedule they request is deferred until `preempt_enable()`. Blocking
+ * or sleeping still switches away immediately. Calls nest.
+ *
+ */
+void preempt_disable(void);
+/**
+ * @brief Re-enable preemption and run any reschedule that was deferred.
+ *
+ */
+void preempt_enable(void);
+/**
+ * @brief Longest stretch the scheduler has kept interrupts disabled (in nanoseconds).
+ *
+ */
+uint64_t tasks_get_irq_off_max_ns(void);
+/**
+ * @brief Longest stretch preemption has been disabled (in nanoseconds).
+ *
+ */
+uint64_t tasks_get_preempt_off_max_ns(void);
+/**
+ * @brief Convert TSC cycles to nanoseconds.
+ *
+ */
+uint64_t tasks_cycles_to_ns(uint64_t cycles);
+/**
+ * @brief Start charging time to the running task's interrupt time. Called
+ * by the interrupt dispatcher before running a handler.
+ *
+ * @return struct task* Task to pass to `tasks_irq_exit()`
+ */
+struct task *tasks_irq_enter(void);
+/**
+ * @brief Stop charging time to the task's interrupt time.
+ *
+ * @param task Task returned by `tasks_irq_enter()`
+ */
+void tasks_irq_exit(struct task *task);
+/**
+ * @brief Copy the accounting of every task that hasn't been cleaned up.
+ *
+ * @param stats Array to copy into
+ * @param max Length of the array
+ * @return size_t Number of tasks copied
+ */
+size_t tasks_snapshot(struct task_stats *stats, size_t max);
+
 void tasks_sync_block(struct task_sync *tsc);
 
 void tasks_sync_unblock(struct task_sync *tsc);
@@ -0,0 +1,260 @@
+/**
+ * @file gcov.cpp
+ * @author Keeton Feavel (keeton@xyr.is)
+ * @brief Minimal gcov runtime for profile guided builds
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @copyright Copyright the Xyris Contributors (c) 2026
+ *
+ * References:
+ *     https://github.com/gcc-mirror/gcc/blob/master/libgcc/libgcov-driver.c
+ *     https://github.com/torvalds/linux/blob/master/kernel/gcov/gcc_4_7.c
+ *
+ */
+#if defined(GCOV)
+
+#include <Support/gcov.hpp>
+#include <Devices/Serial/dump.hpp>
+#include <Library/string.hpp>
+#include <Logger.hpp>
+#include <stddef.h>
+#include <stdint.h>
+
+// The structures GCC emits for each object are private to GCC and change
+// between versions. These match GCC 10 through 14.
+#if __GNUC__ >= 14
+#define GCOV_COUNTERS               9
+#elif __GNUC__ >= 10
+#define GCOV_COUNTERS               8
+#else
+#error "The gcov runtime needs GCC 10 or newer"
+#endif
+
+// GCC 12 and newer count record lengths in bytes instead of words
+#if __GNUC__ >= 12
+#define GCOV_UNIT_SIZE              4
+#else
+#define GCOV_UNIT_SIZE              1
+#endif
+
+#define GCOV_DATA_MAGIC             0x67636461  // "gcda"
+#define GCOV_TAG_FUNCTION           0x01000000
+#define GCOV_TAG_FUNCTION_LENGTH    (3 * GCOV_UNIT_SIZE)
+#define GCOV_TAG_COUNTER_BASE       0x01a10000
+#define GCOV_TAG_FOR_COUNTER(type)  (GCOV_TAG_COUNTER_BASE + ((uint32_t)(type) << 17))
+#define GCOV_TAG_OBJECT_SUMMARY     0xa1000000
+#define GCOV_TAG_SUMMARY_LENGTH     (2 * GCOV_UNIT_SIZE)
+#define GCOV_COUNTER_ARCS           0
+
+namespace Gcov {
+
+typedef int64_t gcov_type;
+typedef void (*gcov_merge_fn)(gcov_type* counters, uint32_t count);
+
+struct gcov_ctr_info {
+    uint32_t num;
+    gcov_type* values;
+};
+
+struct gcov_fn_info {
+    const struct gcov_info* key;        // Object the function is counted in
+    uint32_t ident;
+    uint32_t lineno_checksum;
+    uint32_t cfg_checksum;
+    struct gcov_ctr_info ctrs[1];       // One per counter type in use
+};
+
+struct gcov_info {
+    uint32_t version;
+    struct gcov_info* next;
+    uint32_t stamp;
+#if __GNUC__ >= 12
+    uint32_t checksum;
+#endif
+    const char* filename;               // Where libgcov would write the .gcda file
+    gcov_merge_fn merge[GCOV_COUNTERS]; // NULL for counter types not in use
+    uint32_t n_functions;
+    const struct gcov_fn_info* const* functions;
+};
+
+// Registered by the global constructors, before there is anything to lock
+static struct gcov_info* objects = NULL;
+
+// Writes to the dump, or only counts the bytes when there is none
+class Writer {
+public:
+    Writer(RS232::Dump* out)
+        : m_out(out)
+        , m_size(0)
+    {
+    }
+
+    void bytes(const void* data, size_t size)
+    {
+        if (m_out) {
+            m_out->write(data, size);
+        }
+        m_size += size;
+    }
+
+    void u32(uint32_t value)
+    {
+        bytes(&value, sizeof(value));
+    }
+
+    void u64(uint64_t value)
+    {
+        u32((uint32_t)value);
+        u32((uint32_t)(value >> 32));
+    }
+
+    size_t size() const { return m_size; }
+
+private:
+    RS232::Dump* m_out;
+    size_t m_size;
+};
+
+static uint32_t summaryMax(void)
+{
+    // largest arc count in the whole kernel, as libgcov computes it
+    gcov_type max = 0;
+    for (const struct gcov_info* info = objects; info; info = info->next) {
+        if (!info->merge[GCOV_COUNTER_ARCS]) {
+            continue;
+        }
+        for (uint32_t fn = 0; fn < info->n_functions; fn++) {
+            const struct gcov_fn_info* function = info->functions[fn];
+            if (function == NULL || function->key != info) {
+                continue;
+            }
+            for (uint32_t idx = 0; idx < function->ctrs[0].num; idx++) {
+                if (function->ctrs[0].values[idx] > max) {
+                    max = function->ctrs[0].values[idx];
+                }
+            }
+        }
+    }
+
+    return max > UINT32_MAX ? UINT32_MAX : (uint32_t)max;
+}
+
+static void writeObject(Writer& out, const struct gcov_info* info, uint32_t sumMax)
+{
+    out.u32(GCOV_DATA_MAGIC);
+    out.u32(info->version);
+    out.u32(info->stamp);
+#if __GNUC__ >= 12
+    out.u32(info->checksum);
+#endif
+    // the kernel is one run
+    out.u32(GCOV_TAG_OBJECT_SUMMARY);
+    out.u32(GCOV_TAG_SUMMARY_LENGTH);
+    out.u32(1);
+    out.u32(sumMax);
+
+    for (uint32_t fn = 0; fn < info->n_functions; fn++) {
+        const struct gcov_fn_info* function = info->functions[fn];
+        // functions counted in another object (e.g. inline ones) are left empty
+        if (function == NULL || function->key != info) {
+            out.u32(GCOV_TAG_FUNCTION);
+            out.u32(0);
+            continue;
+        }
+
+        out.u32(GCOV_TAG_FUNCTION);
+        out.u32(GCOV_TAG_FUNCTION_LENGTH);
+        out.u32(function->ident);
+        out.u32(function->lineno_checksum);
+        out.u32(function->cfg_checksum);
+
+        const struct gcov_ctr_info* counters = function->ctrs;
+        for (size_t type = 0; type < GCOV_COUNTERS; type++) {
+            if (!info->merge[type]) {
+                continue;
+            }
+            out.u32(GCOV_TAG_FOR_COUNTER(type));
+            out.u32(counters->num * 2 * GCOV_UNIT_SIZE);
+            for (uint32_t idx = 0; idx < counters->num; idx++) {
+                out.u64((uint64_t)counters->values[idx]);
+            }
+            counters++;
+        }
+    }
+
+    // a zero tag ends the file
+    out.u32(0);
+}
+
+void dump(void)
+{
+    if (objects == NULL) {
+        Logger::Warning(__func__, "No profile counters, only pgo=generate kernels collect them");
+        return;
+    }
+
+    uint32_t sumMax = summaryMax();
+    size_t files = 0;
+    size_t total = 0;
+    {
+        RS232::Dump out(true);
+        Writer writer(&out);
+        writer.bytes(GCOV_DUMP_MAGIC, 4);
+        writer.u32(GCOV_DUMP_VERSION);
+        for (const struct gcov_info* info = objects; info; info = info->next) {
+            // the size only depends on the number of counters, not their values
+            Writer counter(NULL);
+            writeObject(counter, info, sumMax);
+
+            uint32_t pathLength = (uint32_t)strlen(info->filename);
+            writer.u32(pathLength);
+            writer.bytes(info->filename, pathLength);
+            writer.u32((uint32_t)counter.size());
+            writeObject(writer, info, sumMax);
+
+            files++;
+            total += counter.size();
+        }
+        writer.u32(0);
+    }
+
+    // lets scripts know the frame is complete without decoding it
+    RS232::Dump(false).printf("gcov end %zu\n", files);
+    Logger::Info(__func__, "Wrote %zu profiles (%zu bytes)", files, total);
+}
+
+} // !namespace Gcov
+
+/**
+ * @brief Entry points the instrumented code calls into. Counters are only
+ * ever read by `Gcov::dump()`, so there is nothing to merge or flush.
+ *
+ */
+extern "C"
+{
+
+// Function prototypes (to make compiler happy)
+void __gcov_init(struct Gcov::gcov_info* info);
+void __gcov_exit(void);
+void __gcov_merge_add(Gcov::gcov_type* counters, uint32_t count);
+
+void __gcov_init(struct Gcov::gcov_info* info)
+{
+    info->next = Gcov::objects;
+    Gcov::objects = info;
+}
+
+void __gcov_exit(void)
+{
+}
+
+void __gcov_merge_add(Gcov::gcov_type* counters, uint32_t count)
+{
+    (void)counters;
+    (void)count;
+}
+
+}
+
+#endif
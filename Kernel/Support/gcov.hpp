@@ -0,0 +1,39 @@
+/**
+ * @file gcov.hpp
+ * @author Keeton Feavel (keeton@xyr.is)
+ * @brief Minimal gcov runtime for profile guided builds. Kernels compiled
+ * with `-fprofile-generate` (`scons pgo=generate`) register their counters
+ * here at boot instead of with libgcov, which needs a file system. Only built
+ * when GCOV is defined.
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @copyright Copyright the Xyris Contributors (c) 2026
+ *
+ */
+#pragma once
+
+#define GCOV_DUMP_VERSION   1
+
+/*
+ * A dump is sent as one LZ4 frame (see lz4.hpp) containing, little endian:
+ *   header:  "XGCD", version (4 bytes)
+ *   file:    path length (4 bytes), the .gcda path the compiler picked for
+ *            the object, data length (4 bytes), the .gcda file contents
+ *   end:     a path length of 0
+ * and is followed by a "gcov end" line once the frame has been sent.
+ */
+#define GCOV_DUMP_MAGIC     "XGCD"
+
+namespace Gcov {
+
+/**
+ * @brief Write the counters of every instrumented object to serial as .gcda
+ * files. `Meta/gcov-extract.py` writes them back out next to the objects so
+ * `scons pgo=use` can build with them. Counters keep running, so a later dump
+ * covers everything since boot.
+ *
+ */
+void dump(void);
+
+} // !namespace Gcov
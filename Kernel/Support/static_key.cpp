@@ -0,0 +1,42 @@
+/**
+ * @file static_key.cpp
+ * @author Keeton Feavel (keeton@xyr.is)
+ * @brief Static key updates
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @copyright Copyright the Xyris Contributors (c) 2026
+ *
+ */
+#include <Support/static_key.hpp>
+#include <Locking/Mutex.hpp>
+#include <Locking/RAII.hpp>
+
+/* Test sites, collected by the linker (see jump_label.hpp) */
+extern const struct Arch::JumpLabel::Entry _STATIC_KEYS_START[0];
+extern const struct Arch::JumpLabel::Entry _STATIC_KEYS_END[0];
+
+namespace StaticKey {
+
+// Keeps two updates of the same key from patching its sites out of order
+static Mutex updateLock("static-key");
+
+void set(Base& key, bool enabled)
+{
+    RAIIMutex lock(updateLock);
+    if (__atomic_load_n(&key.enabled, __ATOMIC_RELAXED) == enabled) {
+        return;
+    }
+
+    // slow readers see the new state before any site does
+    __atomic_store_n(&key.enabled, enabled, __ATOMIC_RELEASE);
+    for (const struct Arch::JumpLabel::Entry* entry = _STATIC_KEYS_START; entry < _STATIC_KEYS_END; entry++) {
+        if ((entry->key & ~(uintptr_t)1) != (uintptr_t)&key) {
+            continue;
+        }
+        bool jumpWhenEnabled = entry->key & 1;
+        Arch::JumpLabel::patch(entry, enabled == jumpWhenEnabled);
+    }
+}
+
+} // !namespace StaticKey
@@ -0,0 +1,117 @@
+/**
+ * @file static_key.hpp
+ * @author Keeton Feavel (keeton@xyr.is)
+ * @brief Static keys, runtime switches for code that is rarely turned on
+ * (tracing, extra statistics and the like). Testing a key is not a load and
+ * a branch but a single instruction at the test site, a NOP while the key
+ * is in its default state, that is patched into a JMP when it changes. Keys
+ * cost nothing while they are off, and changing them is slow.
+ *
+ *     STATIC_KEY_FALSE(tracing);
+ *
+ *     if (StaticKey::unlikely<tracing>()) {
+ *         trace(...);
+ *     }
+ *
+ *     StaticKey::enable(tracing);
+ *
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @copyright Copyright the Xyris Contributors (c) 2026
+ *
+ */
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#if defined(__i686__)
+#    include <Arch/i686/jump_label.hpp>
+#endif
+
+/**
+ * @brief Declare a key that starts out disabled (or enabled). Keys must
+ * have static storage duration, since every test site refers to its key's
+ * address.
+ *
+ */
+#define STATIC_KEY_FALSE(name) StaticKey::Key<false> name
+#define STATIC_KEY_TRUE(name) StaticKey::Key<true> name
+
+namespace StaticKey {
+
+struct Base {
+    constexpr Base(bool initial)
+        : enabled(initial)
+    {
+    }
+
+    uint32_t enabled;
+};
+
+/**
+ * @brief A key. The default state is part of the type so test sites can be
+ * built as the right instruction without patching them at boot.
+ *
+ */
+template<bool Initial>
+struct Key : Base {
+    static constexpr bool initial = Initial;
+
+    constexpr Key()
+        : Base(Initial)
+    {
+    }
+};
+
+/**
+ * @brief Test a key expected to be disabled. The enabled side is laid out
+ * out of line.
+ *
+ */
+template<auto& key>
+[[gnu::always_inline]] inline bool unlikely()
+{
+    return __builtin_expect(Arch::JumpLabel::site<&key, true, key.initial>(), 0);
+}
+
+/**
+ * @brief Test a key expected to be enabled. The disabled side is laid out
+ * out of line.
+ *
+ */
+template<auto& key>
+[[gnu::always_inline]] inline bool likely()
+{
+    return !__builtin_expect(Arch::JumpLabel::site<&key, false, !key.initial>(), 0);
+}
+
+/**
+ * @brief Change a key, patching every site that tests it. Sleeps, so only
+ * call this from a task (or before tasking starts).
+ *
+ * @param key Key to change
+ * @param enabled New state
+ */
+void set(Base& key, bool enabled);
+
+inline void enable(Base& key)
+{
+    set(key, true);
+}
+
+inline void disable(Base& key)
+{
+    set(key, false);
+}
+
+/**
+ * @brief Read a key the slow way, for code where a load is no concern.
+ *
+ */
+inline bool enabled(const Base& key)
+{
+    return __atomic_load_n(&key.enabled, __ATOMIC_RELAXED);
+}
+
+} // !namespace StaticKey
@@ -0,0 +1,47 @@
+/**
+ * @file ELF.cpp
+ * @author Keeton Feavel (keeton@xyr.is)
+ * @brief ELF32 executable validation
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @copyright Copyright the Xyris Contributors (c) 2026
+ *
+ */
+#include <Userspace/ELF.hpp>
+#include <Logger.hpp>
+
+namespace ELF {
+
+const struct Header* validate(const void* image, size_t size)
+{
+    auto header = (const struct Header*)image;
+    if (size < sizeof(struct Header) || header->magic != ELF_MAGIC) {
+        Logger::Warning(__func__, "Not an ELF image");
+        return NULL;
+    }
+    if (header->fileClass != ELF_CLASS_32 || header->data != ELF_DATA_LSB || header->machine != ELF_MACHINE_386) {
+        Logger::Warning(__func__, "ELF image is not for i686");
+        return NULL;
+    }
+    if (header->type != ELF_TYPE_EXEC) {
+        Logger::Warning(__func__, "ELF image is not a static executable");
+        return NULL;
+    }
+    // program headers must lie entirely within the image
+    if (header->phentsize != sizeof(struct ProgramHeader)
+        || header->phoff > size
+        || (size - header->phoff) / sizeof(struct ProgramHeader) < header->phnum) {
+        Logger::Warning(__func__, "ELF program headers are malformed");
+        return NULL;
+    }
+
+    return header;
+}
+
+const struct ProgramHeader* programHeader(const struct Header* header, size_t idx)
+{
+    return (const struct ProgramHeader*)((uintptr_t)header + header->phoff) + idx;
+}
+
+} // !namespace ELF
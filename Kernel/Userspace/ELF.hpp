@@ -0,0 +1,78 @@
+/**
+ * @file ELF.hpp
+ * @author Keeton Feavel (keeton@xyr.is)
+ * @brief ELF32 executable format, as far as loading static executables goes
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @copyright Copyright the Xyris Contributors (c) 2026
+ *
+ */
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#define ELF_MAGIC       0x464C457F  // "\x7F" "ELF" read as a little endian word
+#define ELF_CLASS_32    1
+#define ELF_DATA_LSB    1
+#define ELF_TYPE_EXEC   2
+#define ELF_MACHINE_386 3
+#define ELF_PT_LOAD     1
+#define ELF_PF_X        1
+#define ELF_PF_W        2
+#define ELF_PF_R        4
+
+namespace ELF {
+
+struct Header {
+    uint32_t magic;
+    uint8_t fileClass;
+    uint8_t data;
+    uint8_t identVersion;
+    uint8_t pad[9];
+    uint16_t type;
+    uint16_t machine;
+    uint32_t version;
+    uint32_t entry;
+    uint32_t phoff;
+    uint32_t shoff;
+    uint32_t flags;
+    uint16_t ehsize;
+    uint16_t phentsize;
+    uint16_t phnum;
+    uint16_t shentsize;
+    uint16_t shnum;
+    uint16_t shstrndx;
+} __attribute__((packed));
+static_assert(sizeof(struct Header) == 52);
+
+struct ProgramHeader {
+    uint32_t type;
+    uint32_t offset;
+    uint32_t vaddr;
+    uint32_t paddr;
+    uint32_t filesz;
+    uint32_t memsz;
+    uint32_t flags;
+    uint32_t align;
+} __attribute__((packed));
+static_assert(sizeof(struct ProgramHeader) == 32);
+
+/**
+ * @brief Check that an image is a static i686 executable whose headers lie
+ * within the image.
+ *
+ * @param image Start of the image
+ * @param size Size of the image in bytes
+ * @return const Header* The image's header, or NULL if it can't be loaded
+ */
+const struct Header* validate(const void* image, size_t size);
+
+/**
+ * @brief Get a program header of a validated image.
+ *
+ */
+const struct ProgramHeader* programHeader(const struct Header* header, size_t idx);
+
+} // !namespace ELF
@@ -0,0 +1,301 @@
+/**
+ * @file Process.cpp
+ * @author Keeton Feavel (keeton@xyr.is)
+ * @brief User mode processes and demand paging of their executables
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @copyright Copyright the Xyris Contributors (c) 2026
+ *
+ */
+#include <Userspace/Process.hpp>
+#include <Devices/Graphics/console.hpp>
+#include <Library/string.hpp>
+#include <Logger.hpp>
+#include <Metrics.hpp>
+#include <Panic.hpp>
+
+#define PAGE_FAULT_PRESENT  0x1 // Protection violation on a present page
+#define PAGE_FAULT_WRITE    0x2
+#define PAGE_FAULT_USER     0x4
+#define EFLAGS_IF           0x200
+#define WRITE_CHUNK_SIZE    128
+
+namespace Userspace {
+
+METRIC_COUNTER(pagesLoaded, "proc.pages_loaded", "pages");
+METRIC_COUNTER(syscalls, "proc.syscalls", "calls");
+
+Process::Process(Memory::Virtual::User* space, const void* image, size_t size)
+    : m_space(space)
+    , m_image((const uint8_t*)image)
+    , m_imageSize(size)
+    , m_entry(0)
+    , m_segmentCount(0)
+    , m_pagesLoaded(0)
+{
+    // Private constructor, see spawn()
+}
+
+Process::~Process()
+{
+    delete m_space;
+}
+
+Process* Process::spawn(const char* name, const void* image, size_t size)
+{
+    if (!Memory::isUserSpaceAvailable()) {
+        Logger::Warning(__func__, "User space is unavailable, not starting %s", name);
+        return NULL;
+    }
+
+    const struct ELF::Header* header = ELF::validate(image, size);
+    if (header == NULL) {
+        return NULL;
+    }
+
+    Memory::Virtual::User* space = Memory::Virtual::User::create();
+    if (space == NULL) {
+        return NULL;
+    }
+
+    Process* process = new Process(space, image, size);
+    if (process == NULL) {
+        delete space;
+        return NULL;
+    }
+    if (!process->load(header)) {
+        Logger::Warning(__func__, "Unable to load %s", name);
+        delete process;
+        return NULL;
+    }
+
+    // the task is embedded in the process, which is freed by cleanup()
+    tasks_new(start, &process->m_task, TASK_PAUSED, name);
+    process->m_task.page_dir = space->directoryPhysical();
+    process->m_task.process = process;
+    process->m_task.cleanup = cleanup;
+    Logger::Info(__func__, "Starting %s at 0x%08lx (%zu segments)", name, (uint32_t)process->m_entry, process->m_segmentCount - 1);
+    tasks_unblock(&process->m_task);
+
+    return process;
+}
+
+Process* Process::current()
+{
+    struct task* task = this_cpu_read(current_task);
+    return task ? task->process : NULL;
+}
+
+bool Process::load(const struct ELF::Header* header)
+{
+    for (size_t idx = 0; idx < header->phnum; idx++) {
+        const struct ELF::ProgramHeader* phdr = ELF::programHeader(header, idx);
+        if (phdr->type != ELF_PT_LOAD || phdr->memsz == 0) {
+            continue;
+        }
+        // segments must be backed by the image and stay clear of the stack
+        if (phdr->filesz > phdr->memsz
+            || phdr->offset > m_imageSize
+            || phdr->filesz > m_imageSize - phdr->offset
+            || phdr->vaddr < USER_SPACE_BASE
+            || phdr->memsz > PROCESS_STACK_TOP - PROCESS_STACK_SIZE - phdr->vaddr) {
+            Logger::Warning(__func__, "Segment %zu (0x%08lx) is out of bounds", idx, phdr->vaddr);
+            return false;
+        }
+
+        uintptr_t start = phdr->vaddr;
+        if (!addSegment(start, start + phdr->memsz, start + phdr->filesz, phdr->offset, phdr->flags & ELF_PF_W)) {
+            return false;
+        }
+    }
+
+    bool entryMapped = false;
+    for (size_t idx = 0; idx < m_segmentCount; idx++) {
+        entryMapped |= header->entry >= m_segments[idx].start && header->entry < m_segments[idx].end;
+    }
+    if (!entryMapped) {
+        Logger::Warning(__func__, "Entry point 0x%08lx is not in any segment", header->entry);
+        return false;
+    }
+    m_entry = header->entry;
+
+    // the stack is just another zero filled segment
+    uintptr_t stackBase = PROCESS_STACK_TOP - PROCESS_STACK_SIZE;
+    m_segments[m_segmentCount++] = { stackBase, PROCESS_STACK_TOP, stackBase, 0, true };
+    return true;
+}
+
+bool Process::addSegment(uintptr_t start, uintptr_t end, uintptr_t fileEnd, size_t fileOffset, bool writable)
+{
+    if (m_segmentCount == PROCESS_MAX_SEGMENTS) {
+        Logger::Warning(__func__, "Too many segments");
+        return false;
+    }
+
+    m_segments[m_segmentCount++] = { start, end, fileEnd, fileOffset, writable };
+    return true;
+}
+
+bool Process::pageIn(uintptr_t addr, bool write)
+{
+    uintptr_t page = Arch::Memory::pageAlign(addr);
+    uintptr_t pageEnd = page + ARCH_PAGE_SIZE;
+
+    // neighbouring segments can share a page, so the page is writable if any of them is
+    bool covered = false;
+    bool writable = false;
+    for (size_t idx = 0; idx < m_segmentCount; idx++) {
+        const struct Segment& seg = m_segments[idx];
+        if (seg.start < pageEnd && seg.end > page) {
+            covered = true;
+            writable |= seg.writable;
+        }
+    }
+    if (!covered || (write && !writable)) {
+        return false;
+    }
+
+    // fresh frames are zeroed, which takes care of .bss and the stack
+    uint8_t* frame = (uint8_t*)Memory::newFrame();
+    if (frame == NULL) {
+        return false;
+    }
+    for (size_t idx = 0; idx < m_segmentCount; idx++) {
+        const struct Segment& seg = m_segments[idx];
+        uintptr_t from = seg.start > page ? seg.start : page;
+        uintptr_t to = seg.fileEnd < pageEnd ? seg.fileEnd : pageEnd;
+        if (from < to) {
+            memcpy(frame + (from - page), m_image + seg.fileOffset + (from - seg.start), to - from);
+        }
+    }
+
+    if (!m_space->mapPage(page, frame, writable)) {
+        Memory::freeFrame(frame);
+        return false;
+    }
+
+    m_pagesLoaded++;
+    m_task.pages++;
+    Metrics::inc(pagesLoaded);
+    return true;
+}
+
+void Process::kill(const char* reason, uintptr_t addr)
+{
+    Logger::Warning(__func__, "Killing %s: %s (0x%08lx)", name(), reason, (uint32_t)addr);
+    // faults and system calls arrive with interrupts disabled
+    Arch::CPU::interruptsEnable();
+    tasks_exit();
+    panic("Killed process was scheduled");
+}
+
+void Process::start()
+{
+    Process* process = current();
+    Arch::CPU::enterUserMode(process->m_entry, PROCESS_STACK_TOP);
+}
+
+void Process::cleanup(struct task* task)
+{
+    Process* process = task->process;
+    Logger::Debug(__func__, "%s exited after loading %zu pages", process->name(), process->m_pagesLoaded);
+    delete process;
+}
+
+void Process::syscall(struct registers* regs)
+{
+    Process* process = current();
+    if (process == NULL) {
+        panic("System call from a kernel task");
+    }
+    // system calls may block, e.g. on the console
+    Arch::CPU::interruptsEnable();
+    Metrics::inc(syscalls);
+
+    switch (regs->eax) {
+        case SYSCALL_EXIT: {
+            Logger::Debug(__func__, "%s exited with status %lu", process->name(), regs->ebx);
+            tasks_exit();
+            panic("Exited process was scheduled");
+        }
+        case SYSCALL_WRITE: {
+            uintptr_t buffer = regs->ebx;
+            size_t length = regs->ecx;
+            if (buffer < USER_SPACE_BASE || buffer > USER_SPACE_END || length > USER_SPACE_END - buffer) {
+                regs->eax = (uint32_t)-1;
+                break;
+            }
+            // copying may fault pages in (or kill the process), so never do it while printing
+            char chunk[WRITE_CHUNK_SIZE + 1];
+            for (size_t done = 0; done < length;) {
+                size_t count = length - done < WRITE_CHUNK_SIZE ? length - done : WRITE_CHUNK_SIZE;
+                memcpy(chunk, (const void*)(buffer + done), count);
+                chunk[count] = '\0';
+                Console::write(chunk);
+                done += count;
+            }
+            regs->eax = length;
+            break;
+        }
+        default: {
+            regs->eax = (uint32_t)-1;
+            break;
+        }
+    }
+}
+
+void Process::exception(struct registers* regs)
+{
+    // faults in user mode only take down the process
+    Process* process = current();
+    if (process == NULL || (regs->cs & 3) != 3) {
+        panic(regs);
+    }
+
+    process->kill("unhandled exception", regs->eip);
+}
+
+void init()
+{
+    Interrupts::registerHandler(Interrupts::INTERRUPT_SYSCALL, Process::syscall);
+    Interrupts::registerHandler(Interrupts::EXCEPTION_DIVIDE_BY_ZERO, Process::exception);
+    Interrupts::registerHandler(Interrupts::EXCEPTION_OVERFLOW, Process::exception);
+    Interrupts::registerHandler(Interrupts::EXCEPTION_BOUND_RANGE, Process::exception);
+    Interrupts::registerHandler(Interrupts::EXCEPTION_INVALID_OPCODE, Process::exception);
+    Interrupts::registerHandler(Interrupts::EXCEPTION_STACK_SEG_FAULT, Process::exception);
+    Interrupts::registerHandler(Interrupts::EXCEPTION_PROTECT_FAULT, Process::exception);
+}
+
+bool handlePageFault(struct registers* regs)
+{
+    Process* process = Process::current();
+    if (process == NULL) {
+        return false;
+    }
+
+    uintptr_t addr = Registers::readCR2().pageFaultAddr;
+    bool inUserSpace = addr >= USER_SPACE_BASE && addr < USER_SPACE_END;
+    if (!(regs->err_code & PAGE_FAULT_USER) && !inUserSpace) {
+        // the kernel itself faulted
+        return false;
+    }
+    if (!inUserSpace) {
+        process->kill("access to kernel memory", addr);
+    }
+    if (regs->err_code & PAGE_FAULT_PRESENT) {
+        process->kill("protection violation", addr);
+    }
+
+    // loading the page may block
+    if (regs->eflags & EFLAGS_IF) {
+        Arch::CPU::interruptsEnable();
+    }
+    if (!process->pageIn(addr, regs->err_code & PAGE_FAULT_WRITE)) {
+        process->kill("segmentation fault", addr);
+    }
+
+    return true;
+}
+
+} // !namespace Userspace
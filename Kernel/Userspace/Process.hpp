@@ -0,0 +1,115 @@
+/**
+ * @file Process.hpp
+ * @author Keeton Feavel (keeton@xyr.is)
+ * @brief User mode processes. Each process runs a static ELF executable in
+ * its own address space. Nothing is copied up front: pages are filled in
+ * from the executable image the first time they are touched.
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @copyright Copyright the Xyris Contributors (c) 2026
+ *
+ */
+#pragma once
+
+#include <Arch/Arch.hpp>
+#include <Memory/User.hpp>
+#include <Memory/paging.hpp>
+#include <Scheduler/tasks.hpp>
+#include <Userspace/ELF.hpp>
+#include <stddef.h>
+#include <stdint.h>
+
+#define PROCESS_MAX_SEGMENTS    8
+#define PROCESS_STACK_SIZE      (64 * 1024)
+#define PROCESS_STACK_TOP       USER_SPACE_END
+
+namespace Userspace {
+
+/**
+ * @brief System call numbers, passed in EAX to `int 0x80`. Arguments go in
+ * EBX, ECX and EDX and the result comes back in EAX.
+ *
+ */
+enum Syscall {
+    SYSCALL_EXIT = 0,   // exit(status)
+    SYSCALL_WRITE = 1,  // write(buffer, length) to the console, returns bytes written
+};
+
+class Process {
+public:
+    Process(Process const&) = delete;
+    void operator=(Process const&) = delete;
+
+    /**
+     * @brief Start a process running an ELF executable. The image must stay
+     * in memory for as long as the process runs.
+     *
+     * @param name Process name
+     * @param image Executable image
+     * @param size Size of the image in bytes
+     * @return Process* The process, or NULL if the image can't be loaded
+     */
+    static Process* spawn(const char* name, const void* image, size_t size);
+
+    /**
+     * @brief Process the calling task belongs to.
+     *
+     * @return Process* The process, or NULL for kernel tasks
+     */
+    static Process* current();
+
+    const char* name() { return m_task.name; }
+
+private:
+    struct Segment {
+        uintptr_t start;        // First address (not necessarily page aligned)
+        uintptr_t end;          // Last address + 1
+        uintptr_t fileEnd;      // End of the part backed by the image
+        size_t fileOffset;      // Image offset of the start
+        bool writable;
+    };
+
+    Process(Memory::Virtual::User* space, const void* image, size_t size);
+    ~Process();
+
+    bool load(const struct ELF::Header* header);
+    bool addSegment(uintptr_t start, uintptr_t end, uintptr_t fileEnd, size_t fileOffset, bool writable);
+    bool pageIn(uintptr_t addr, bool write);
+    [[noreturn]] void kill(const char* reason, uintptr_t addr);
+
+    static void start();
+    static void cleanup(struct task* task);
+    static void syscall(struct registers* regs);
+    static void exception(struct registers* regs);
+
+    friend void init();
+    friend bool handlePageFault(struct registers* regs);
+
+    struct task m_task;
+    Memory::Virtual::User* m_space;
+    const uint8_t* m_image;
+    size_t m_imageSize;
+    uintptr_t m_entry;
+    struct Segment m_segments[PROCESS_MAX_SEGMENTS + 1]; // Plus the stack
+    size_t m_segmentCount;
+    size_t m_pagesLoaded;
+};
+
+/**
+ * @brief Install the system call and exception handlers. Must be called
+ * before the first process is spawned.
+ *
+ */
+void init();
+
+/**
+ * @brief Page in a user page on demand.
+ *
+ * @param regs Page fault register state
+ * @return true The fault was handled (the faulting process may have been killed)
+ * @return false The fault didn't come from a process and is fatal
+ */
+bool handlePageFault(struct registers* regs);
+
+} // !namespace Userspace
@@ -0,0 +1,124 @@
+#!/usr/bin/env python3
+"""
+Turn screen captures in a serial log into PNG images.
+
+Captures are requested by sending 'c' to the kernel over serial ('C' for a
+full frame), or recorded frame by frame from animations when booted with
+`--capture`. Each capture is an LZ4 frame holding the tiles that changed since
+the previous one (see Kernel/Devices/Graphics/capture.hpp), so the screen is
+rebuilt capture by capture and saved after each. Captures before the first
+full frame are skipped, since there is nothing to apply them to, and so are
+captures after a missing or damaged one until the next full frame.
+"""
+import argparse
+import importlib
+import os
+import struct
+import sys
+import zlib
+
+sys.path.insert(0, os.path.dirname(os.path.abspath(__file__)))
+lz4 = importlib.import_module("lz4-decode")
+
+MAGIC = b"XCAP"
+VERSION = 1
+HEADER = struct.Struct("<4sHHIIBBxxIQI")
+
+
+def write_png(path, width, height, rows):
+    def chunk(kind, data):
+        return struct.pack(">I", len(data)) + kind + data + struct.pack(">I", zlib.crc32(kind + data))
+
+    raw = b"".join(b"\x00" + row for row in rows)  # filter type 0 on every row
+    with open(path, "wb") as png:
+        png.write(b"\x89PNG\r\n\x1a\n")
+        png.write(chunk(b"IHDR", struct.pack(">IIBBBBB", width, height, 8, 2, 0, 0, 0)))
+        png.write(chunk(b"IDAT", zlib.compress(raw, 6)))
+        png.write(chunk(b"IEND", b""))
+
+
+class Screen:
+    def __init__(self, width, height, pixel_width):
+        self.width, self.height, self.pixel_width = width, height, pixel_width
+        self.rows = [bytearray(width * pixel_width) for _ in range(height)]
+
+    def apply(self, data, pos, tile, count):
+        for _ in range(count):
+            column, row = struct.unpack_from("<HH", data, pos)
+            pos += 4
+            x, y = column * tile, row * tile
+            size = min(tile, self.width - x) * self.pixel_width
+            offset = x * self.pixel_width
+            for line in range(y, min(y + tile, self.height)):
+                if pos + size > len(data):
+                    raise lz4.FrameError("truncated tile")
+                self.rows[line][offset:offset + size] = data[pos:pos + size]
+                pos += size
+
+    def rgb_rows(self):
+        step = self.pixel_width
+        for row in self.rows:
+            rgb = bytearray(self.width * 3)
+            rgb[0::3] = row[2::step]
+            rgb[1::3] = row[1::step]
+            rgb[2::3] = row[0::step]
+            yield bytes(rgb)
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Rebuild Xyris screen captures from a serial log")
+    parser.add_argument("log", help="captured serial log")
+    parser.add_argument("-o", "--output", default=".", help="directory for the images")
+    parser.add_argument("--prefix", default="capture", help="image file name prefix")
+    args = parser.parse_args()
+
+    with open(args.log, "rb") as file:
+        log = file.read()
+    os.makedirs(args.output, exist_ok=True)
+
+    screen = None
+    last = None  # sequence number of the last capture applied to the screen
+    saved = skipped = 0
+    pos = 0
+    while (start := log.find(lz4.MAGIC, pos)) >= 0:
+        try:
+            data, pos = lz4.read_frame(log, start)
+        except lz4.FrameError as error:
+            print(f"{args.log}: skipping frame at byte {start}: {error}", file=sys.stderr)
+            pos = start + len(lz4.MAGIC)
+            continue
+        if len(data) < HEADER.size or not data.startswith(MAGIC):
+            continue  # some other compressed dump
+
+        magic, version, tile, width, height, pixel_width, full, sequence, time_ns, count = \
+            HEADER.unpack_from(data)
+        if version != VERSION or pixel_width not in (3, 4):
+            print(f"capture {sequence}: unsupported version or pixel format", file=sys.stderr)
+            continue
+        if full:
+            screen = Screen(width, height, pixel_width)
+        elif screen is not None and sequence != (last + 1) & 0xFFFFFFFF:
+            print(f"capture {sequence}: expected capture {(last + 1) & 0xFFFFFFFF}, "
+                  "skipping until the next full frame", file=sys.stderr)
+            screen = None
+        if screen is None or (screen.width, screen.height) != (width, height):
+            skipped += 1
+            continue
+        try:
+            screen.apply(data, HEADER.size, tile, count)
+        except (lz4.FrameError, struct.error) as error:
+            print(f"capture {sequence}: {error}", file=sys.stderr)
+            screen = None
+            continue
+        last = sequence
+
+        path = os.path.join(args.output, f"{args.prefix}-{sequence:05d}.png")
+        write_png(path, width, height, screen.rgb_rows())
+        saved += 1
+        print(f"{path}: {count} tiles at {time_ns / 1e9:.3f} s", file=sys.stderr)
+
+    print(f"{saved} images saved, {skipped} captures skipped without a full frame", file=sys.stderr)
+
+
+if __name__ == "__main__":
+    main()
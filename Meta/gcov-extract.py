@@ -0,0 +1,102 @@
+#!/usr/bin/env python3
+"""
+Write the .gcda profiles in a serial log back out as files.
+
+Kernels built with `scons pgo=generate` dump their profile counters once the
+prime benchmark finishes, or whenever 'g' is sent over serial. Each dump is an
+LZ4 frame (see Kernel/Support/gcov.hpp) holding one .gcda file per object,
+named with the path the compiler expected. Counters only ever grow, so the
+last complete dump in the log is used.
+
+The files are written to those paths, which is next to the objects in
+Build/i686/PGO where `scons pgo=use` looks for them. `--strip` and
+`--output` move them when the kernel was built somewhere else, e.g. in a
+container.
+"""
+import argparse
+import importlib
+import os
+import struct
+import sys
+
+sys.path.insert(0, os.path.dirname(os.path.abspath(__file__)))
+lz4 = importlib.import_module("lz4-decode")
+
+MAGIC = b"XGCD"
+VERSION = 1
+GCDA_MAGIC = 0x67636461
+
+
+def parse_dump(data):
+    """Returns a list of (path, contents) from a dump."""
+    (version,) = struct.unpack_from("<I", data, 4)
+    if version != VERSION:
+        raise lz4.FrameError(f"unsupported dump version {version}")
+    files = []
+    pos = 8
+    while True:
+        (length,) = struct.unpack_from("<I", data, pos)
+        pos += 4
+        if length == 0:
+            return files
+        path = data[pos:pos + length].decode()
+        pos += length
+        (size,) = struct.unpack_from("<I", data, pos)
+        pos += 4
+        contents = data[pos:pos + size]
+        pos += size
+        if len(contents) != size or struct.unpack_from("<I", contents)[0] != GCDA_MAGIC:
+            raise lz4.FrameError(f"{path}: truncated or not a .gcda file")
+        files.append((path, contents))
+
+
+def find_dumps(log):
+    dumps = []
+    pos = 0
+    while (start := log.find(lz4.MAGIC, pos)) >= 0:
+        try:
+            data, pos = lz4.read_frame(log, start)
+        except lz4.FrameError as error:
+            print(f"skipping frame at byte {start}: {error}", file=sys.stderr)
+            pos = start + len(lz4.MAGIC)
+            continue
+        if not data.startswith(MAGIC):
+            continue  # some other compressed dump
+        try:
+            dumps.append(parse_dump(data))
+        except (lz4.FrameError, struct.error, UnicodeDecodeError) as error:
+            print(f"skipping profile dump at byte {start}: {error}", file=sys.stderr)
+    return dumps
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Extract .gcda profiles from a Xyris serial log")
+    parser.add_argument("log", help="captured serial log")
+    parser.add_argument("--strip", default="", help="prefix to remove from each path")
+    parser.add_argument("-o", "--output", help="directory to write under instead of the paths as given")
+    parser.add_argument("-n", "--dry-run", action="store_true", help="list the files without writing them")
+    args = parser.parse_args()
+
+    with open(args.log, "rb") as file:
+        dumps = find_dumps(file.read())
+    if not dumps:
+        sys.exit(f"{args.log}: no profile dump found")
+
+    files = dumps[-1]
+    for path, contents in files:
+        if args.strip and path.startswith(args.strip):
+            path = path[len(args.strip):]
+        if args.output:
+            path = os.path.join(args.output, path.lstrip("/"))
+        print(f"{path}: {len(contents)} bytes", file=sys.stderr)
+        if args.dry_run:
+            continue
+        os.makedirs(os.path.dirname(path) or ".", exist_ok=True)
+        with open(path, "wb") as gcda:
+            gcda.write(contents)
+
+    print(f"{len(files)} profiles from the last of {len(dumps)} dumps", file=sys.stderr)
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,144 @@
+#!/usr/bin/env python3
+"""
+Expand compressed dumps in a captured serial log.
+
+Dumps requested with an upper case command (e.g. 'M' for metrics) or sent with
+`--metrics-lz4` arrive as binary frames in the serial log (see
+Kernel/Library/lz4.hpp for the layout). Every frame found is replaced by the
+text it contains, so the output can be read or fed to `metrics-diff.py` like
+an uncompressed log. Frames that are damaged (e.g. by log output written in
+the middle of them) are reported and left out.
+"""
+import argparse
+import struct
+import sys
+import zlib
+
+MAGIC = b"XLZ4"
+VERSION = 1
+RAW_BLOCK = 0x80000000
+MAX_BLOCK_LOG = 22
+
+
+class FrameError(Exception):
+    pass
+
+
+def decompress_block(data, limit):
+    out = bytearray()
+    pos = 0
+
+    def length(value):
+        nonlocal pos
+        if value != 15:
+            return value
+        while True:
+            if pos >= len(data):
+                raise FrameError("truncated length")
+            byte = data[pos]
+            pos += 1
+            value += byte
+            if byte != 255:
+                return value
+
+    while True:
+        if pos >= len(data):
+            raise FrameError("truncated sequence")
+        token = data[pos]
+        pos += 1
+        literals = length(token >> 4)
+        if pos + literals > len(data):
+            raise FrameError("literals past the end of the block")
+        out += data[pos:pos + literals]
+        pos += literals
+        if pos == len(data):
+            break
+        if pos + 2 > len(data):
+            raise FrameError("truncated offset")
+        offset = data[pos] | data[pos + 1] << 8
+        pos += 2
+        if offset == 0 or offset > len(out):
+            raise FrameError("bad match offset")
+        match = length(token & 15) + 4
+        start = len(out) - offset
+        for idx in range(match):
+            out.append(out[start + idx])
+        if len(out) > limit:
+            raise FrameError("block larger than its content size")
+    return bytes(out)
+
+
+def read_frame(log, start):
+    """Decode the frame starting at log[start]. Returns (text, end)."""
+    if log[start + 4] != VERSION or log[start + 5] > MAX_BLOCK_LOG:
+        raise FrameError("unknown frame version or block size")
+    block_size = 1 << log[start + 5]
+    pos = start + 8
+    out = bytearray()
+    while True:
+        if pos + 4 > len(log):
+            raise FrameError("truncated frame")
+        (stored,) = struct.unpack_from("<I", log, pos)
+        pos += 4
+        if stored == 0:
+            return bytes(out), pos
+        size = stored & ~RAW_BLOCK
+        if pos + 8 + size > len(log):
+            raise FrameError("truncated block")
+        (content,) = struct.unpack_from("<I", log, pos)
+        pos += 4
+        if content > block_size:
+            raise FrameError("block larger than the frame's block size")
+        data = log[pos:pos + size]
+        pos += size
+        block = data if stored & RAW_BLOCK else decompress_block(data, content)
+        (crc,) = struct.unpack_from("<I", log, pos)
+        pos += 4
+        if len(block) != content or zlib.crc32(block) != crc:
+            raise FrameError("block checksum mismatch")
+        out += block
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Expand compressed Xyris dumps in a serial log")
+    parser.add_argument("log", help="captured serial log")
+    parser.add_argument("-o", "--output", help="write here instead of standard output")
+    args = parser.parse_args()
+
+    with open(args.log, "rb") as file:
+        log = file.read()
+
+    out = bytearray()
+    pos = 0
+    frames = compressed = expanded = 0
+    while True:
+        start = log.find(MAGIC, pos)
+        if start < 0 or start + 8 > len(log):
+            out += log[pos:]
+            break
+        out += log[pos:start]
+        try:
+            text, end = read_frame(log, start)
+        except FrameError as error:
+            line = log.count(b"\n", 0, start) + 1
+            print(f"{args.log}:{line}: skipping frame: {error}", file=sys.stderr)
+            pos = start + len(MAGIC)
+            continue
+        out += text
+        frames += 1
+        compressed += end - start
+        expanded += len(text)
+        pos = end
+
+    if args.output:
+        with open(args.output, "wb") as file:
+            file.write(out)
+    else:
+        sys.stdout.buffer.write(out)
+    if frames:
+        print(f"{frames} frames, {compressed} bytes expanded to {expanded} ({expanded / compressed:.1f}x)",
+              file=sys.stderr)
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,111 @@
+#!/usr/bin/env python3
+"""
+Compare two kernel metrics dumps.
+
+Dumps are requested by sending 'm' (text) or 'j' (JSON) to the kernel over
+serial, or printed once a second when booted with `--metrics` or
+`--metrics-json`. Each input may be a whole serial log; the last dump in it is
+used, or the first one with `--first`. When only one file is given, its first
+and last dumps are compared instead.
+
+Counters are shown as the change and the rate between the two dumps, gauges as
+both values and histograms as the change in count and mean.
+"""
+import argparse
+import json
+import sys
+
+
+def parse_text(lines, start):
+    """Parse a text dump whose 'metrics begin' line is lines[start]."""
+    time_ns = int(lines[start].split()[2])
+    metrics = {}
+    for line in lines[start + 1:]:
+        if line.startswith("metrics end"):
+            break
+        fields = line.split()
+        if len(fields) < 5 or fields[0] != "metric":
+            continue  # log output interleaved with the dump
+        kind, name, value, unit = fields[1], fields[2], int(fields[3]), fields[4]
+        metric = {"type": kind, "unit": unit, "value": value}
+        if kind == "histogram":
+            metric["sum"] = int(fields[5].split("=")[1])
+            buckets = [0] * 32
+            for field in fields[6:]:
+                bucket, count = field[1:].split("=")
+                buckets[int(bucket)] = int(count)
+            metric["buckets"] = buckets
+        metrics[name] = metric
+    return time_ns, metrics
+
+
+def parse_json(line):
+    dump = json.loads(line)
+    metrics = {m["name"]: m for m in dump["metrics"]}
+    return dump["time_ns"], metrics
+
+
+def find_dumps(path):
+    with open(path, errors="replace") as log:
+        lines = [line.strip() for line in log]
+
+    dumps = []
+    for idx, line in enumerate(lines):
+        try:
+            if line.startswith("metrics begin"):
+                dumps.append(parse_text(lines, idx))
+            elif line.startswith('{"time_ns"'):
+                dumps.append(parse_json(line))
+        except (ValueError, KeyError, IndexError):
+            print(f"{path}:{idx + 1}: skipping malformed dump", file=sys.stderr)
+    if not dumps:
+        sys.exit(f"{path}: no metrics dump found")
+    return dumps
+
+
+def mean(metric):
+    return metric["sum"] / metric["value"] if metric["value"] else 0.0
+
+
+def compare(before, after):
+    (start, old), (end, new) = before, after
+    seconds = (end - start) / 1e9
+    print(f"{'metric':<32} {'type':<9} {'before':>14} {'after':>14} {'change':>14} {'per second':>14}")
+    for name in sorted(set(old) | set(new)):
+        if name not in old or name not in new:
+            print(f"{name:<32} only in {'the second' if name in new else 'the first'} dump")
+            continue
+        a, b = old[name], new[name]
+        delta = b["value"] - a["value"]
+        rate = f"{delta / seconds:.1f}" if seconds > 0 and a["type"] != "gauge" else ""
+        print(f"{name:<32} {a['type']:<9} {a['value']:>14} {b['value']:>14} {delta:>+14} {rate:>14}  {a['unit']}")
+        if a["type"] == "histogram":
+            changed = [n - o for o, n in zip(a["buckets"], b["buckets"])]
+            print(f"{'':<32} {'mean':<9} {mean(a):>14.1f} {mean(b):>14.1f}")
+            for bucket, count in enumerate(changed):
+                if count:
+                    low = 0 if bucket == 0 else 1 << (bucket - 1)
+                    print(f"{'':<32} [{low}, {1 << bucket}) {count:+}")
+    print(f"\n{seconds:.3f} s between dumps")
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Compare two Xyris metrics dumps")
+    parser.add_argument("before", help="serial log or dump taken first")
+    parser.add_argument("after", nargs="?", help="serial log or dump taken later")
+    parser.add_argument("--first", action="store_true", help="use the first dump in each file")
+    args = parser.parse_args()
+
+    if args.after is None:
+        dumps = find_dumps(args.before)
+        if len(dumps) < 2:
+            sys.exit(f"{args.before}: need at least two dumps to compare")
+        compare(dumps[0], dumps[-1])
+        return
+
+    pick = 0 if args.first else -1
+    compare(find_dumps(args.before)[pick], find_dumps(args.after)[pick])
+
+
+if __name__ == "__main__":
+    main()
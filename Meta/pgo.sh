@@ -0,0 +1,56 @@
+#!/usr/bin/env bash
+# Profile guided kernel build:
+#   1. build an instrumented kernel (scons pgo=generate)
+#   2. boot it headless until the prime benchmark has dumped its profile
+#   3. write the .gcda files next to the objects (Meta/gcov-extract.py)
+#   4. rebuild with the profile (scons pgo=use)
+# The optimized image ends up in Distribution/i686/PGO/xyris.img.
+set -e
+cd "$(dirname "$0")/.."
+timeout="${PGO_TIMEOUT:=300}"   # Seconds to wait for the profile
+log=Build/i686/PGO/training.log
+
+if ! command -v qemu-system-x86_64 > /dev/null
+then
+    echo 'qemu-system-x86_64 not installed'
+    exit 1
+fi
+
+scons -j"$(nproc)" pgo=generate kernel-pgo
+
+rm -f "$log"
+qemu-system-x86_64 \
+    -drive file=Distribution/i686/PGO/xyris.img,index=0,media=disk,format=raw \
+    -m 4G \
+    -rtc clock=host \
+    -vga std \
+    -display none \
+    -serial file:"$log" &
+qemu=$!
+trap 'kill $qemu 2> /dev/null || true' EXIT
+
+for (( waited = 0; waited < timeout; waited++ ))
+do
+    if grep -aq '^gcov end' "$log" 2> /dev/null
+    then
+        break
+    fi
+    if ! kill -0 $qemu 2> /dev/null
+    then
+        echo 'qemu exited before the profile was written'
+        exit 1
+    fi
+    sleep 1
+done
+kill $qemu 2> /dev/null || true
+
+if ! grep -aq '^gcov end' "$log"
+then
+    echo "No profile after ${timeout} seconds, see $log"
+    exit 1
+fi
+
+Meta/gcov-extract.py "$log"
+# SCons doesn't track the profile, so objects built from an older one would be kept
+scons -c pgo=use kernel-pgo
+scons -j"$(nproc)" pgo=use kernel-pgo
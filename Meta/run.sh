@@ -1,6 +1,8 @@
 #!/usr/bin/env bash
 MODE="${MODE:=Debug}"
 run_with_debugger=false
+network_args=()
+vga_args=(-vga std)
 
 run_debugger() {
     echo 'Waiting for GDB to attach...'
@@ -9,8 +11,12 @@ run_debugger() {
         -drive file=Distribution/i686/"${MODE}"/xyris.img,index=0,media=disk,format=raw \
         -m 4G \
         -rtc clock=host \
-        -vga std \
-        -serial stdio
+        "${vga_args[@]}" \
+        -chardev stdio,id=console,mux=on \
+        -serial chardev:console \
+        -device virtio-serial-pci \
+        -device virtconsole,chardev=console \
+        "${network_args[@]}"
 }
 
 run_no_debugger() {
@@ -18,8 +24,12 @@ run_no_debugger() {
         -drive file=Distribution/i686/"${MODE}"/xyris.img,index=0,media=disk,format=raw \
         -m 4G \
         -rtc clock=host \
-        -vga std \
-        -serial stdio \
+        "${vga_args[@]}" \
+        -chardev stdio,id=console,mux=on \
+        -serial chardev:console \
+        -device virtio-serial-pci \
+        -device virtconsole,chardev=console \
+        "${network_args[@]}" \
         -monitor telnet:127.0.0.1:1234,server,nowait;
 }
 
@@ -29,7 +39,7 @@ then
     exit 1
 fi
 
-while getopts "d" OPTION; do
+while getopts "dg:n:" OPTION; do
     case $OPTION in
     d)
         echo 'Attach to `qemu` with GDB by running the following commands (in GDB):'
@@ -38,6 +48,36 @@ while getopts "d" OPTION; do
         echo
         run_with_debugger=true
         ;;
+    g)
+        # std:    Bochs Graphics Adapter
+        # virtio: virtio GPU (with a VGA compatible fallback)
+        case $OPTARG in
+        std|virtio)
+            vga_args=(-vga "$OPTARG")
+            ;;
+        *)
+            echo 'Graphics must be one of: std, virtio'
+            exit 1
+            ;;
+        esac
+        ;;
+    n)
+        # user:     QEMU user mode (slirp) networking
+        # loopback: UDP socket that sends every frame back to the guest
+        case $OPTARG in
+        user)
+            network_args=(-netdev user,id=net0)
+            ;;
+        loopback)
+            network_args=(-netdev socket,id=net0,udp=127.0.0.1:5555,localaddr=127.0.0.1:5555)
+            ;;
+        *)
+            echo 'Network must be one of: user, loopback'
+            exit 1
+            ;;
+        esac
+        network_args+=(-device virtio-net-pci,netdev=net0)
+        ;;
     *)
         echo 'Incorrect options provided'
         exit 1
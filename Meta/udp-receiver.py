@@ -0,0 +1,61 @@
+#!/usr/bin/env python3
+"""
+Receive the kernel UDP stream (`--udp-stream`) and report throughput.
+
+Under QEMU user networking (`Meta/run.sh -n user`) the guest reaches the host
+at 10.0.2.2, so datagrams sent there arrive on the host's loopback interface.
+Each datagram starts with a 32-bit big endian sequence number, which is used
+to count lost and reordered datagrams.
+"""
+import argparse
+import socket
+import struct
+import time
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Receive the Xyris UDP stream")
+    parser.add_argument("-a", "--address", default="0.0.0.0", help="address to bind")
+    parser.add_argument("-p", "--port", type=int, default=5556, help="port to bind")
+    args = parser.parse_args()
+
+    sock = socket.socket(socket.AF_INET, socket.SOCK_DGRAM)
+    sock.setsockopt(socket.SOL_SOCKET, socket.SO_RCVBUF, 8 * 1024 * 1024)
+    sock.bind((args.address, args.port))
+    sock.settimeout(1.0)
+    print(f"Listening on {args.address}:{args.port}")
+
+    expected = None
+    datagrams = octets = lost = reordered = 0
+    last = time.monotonic()
+    while True:
+        try:
+            data, _ = sock.recvfrom(65535)
+            if len(data) >= 4:
+                (sequence,) = struct.unpack_from("!I", data)
+                if expected is not None:
+                    if sequence > expected:
+                        lost += sequence - expected
+                    elif sequence < expected:
+                        reordered += 1
+                if expected is None or sequence >= expected:
+                    expected = sequence + 1
+            datagrams += 1
+            octets += len(data)
+        except socket.timeout:
+            pass
+
+        now = time.monotonic()
+        if now - last >= 1.0:
+            elapsed = now - last
+            print(
+                f"{datagrams / elapsed:10.0f} datagrams/s "
+                f"{octets / elapsed / (1024 * 1024):8.2f} MiB/s "
+                f"lost {lost} reordered {reordered}"
+            )
+            datagrams = octets = lost = reordered = 0
+            last = now
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,44 @@
+# Profile guided release builds. PGO_PHASE picks the pass:
+#   generate: instrumented kernel that collects branch counters (see Kernel/Support/gcov.hpp)
+#   use:      optimized kernel built from the .gcda files Meta/gcov-extract.py wrote
+# Both passes share a build directory so the profile lands next to the objects.
+# The profile flags live in PROFILE_FLAGS so code that must not be instrumented
+# (e.g. early boot code) can clear them.
+def generate(env):
+    env.Replace(
+        MODE='PGO'
+    )
+    phase = env.get('PGO_PHASE', 'use')
+    flags = [
+        # branch counters only, value profiling needs more of libgcov
+        '-fno-profile-values',
+    ]
+    if phase == 'generate':
+        flags += [
+            '-fprofile-generate',
+            # counters are approximate anyway, atomics would skew the profile
+            '-fprofile-update=single',
+        ]
+    else:
+        flags += [
+            '-fprofile-use',
+            # code the workload never ran is still optimized for speed
+            '-fprofile-partial-training',
+            # a stale or partial profile should not break the build
+            '-Wno-error=missing-profile',
+            '-Wno-error=coverage-mismatch',
+        ]
+    env.Replace(
+        PROFILE_FLAGS=flags
+    )
+    env.Append(
+        # GCOV is defined for both passes so they compile the same code
+        CPPDEFINES={'RELEASE': None, 'GCOV': None},
+        CCFLAGS=[
+            '-O3',
+            '$PROFILE_FLAGS',
+        ],
+    )
+
+def exists(env):
+    return 1
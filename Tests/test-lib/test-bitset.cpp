@@ -0,0 +1,82 @@
+/**
+ * @file test-bitset.cpp
+ * @author Keeton Feavel (keeton@xyr.is)
+ * @brief Bitset unit tests
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright the Xyris Contributors (c) 2026
+ *
+ */
+#include <catch2/catch.hpp>
+// Bitset is header-only template
+#include <Library/Bitset.hpp>
+#include <random>
+
+// Reference implementation that tests every candidate position bit by bit
+template<size_t N>
+static size_t findRange(Bitset<N>& bitset, size_t count, bool isSet)
+{
+    size_t run = 0;
+    for (size_t i = 0; i < N; i++) {
+        run = (bitset.Test(i) == isSet) ? run + 1 : 0;
+        if (count && run == count) {
+            return i + 1 - count;
+        }
+    }
+
+    return Bitset<N>::npos;
+}
+
+TEST_CASE("bitset range search", "[bitset]") {
+    Bitset<4096> bitset(false);
+
+    SECTION("Single bit") {
+        bitset.Set(0);
+        bitset.Set(1);
+        REQUIRE(bitset.FindFirstRange(1, false) == 2);
+        REQUIRE(bitset.FindFirstRange(1, true) == 0);
+    }
+
+    SECTION("Crosses a word boundary") {
+        const size_t word = sizeof(size_t) * CHAR_BIT;
+        for (size_t i = 0; i < word - 2; i++) {
+            bitset.Set(i);
+        }
+        bitset.Set(word + 2);
+        // Clear bits [word - 2, word + 2) straddle the first two words
+        REQUIRE(bitset.FindFirstRange(4, false) == word - 2);
+        REQUIRE(bitset.FindFirstRange(5, false) == word + 3);
+        REQUIRE(bitset.FindFirstRange(word - 2, true) == 0);
+        REQUIRE(bitset.FindFirstRange(word - 1, true) == Bitset<4096>::npos);
+    }
+
+    SECTION("Wider than a word") {
+        // 768 pages is a 1024x768 32-bit framebuffer
+        bitset.Set(5);
+        bitset.Set(700);
+        REQUIRE(bitset.FindFirstRange(768, false) == 701);
+        REQUIRE(bitset.FindFirstRange(694, false) == 6);
+        REQUIRE(bitset.FindFirstRange(4096, false) == Bitset<4096>::npos);
+    }
+
+    SECTION("Whole bitset") {
+        Bitset<4096> full(true);
+        REQUIRE(full.FindFirstRange(4096, true) == 0);
+        REQUIRE(full.FindFirstRange(1, false) == Bitset<4096>::npos);
+    }
+
+    SECTION("Matches reference") {
+        std::mt19937 rng(0x58797269);
+        // Sparse enough that long clear runs exist
+        for (size_t i = 0; i < 4096; i++) {
+            if (rng() % 64 == 0) {
+                bitset.Set(i);
+            }
+        }
+        for (size_t count = 1; count <= 300; count++) {
+            REQUIRE(bitset.FindFirstRange(count, false) == findRange(bitset, count, false));
+            REQUIRE(bitset.FindFirstRange(count, true) == findRange(bitset, count, true));
+        }
+    }
+}
@@ -0,0 +1,200 @@
+/**
+ * @file test-lz4.cpp
+ * @author Keeton Feavel (keeton@xyr.is)
+ * @brief LZ4 compression and CRC-32 unit tests
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @copyright Copyright the Xyris Contributors (c) 2026
+ *
+ */
+#include <catch2/catch.hpp>
+#include <Library/crc32.hpp>
+#include <Library/lz4.hpp>
+#include <cstring>
+#include <random>
+#include <string>
+#include <vector>
+
+static LZ4::HashTable table;
+
+static std::vector<uint8_t> roundtrip(const std::vector<uint8_t>& input)
+{
+    std::vector<uint8_t> compressed(LZ4::compressBound(input.size()));
+    size_t size = LZ4::compress(input.data(), input.size(), compressed.data(), compressed.size(), table);
+    REQUIRE(size > 0);
+    REQUIRE(size <= compressed.size());
+
+    std::vector<uint8_t> output(input.size());
+    size_t written = SIZE_MAX;
+    REQUIRE(LZ4::decompress(compressed.data(), size, output.data(), output.size(), &written));
+    REQUIRE(written == input.size());
+    compressed.resize(size);
+    REQUIRE(output == input);
+    return compressed;
+}
+
+static std::vector<uint8_t> text(size_t lines)
+{
+    std::string dump;
+    for (size_t line = 0; line < lines; line++) {
+        dump += "metric counter irq.count " + std::to_string(line * 7919) + " interrupts\n";
+    }
+    return std::vector<uint8_t>(dump.begin(), dump.end());
+}
+
+static void collect(const void* data, size_t size, void* context)
+{
+    auto frame = static_cast<std::vector<uint8_t>*>(context);
+    frame->insert(frame->end(), (const uint8_t*)data, (const uint8_t*)data + size);
+}
+
+static uint32_t read32(const uint8_t* ptr)
+{
+    return ptr[0] | ptr[1] << 8 | ptr[2] << 16 | (uint32_t)ptr[3] << 24;
+}
+
+TEST_CASE("crc32", "[crc32]") {
+    // Check value from the CRC catalogue
+    REQUIRE(crc32("123456789", 9) == 0xCBF43926);
+    REQUIRE(crc32("", 0) == 0);
+    // Ensure a checksum can be computed in pieces
+    REQUIRE(crc32("6789", 4, crc32("12345", 5)) == 0xCBF43926);
+}
+
+TEST_CASE("lz4 block roundtrip", "[lz4]") {
+    SECTION("Empty") {
+        REQUIRE(roundtrip({ }).size() == 1);
+    }
+    SECTION("Short") {
+        std::vector<uint8_t> input = { 'a', 'b', 'c', 'a', 'b', 'c', 'a', 'b', 'c' };
+        roundtrip(input);
+    }
+    // Ensure repetitive text compresses well
+    SECTION("Text") {
+        auto input = text(1000);
+        REQUIRE(roundtrip(input).size() < input.size() / 3);
+    }
+    // Ensure runs use overlapping matches and long length encodings
+    SECTION("Runs") {
+        std::vector<uint8_t> input(100000, 'x');
+        input.insert(input.end(), 1000, 'y');
+        REQUIRE(roundtrip(input).size() < 1000);
+    }
+    // Ensure incompressible data stays within the bound
+    SECTION("Random") {
+        std::mt19937 rng(1234);
+        std::vector<uint8_t> input(65536 * 3);
+        for (auto& byte : input) {
+            byte = (uint8_t)rng();
+        }
+        roundtrip(input);
+    }
+    // Ensure matches further back than the maximum offset aren't used
+    SECTION("Distant repeats") {
+        std::mt19937 rng(99);
+        std::vector<uint8_t> block(70000);
+        for (auto& byte : block) {
+            byte = (uint8_t)rng();
+        }
+        std::vector<uint8_t> input = block;
+        input.insert(input.end(), block.begin(), block.end());
+        roundtrip(input);
+    }
+    // Ensure every input length around the end of block limits works
+    SECTION("Lengths") {
+        auto base = text(4);
+        for (size_t length = 0; length < base.size(); length++) {
+            roundtrip(std::vector<uint8_t>(base.begin(), base.begin() + length));
+        }
+    }
+}
+
+TEST_CASE("lz4 malformed input", "[lz4]") {
+    auto input = text(100);
+    std::vector<uint8_t> compressed(LZ4::compressBound(input.size()));
+    size_t size = LZ4::compress(input.data(), input.size(), compressed.data(), compressed.size(), table);
+    std::vector<uint8_t> output(input.size());
+    size_t written;
+
+    SECTION("Output too small") {
+        REQUIRE(!LZ4::decompress(compressed.data(), size, output.data(), output.size() - 1, &written));
+    }
+    SECTION("Empty") {
+        REQUIRE(!LZ4::decompress(compressed.data(), 0, output.data(), output.size(), &written));
+    }
+    SECTION("Offset before the start") {
+        // literal 'a' followed by a match 2 bytes back
+        uint8_t bad[] = { 0x10, 'a', 0x02, 0x00, 0x00 };
+        REQUIRE(!LZ4::decompress(bad, sizeof(bad), output.data(), output.size(), &written));
+    }
+    // Ensure no truncation of a valid block is accepted or overruns
+    SECTION("Truncated") {
+        for (size_t length = 1; length < size; length++) {
+            if (LZ4::decompress(compressed.data(), length, output.data(), output.size(), &written)) {
+                REQUIRE(written <= output.size());
+            }
+        }
+    }
+    // Compressing a block that doesn't fit fails instead of overrunning
+    SECTION("Compress capacity") {
+        REQUIRE(LZ4::compress(input.data(), input.size(), compressed.data(), size - 1, table) == 0);
+    }
+}
+
+TEST_CASE("lz4 frame writer", "[lz4]") {
+    const uint8_t blockLog = 10;
+    std::vector<uint8_t> buffer(LZ4::FrameWriter::bufferSize(blockLog));
+    std::vector<uint8_t> frame;
+    LZ4::FrameWriter writer(buffer.data(), blockLog, table, collect, &frame);
+
+    std::mt19937 rng(42);
+    std::vector<uint8_t> input = text(200);
+    for (int idx = 0; idx < 3000; idx++) {
+        input.push_back((uint8_t)rng());
+    }
+    // write in uneven pieces
+    for (size_t offset = 0; offset < input.size(); offset += 333) {
+        writer.write(input.data() + offset, std::min<size_t>(333, input.size() - offset));
+    }
+    writer.finish();
+    REQUIRE(writer.consumed() == input.size());
+    REQUIRE(writer.produced() == frame.size());
+    REQUIRE(frame.size() < input.size());
+
+    // parse the frame back
+    REQUIRE(std::memcmp(frame.data(), LZ4_FRAME_MAGIC, 4) == 0);
+    REQUIRE(frame[4] == LZ4_FRAME_VERSION);
+    REQUIRE(frame[5] == blockLog);
+    std::vector<uint8_t> output;
+    bool sawRaw = false;
+    size_t pos = LZ4_FRAME_HEADER_SIZE;
+    for (;;) {
+        uint32_t stored = read32(&frame[pos]);
+        pos += 4;
+        if (stored == 0) {
+            break;
+        }
+        uint32_t size = stored & ~LZ4_FRAME_RAW_BLOCK;
+        uint32_t content = read32(&frame[pos]);
+        pos += 4;
+        REQUIRE(content <= (1u << blockLog));
+        std::vector<uint8_t> block(content);
+        if (stored & LZ4_FRAME_RAW_BLOCK) {
+            sawRaw = true;
+            REQUIRE(size == content);
+            std::memcpy(block.data(), &frame[pos], size);
+        } else {
+            size_t written;
+            REQUIRE(LZ4::decompress(&frame[pos], size, block.data(), block.size(), &written));
+            REQUIRE(written == content);
+        }
+        pos += size;
+        REQUIRE(read32(&frame[pos]) == crc32(block.data(), block.size()));
+        pos += 4;
+        output.insert(output.end(), block.begin(), block.end());
+    }
+    REQUIRE(pos == frame.size());
+    REQUIRE(sawRaw);
+    REQUIRE(output == input);
+}
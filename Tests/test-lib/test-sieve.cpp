@@ -0,0 +1,99 @@
+/**
+ * @file test-sieve.cpp
+ * @author Keeton Feavel (keeton@xyr.is)
+ * @brief Segmented sieve unit tests
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright the Xyris Contributors (c) 2026
+ *
+ */
+#include <catch2/catch.hpp>
+#include <Library/sieve.hpp>
+#include <memory>
+#include <vector>
+
+// Reference: a plain sieve over every number below the limit
+static std::vector<bool> simpleSieve(uint64_t limit)
+{
+    std::vector<bool> prime(limit, true);
+    for (uint64_t n = 0; n < limit && n < 2; n++) {
+        prime[n] = false;
+    }
+    for (uint64_t n = 2; n * n < limit; n++) {
+        if (prime[n]) {
+            for (uint64_t multiple = n * n; multiple < limit; multiple += n) {
+                prime[multiple] = false;
+            }
+        }
+    }
+    return prime;
+}
+
+static void compare(uint64_t limit, uint32_t segmentBits)
+{
+    // the base prime tables are too large for the stack
+    auto sieve = std::make_unique<Sieve::Segmented>();
+    std::vector<uint32_t> bits(segmentBits / 32);
+    std::vector<bool> reference = simpleSieve(limit);
+
+    sieve->init(limit, bits.data(), segmentBits);
+    size_t total = limit > 2 ? 1 : 0;
+    uint64_t expectedLow = 0;
+    while (sieve->next()) {
+        REQUIRE(sieve->low() == expectedLow);
+        size_t expected = 0;
+        for (uint32_t bit = 0; bit < sieve->size(); bit++) {
+            uint64_t n = sieve->low() + 2 * (uint64_t)bit + 1;
+            REQUIRE(n < limit);
+            REQUIRE(sieve->isPrime(bit) == reference[n]);
+            expected += reference[n];
+        }
+        REQUIRE(sieve->segmentCount() == expected);
+        total += expected;
+        REQUIRE(sieve->count() == total);
+        expectedLow += 2 * (uint64_t)segmentBits;
+    }
+
+    size_t primes = 0;
+    for (bool prime : reference) {
+        primes += prime;
+    }
+    REQUIRE(sieve->count() == primes);
+}
+
+TEST_CASE("segmented sieve", "[sieve]") {
+    SECTION("Tiny limits") {
+        for (uint64_t limit = 0; limit < 100; limit++) {
+            compare(limit, 32);
+        }
+    }
+
+    SECTION("Segment boundaries") {
+        // limits on, just before, and just after the end of a segment
+        for (uint64_t limit : { 2048ULL, 2047ULL, 2049ULL, 2050ULL, 4097ULL }) {
+            compare(limit, 1024);
+        }
+    }
+
+    SECTION("Segment sizes") {
+        for (uint32_t segmentBits : { 32U, 96U, 8192U, 262144U }) {
+            compare(1000003, segmentBits);
+        }
+    }
+
+    SECTION("Default benchmark") {
+        // the limit and segment size the primes application uses by default
+        auto sieve = std::make_unique<Sieve::Segmented>();
+        std::vector<uint32_t> bits(32 * 1024 * 8 / 32);
+        std::vector<bool> reference = simpleSieve(16000000);
+        size_t primes = 0;
+        for (bool prime : reference) {
+            primes += prime;
+        }
+
+        sieve->init(16000000, bits.data(), 32 * 1024 * 8);
+        while (sieve->next()) { }
+        REQUIRE(sieve->count() == primes);
+    }
+}
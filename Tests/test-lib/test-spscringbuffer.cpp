@@ -0,0 +1,68 @@
+/**
+ * @file test-spscringbuffer.cpp
+ * @author Keeton Feavel (keeton@xyr.is)
+ * @brief Single producer single consumer ring buffer unit tests
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @copyright Copyright the Xyris Contributors (c) 2026
+ *
+ */
+#include <catch2/catch.hpp>
+// Ring buffer is header-only template
+#include <Library/SPSCRingBuffer.hpp>
+#include <thread>
+
+TEST_CASE("spsc ring buffer operations", "[spscringbuffer]") {
+    SPSCRingBuffer<uint32_t, 16> ring;
+    // Ensure the constructor creates an empty buffer
+    SECTION("constructor") {
+        REQUIRE(ring.IsEmpty());
+        REQUIRE(!ring.IsFull());
+        REQUIRE(ring.Length() == 0);
+        REQUIRE(ring.Capacity() == 16);
+    }
+    // Ensure the buffer rejects values once full
+    SECTION("Fill") {
+        for (uint32_t i = 0; i < 16; i++) {
+            REQUIRE(ring.Enqueue(i));
+        }
+        REQUIRE(ring.IsFull());
+        REQUIRE(!ring.Enqueue(16));
+        REQUIRE(ring.Length() == 16);
+    }
+    // Ensure values come out in order, including across the wrap point
+    SECTION("Enqueue : Dequeue (wrap)") {
+        uint32_t val;
+        for (uint32_t i = 0; i < 100; i++) {
+            REQUIRE(ring.Enqueue(i));
+            REQUIRE(ring.Enqueue(i + 1000));
+            REQUIRE(ring.Dequeue(&val));
+            REQUIRE(val == i);
+            REQUIRE(ring.Dequeue(&val));
+            REQUIRE(val == i + 1000);
+        }
+        REQUIRE(ring.IsEmpty());
+        REQUIRE(!ring.Dequeue(&val));
+    }
+    // Ensure a concurrent producer and consumer never lose or reorder values
+    SECTION("Concurrent producer : consumer") {
+        const uint32_t count = 100000;
+        std::thread producer([&ring, count]() {
+            for (uint32_t i = 0; i < count; i++) {
+                while (!ring.Enqueue(i)) { }
+            }
+        });
+
+        uint32_t expected = 0;
+        uint32_t val;
+        while (expected < count) {
+            if (ring.Dequeue(&val)) {
+                REQUIRE(val == expected);
+                expected++;
+            }
+        }
+        producer.join();
+        REQUIRE(ring.IsEmpty());
+    }
+}